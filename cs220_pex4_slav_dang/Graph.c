@@ -27,16 +27,23 @@ Graph * graphCreate(int numberVertices, int bytesPerNode) {
     graph->numberVertices = numberVertices;
     graph->vertices = malloc(numberVertices * bytesPerNode);
     graph->edges = malloc(numberVertices * sizeof(int *));
+    graph->weights = malloc(numberVertices * sizeof(int *));
+    graph->neighbors = malloc(numberVertices * sizeof(int *));
+    graph->degree = malloc(numberVertices * sizeof(int));
 
 // Create each row of the adjacency matrix
     for (int j=0; j < numberVertices; j++) {
         graph->edges[j] = (int *) malloc( numberVertices * sizeof(int));
+        graph->weights[j] = (int *) malloc( numberVertices * sizeof(int));
+        graph->neighbors[j] = (int *) malloc( numberVertices * sizeof(int));
+        graph->degree[j] = 0;
     }
 
-    // Set every edge to FALSE
+    // Set every edge to FALSE, with a length of 1
     for (int row = 0; row < graph->numberVertices; row++) {
         for (int col = 0; col < graph->numberVertices; col++) {
             graph->edges[row][col] = 0;
+            graph->weights[row][col] = 1;
         }
     }
 
@@ -49,7 +56,15 @@ Graph * graphCreate(int numberVertices, int bytesPerNode) {
  */
 void graphDelete(Graph * graph) {
     // delete each edge and vertex and then the whole graph
+    for (int j = 0; j < graph->numberVertices; j++) {
+        free(graph->edges[j]);
+        free(graph->weights[j]);
+        free(graph->neighbors[j]);
+    }
     free(graph->edges);
+    free(graph->weights);
+    free(graph->neighbors);
+    free(graph->degree);
     free(graph->vertices);
     free(graph);
 }
@@ -62,7 +77,20 @@ void graphDelete(Graph * graph) {
  * @param state the state of the edge
  **/
 void graphSetEdge(Graph * graph, int fromVertex, int toVertex, int state) {
+    int oldState = graph->edges[fromVertex][toVertex];
     graph->edges[fromVertex][toVertex] = state;
+
+    // Keep the neighbor list in step with the adjacency matrix
+    int *neighbors = graph->neighbors[fromVertex];
+    if (oldState == 0 && state != 0) {
+        neighbors[graph->degree[fromVertex]++] = toVertex;
+    } else if (oldState != 0 && state == 0) {
+        int j = 0;
+        while (neighbors[j] != toVertex) {
+            j++;
+        }
+        neighbors[j] = neighbors[--graph->degree[fromVertex]];
+    }
 }
 
 /** -------------------------------------------------------------------
@@ -78,10 +106,100 @@ int graphGetEdge(Graph * graph, int fromVertex, int toVertex) {
 }
 
 /** -------------------------------------------------------------------
- * Creates an a path structure
- * @return path - a structure containing an array
+ * Set the length of an edge in a graph
+ * @param graph a pointer to the graph to modify
+ * @param fromVertex the beginning vertex of the edge
+ * @param toVertex the ending vertex of the edge
+ * @param weight the length of the edge
+ **/
+void graphSetWeight(Graph * graph, int fromVertex, int toVertex, int weight) {
+    graph->weights[fromVertex][toVertex] = weight;
+}
+
+/** -------------------------------------------------------------------
+ * Get the length of an edge in a graph
+ * @param graph the graph
+ * @param fromVertex the starting vertex of the edge
+ * @param toVertex the ending vertex of the edge
+ * @return the length of the edge
+ **/
+int graphGetWeight(Graph * graph, int fromVertex, int toVertex) {
+    return graph->weights[fromVertex][toVertex];
+}
+
+/** -------------------------------------------------------------------
+ * Count the edges in a graph. Each undirected edge is counted once.
+ * @param graph the graph
+ * @return the number of edges
+ */
+int graphNumberEdges(Graph *graph) {
+    int arcs = 0;
+    for (int v = 0; v < graph->numberVertices; v++) {
+        arcs += graph->degree[v];
+    }
+    return arcs / 2;
+}
+
+/** -------------------------------------------------------------------
+ * Create the memory needed to hold a compressed adjacency list.
+ * @param numberVertices the number of vertices
+ * @param numberArcs the number of directed arcs (2 per undirected edge)
+ * @return a pointer to an adjacency struct; the caller fills in
+ *         offsets[] and neighbors[]
+ */
+Adjacency * adjacencyCreate(int numberVertices, int numberArcs) {
+    Adjacency *adjacency = malloc(sizeof(Adjacency));
+    adjacency->numberVertices = numberVertices;
+    adjacency->numberArcs = numberArcs;
+    adjacency->offsets = malloc((numberVertices + 1) * sizeof(int));
+    adjacency->neighbors = malloc(numberArcs * sizeof(int));
+
+    if (adjacency->offsets == NULL || adjacency->neighbors == NULL) {
+        printf("ERROR in adjacencyCreate. Not enough memory for %d arcs.\n", numberArcs);
+        exit(1);
+    }
+    return adjacency;
+}
+
+/** -------------------------------------------------------------------
+ * Build a compressed adjacency list from a graph's adjacency matrix.
+ * @param graph the graph
+ * @param minimumState only edges whose state is >= minimumState are kept
+ * @return a pointer to an adjacency struct
+ */
+Adjacency * adjacencyFromGraph(Graph *graph, int minimumState) {
+    // First pass counts the arcs so the arrays can be sized exactly.
+    int numberArcs = 0;
+    for (int from = 0; from < graph->numberVertices; from++) {
+        for (int j = 0; j < graph->degree[from]; j++) {
+            if (graph->edges[from][graph->neighbors[from][j]] >= minimumState) {
+                numberArcs++;
+            }
+        }
+    }
+
+    Adjacency *adjacency = adjacencyCreate(graph->numberVertices, numberArcs);
+    int arc = 0;
+    for (int from = 0; from < graph->numberVertices; from++) {
+        adjacency->offsets[from] = arc;
+        for (int j = 0; j < graph->degree[from]; j++) {
+            int to = graph->neighbors[from][j];
+            if (graph->edges[from][to] >= minimumState) {
+                adjacency->neighbors[arc++] = to;
+            }
+        }
+    }
+    adjacency->offsets[graph->numberVertices] = arc;
+
+    return adjacency;
+}
+
+/** -------------------------------------------------------------------
+ * Delete a compressed adjacency list
+ * @param adjacency the adjacency list to delete
  */
-Path* createpath() {
-    Path* path = malloc(sizeof(Path));
-    return path;
+void adjacencyDelete(Adjacency *adjacency) {
+    free(adjacency->offsets);
+    free(adjacency->neighbors);
+    free(adjacency);
 }
\ No newline at end of file
@@ -18,11 +18,20 @@ typedef struct graph{
 	int    numberVertices;
 	void * vertices;  // Array of nodes
 	int ** edges;     // Adjacency matrix (2D Array)
+	int ** weights;   // The length of each edge (2D Array)
+	int ** neighbors; // neighbors[v] lists the vertices that v has an edge to
+	int *  degree;    // The number of entries in neighbors[v]
 } Graph;
 
-typedef struct path {
-	int vertices[NUM_GRAPH_NODES];	  //An array of vertex indexes
-} Path;
+// A compressed (CSR) adjacency list. The neighbors of vertex v are
+// neighbors[offsets[v]] .. neighbors[offsets[v+1]-1]. Each undirected
+// edge is stored twice, once in each direction.
+typedef struct adjacency {
+	int   numberVertices;
+	int   numberArcs;
+	int * offsets;    // numberVertices+1 entries
+	int * neighbors;  // numberArcs entries
+} Adjacency;
 
 /** -------------------------------------------------------------------
  * Create the memory needed to hold a graph data structure.
@@ -58,9 +67,67 @@ void graphSetEdge(Graph *graph, int fromVertex, int toVertex, int state);
 int graphGetEdge(Graph *graph, int fromVertex, int toVertex);
 
 /** -------------------------------------------------------------------
- * Creates an a path structure
- * @return path - a structure containing an array
+ * Set the length of an edge in a graph
+ * @param graph the graph to modify
+ * @param fromVertex the beginning vertex of the edge
+ * @param toVertex the ending vertex of the edge
+ * @param weight the length of the edge
+ */
+void graphSetWeight(Graph *graph, int fromVertex, int toVertex, int weight);
+
+/** -------------------------------------------------------------------
+ * Get the length of an edge in a graph
+ * @param graph the graph
+ * @param fromVertex the starting vertex of the edge
+ * @param toVertex the ending vertex of the edge
+ * @return the length of the edge
+ */
+int graphGetWeight(Graph *graph, int fromVertex, int toVertex);
+
+/** -------------------------------------------------------------------
+ * Count the edges in a graph. Each undirected edge is counted once.
+ * @param graph the graph
+ * @return the number of edges
+ */
+int graphNumberEdges(Graph *graph);
+
+/** -------------------------------------------------------------------
+ * Create the memory needed to hold a compressed adjacency list.
+ * @param numberVertices the number of vertices
+ * @param numberArcs the number of directed arcs (2 per undirected edge)
+ * @return a pointer to an adjacency struct; the caller fills in
+ *         offsets[] and neighbors[]
+ */
+Adjacency * adjacencyCreate(int numberVertices, int numberArcs);
+
+/** -------------------------------------------------------------------
+ * Build a compressed adjacency list from a graph's adjacency matrix.
+ * @param graph the graph
+ * @param minimumState only edges whose state is >= minimumState are kept
+ * @return a pointer to an adjacency struct
+ */
+Adjacency * adjacencyFromGraph(Graph *graph, int minimumState);
+
+/** -------------------------------------------------------------------
+ * Delete a compressed adjacency list
+ * @param adjacency the adjacency list to delete
+ */
+void adjacencyDelete(Adjacency *adjacency);
+
+/** -------------------------------------------------------------------
+ * Find the root of a vertex's group in a union-find, halving the path
+ * on the way. It is defined here so that the solvers' inner loops can
+ * inline it.
+ * @param group group[v] is the vertex above v; a root is its own
+ * @param v the vertex
+ * @return the root of v's group
  */
-Path* createpath();
+static inline int findGroup(int *group, int v) {
+    while (group[v] != v) {
+        group[v] = group[group[v]];
+        v = group[v];
+    }
+    return v;
+}
 
 #endif // GRAPH_H
\ No newline at end of file
@@ -0,0 +1,1722 @@
+/** PEX4_benchmark.c
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: Performance measurements of the game engine on
+ *          generated boards. Run it from a console; the results
+ *          are printed to standard output.
+ * ===========================================================
+ */
+
+#include <windows.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include "Graph.h"
+#include "gameLogic.h"
+#include "search.h"
+#include "threadPool.h"
+#include "treePacking.h"
+#include "treePair.h"
+#include "minCut.h"
+#include "alphaBeta.h"
+#include "monteCarlo.h"
+#include "resistance.h"
+#include "treeSampler.h"
+#include "contraction.h"
+#include "proofNumber.h"
+#include "tablebase.h"
+#include "canonical.h"
+#include "lookahead.h"
+#include "playout.h"
+
+// The stress board used for the breadth-first search: a grid with a
+// random diagonal in about half of the cells (about 1 million vertices).
+#define BFS_BOARD_WIDTH   1024
+#define BFS_BOARD_HEIGHT  1024
+#define BFS_REPETITIONS      5
+
+// The start-to-end path query is checked against the serial search on
+// a board just big enough to use the parallel one, while a game is
+// played out on it with random moves
+#define PATH_BOARD_VERTICES  PARALLEL_BFS_MIN_VERTICES
+#define PATH_MOVES           200
+
+// The boards used for the game solvers are made by createVertices()
+// and createEdges() in a window big enough for many vertices.
+#define LARGE_BOARD_SIZE   4000
+#define LARGE_BOARD_MARGIN   30
+#define LARGE_BOARD_SPACING  25
+#define LARGE_BOARD_EDGES  0.06
+#define SOLVER_BOARD_VERTICES 1500
+#define SOLVER_MOVES           200
+
+// The perfect Cut AI is checked against the alpha-beta search on this
+// many games on the boards searched to the end, of up to this many
+// edges, with random moves for Short
+#define PERFECT_CUT_GAMES      300
+#define PERFECT_CUT_MAX_EDGES   20
+#define PERFECT_CUT_TABLE_BITS  16
+
+// The boards searched to the end are made the same way in a small
+// window, and remade until they have the number of edges wanted.
+#define SEARCH_BOARD_SIZE     600
+#define SEARCH_BOARD_EDGES   0.15
+#define SEARCH_MIN_EDGES       10
+#define SEARCH_MAX_EDGES       40
+#define SEARCH_EDGES_STEP       5
+
+// The larger boards are searched one move deeper at a time for a set
+// time instead
+#define DEEPEN_MIN_EDGES       40
+#define DEEPEN_MAX_EDGES       60
+#define DEEPEN_TIME           500
+
+// The distances are found this many times on the boards searched to
+// the end up to this many edges, with the rows of bits and without
+#define BITBOARD_CALLS     200000
+#define BITBOARD_MAX_EDGES     30
+
+// The proof-number search gets the same boards and bigger ones, for at
+// most this long each, until the first board it cannot prove in time;
+// the largest board it proves is proved again in a table this small
+#define PROOF_MAX_EDGES        70
+#define PROOF_TIME          20000
+#define PROOF_SMALL_TABLE       1
+
+// The tablebase is checked on this many games, played with random
+// moves on the boards searched to the end until they are small enough
+#define TABLEBASE_GAMES       200
+
+// The canonical keys are compared with the Zobrist hashes on this many
+// games of random moves, probing a table with every line this many
+// moves deep from every position, as a search would. The table has
+// 2^CANONICAL_SET_BITS slots.
+#define CANONICAL_GAMES        10
+#define CANONICAL_DEPTH         3
+#define CANONICAL_MIN_EDGES    20
+#define CANONICAL_MAX_EDGES_BENCHMARK  40
+#define CANONICAL_SET_BITS     21
+
+// What probing the tables with the corpus found.
+typedef struct corpusCounts {
+    long long probes;
+    long long hashHits;        // Found by Zobrist hash
+    long long keyHits;         // Found by canonical key
+    int disagreements;         // Keys that changed when the nodes were shuffled
+    double keyTime;            // Seconds spent making canonical keys
+} CorpusCounts;
+
+// The resistor network is solved on a smaller stress board, with a
+// part of its edges locked.
+#define CIRCUIT_BOARD_WIDTH    100
+#define CIRCUIT_BOARD_HEIGHT   100
+#define CIRCUIT_LOCKED_PERCENT  10
+#define CIRCUIT_REPETITIONS     20
+
+// The spanning tree sampler runs on the same board, with this many
+// trees at first, then four times as many each time up to the most
+#define SAMPLER_BENCHMARK_TREES    16
+#define SAMPLER_BENCHMARK_MOST   1024
+
+// The time the Monte Carlo search gets for each number of threads
+#define MONTE_CARLO_BENCHMARK_TIME  2000
+
+// The random playouts are timed on the contracted boards of the boards
+// searched to the end, this many of them one at a time and the same
+// number in batches, and the Monte Carlo search gets each board for
+// this long
+#define PLAYOUT_BENCHMARK_GAMES  262144
+#define PLAYOUT_BENCHMARK_TIME      500
+
+// The lookahead tries every edge on a shortest path of the large board
+// this many times for each player and number of threads
+#define LOOKAHEAD_REPETITIONS   5
+
+// The scheduler runs this many tasks, task i doing i+1 times this many
+// steps of work, and a tree of forked tasks this deep where every task
+// forks one to three more and the leaves do SCHEDULER_LEAF_WORK steps
+#define SCHEDULER_TASKS      2048
+#define SCHEDULER_WORK         20
+#define SCHEDULER_DEPTH        14
+#define SCHEDULER_LEAF_WORK  4000
+
+// A task of the tree, and the answer of the tasks forked from it.
+typedef struct forkNode {
+    ThreadPool * pool;
+    int depth;
+    unsigned int seed;
+    unsigned long long sum;
+} ForkNode;
+
+// The uneven loop, cut into one even block per worker or not.
+typedef struct unevenLoop {
+    int numberBlocks;          // 0 when each task is one index
+    unsigned long long * sums;
+} UnevenLoop;
+
+// Local functions
+static double seconds();
+static Adjacency * createStressBoard(int width, int height);
+static void benchmarkParallelBfs();
+static void benchmarkPathQuery();
+static Graph * createLargeBoard(int numberVertices);
+static void benchmarkLehmanSolver();
+static void benchmarkTreePair();
+static void benchmarkMinCut();
+static Graph * createSearchBoard(int numberEdges);
+static void benchmarkPerfectCut();
+static int solvedWinner(Graph *graph, int playerToMove, TranspositionTable *table);
+static void benchmarkAlphaBeta();
+static void benchmarkDeepening();
+static void benchmarkBitboard();
+static void benchmarkProofNumber();
+static void benchmarkTablebase();
+static void benchmarkCanonical();
+static void probeTree(Position *position, int depth, unsigned long long *hashes,
+                      unsigned long long *keys, CorpusCounts *counts);
+static int seenBefore(unsigned long long *set, unsigned long long key);
+static void benchmarkMonteCarlo();
+static void benchmarkPlayouts();
+static int scalarPlayout(CanonicalGraph *graph, int playerToMove, unsigned long long *random);
+static void benchmarkLookahead();
+static void benchmarkScheduler();
+static void unevenTask(void *context, int taskIndex, int workerIndex);
+static void forkTask(void *context, int taskIndex, int workerIndex);
+static unsigned long long work(unsigned long long seed, int steps);
+static Adjacency * lockSomeEdges(Adjacency *board, int percent);
+static void benchmarkResistance();
+static void benchmarkWarmStart();
+static void benchmarkTreeSampler();
+static void benchmarkContraction();
+static int reachesEnd(Graph *graph, int minimumState, int *queue, char *seen);
+static void randomCut(Graph *graph, int *from, int *to);
+
+/** -------------------------------------------------------------------
+ * main function; runs every benchmark.
+ * @return error code; 0 means no errors.
+ */
+int main() {
+    srand(220);
+    benchmarkParallelBfs();
+    benchmarkPathQuery();
+    benchmarkLehmanSolver();
+    benchmarkTreePair();
+    benchmarkMinCut();
+    benchmarkPerfectCut();
+    benchmarkAlphaBeta();
+    benchmarkDeepening();
+    benchmarkBitboard();
+    benchmarkProofNumber();
+    benchmarkTablebase();
+    benchmarkCanonical();
+    benchmarkMonteCarlo();
+    benchmarkPlayouts();
+    benchmarkLookahead();
+    benchmarkScheduler();
+    benchmarkResistance();
+    benchmarkWarmStart();
+    benchmarkTreeSampler();
+    benchmarkContraction();
+    return 0;
+}
+
+/** -------------------------------------------------------------------
+ * Get the time from a monotonic clock.
+ * @return the number of seconds since some fixed point in the past
+ */
+double seconds() {
+    LARGE_INTEGER counter;
+    LARGE_INTEGER frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (double) counter.QuadPart / (double) frequency.QuadPart;
+}
+
+/** -------------------------------------------------------------------
+ * Create a large board without an adjacency matrix. The vertices form
+ * a width x height grid. Every vertex is connected to its right and
+ * lower neighbors, and about half of the cells get a diagonal, so the
+ * degrees are 3-4 like the boards created by createEdges().
+ * @param width the number of vertices in a row
+ * @param height the number of rows
+ * @return a compressed adjacency list of the board
+ */
+Adjacency * createStressBoard(int width, int height) {
+    int n = width * height;
+    char *diagonal = malloc((size_t) n);
+    int *degree = calloc((size_t) n, sizeof(int));
+
+    for (int row = 0; row < height; row++) {
+        for (int col = 0; col < width; col++) {
+            int v = row * width + col;
+            diagonal[v] = (char) (row+1 < height && col+1 < width && rand() % 2 == 0);
+            if (col+1 < width)  { degree[v]++; degree[v+1]++; }
+            if (row+1 < height) { degree[v]++; degree[v+width]++; }
+            if (diagonal[v])    { degree[v]++; degree[v+width+1]++; }
+        }
+    }
+
+    int numberArcs = 0;
+    for (int v = 0; v < n; v++) {
+        numberArcs += degree[v];
+    }
+
+    Adjacency *adjacency = adjacencyCreate(n, numberArcs);
+    adjacency->offsets[0] = 0;
+    for (int v = 0; v < n; v++) {
+        adjacency->offsets[v+1] = adjacency->offsets[v] + degree[v];
+        degree[v] = adjacency->offsets[v]; // Re-used as the next free slot
+    }
+
+    for (int v = 0; v < n; v++) {
+        int right = v + 1;
+        int below = v + width;
+        if ((v % width) + 1 < width) {
+            adjacency->neighbors[degree[v]++] = right;
+            adjacency->neighbors[degree[right]++] = v;
+        }
+        if (below < n) {
+            adjacency->neighbors[degree[v]++] = below;
+            adjacency->neighbors[degree[below]++] = v;
+        }
+        if (diagonal[v]) {
+            adjacency->neighbors[degree[v]++] = below + 1;
+            adjacency->neighbors[degree[below+1]++] = v;
+        }
+    }
+
+    free(diagonal);
+    free(degree);
+    return adjacency;
+}
+
+/** -------------------------------------------------------------------
+ * Measure the traversed edges per second (TEPS) of the parallel
+ * breadth-first search from the starting corner of a stress board,
+ * and its speedup from 1 up to all of the processors.
+ */
+void benchmarkParallelBfs() {
+    Adjacency *board = createStressBoard(BFS_BOARD_WIDTH, BFS_BOARD_HEIGHT);
+    int *parent = malloc(board->numberVertices * sizeof(int));
+    SearchWorkspace *workspace = workspaceCreate(board->numberVertices);
+
+    printf("Parallel BFS: %d vertices, %d edges\n",
+           board->numberVertices, board->numberArcs / 2);
+    printf("%8s %12s %12s %10s %10s\n", "threads", "time (ms)", "MTEPS", "speedup", "bottom-up");
+
+    int maximumThreads = numberProcessors();
+    double serialTime = 0.0;
+    long long traversedEdges = 0;
+    for (int threads = 1; threads <= maximumThreads; threads *= 2) {
+        ThreadPool *pool = threadPoolCreate(threads);
+        BfsStatistics stats;
+        double best = 1.0e30;
+
+        for (int j = 0; j < BFS_REPETITIONS; j++) {
+            double start = seconds();
+            parallelBfs(board, 0, parent, pool, workspace, &stats);
+            double elapsed = seconds() - start;
+            if (elapsed < best) {
+                best = elapsed;
+            }
+        }
+
+        if (threads == 1) {
+            // The edges inside the component that was searched
+            long long arcs = 0;
+            for (int v = 0; v < board->numberVertices; v++) {
+                if (parent[v] != -1) {
+                    arcs += board->offsets[v+1] - board->offsets[v];
+                }
+            }
+            traversedEdges = arcs / 2;
+            serialTime = best;
+        }
+
+        printf("%8d %12.2f %12.1f %10.2f %6d/%-3d\n", threads, best * 1000.0,
+               traversedEdges / best / 1.0e6, serialTime / best,
+               stats.bottomUpSteps, stats.levels);
+        threadPoolDelete(pool);
+
+        // Always finish with a run that uses every processor
+        if (threads < maximumThreads && threads * 2 > maximumThreads) {
+            threads = maximumThreads / 2;
+        }
+    }
+
+    free(parent);
+    workspaceDelete(workspace);
+    adjacencyDelete(board);
+}
+
+/** -------------------------------------------------------------------
+ * Measure how long bfsShortestPath() takes per turn while a game is
+ * played out on a large board with random moves, and check each path
+ * it finds: it must run from the ending vertex to the starting vertex
+ * along edges of the board, and be as short as the serial search says.
+ */
+void benchmarkPathQuery() {
+    Graph *graph = createLargeBoard(PATH_BOARD_VERTICES);
+    SearchWorkspace *workspace = workspaceCreate(graph->numberVertices);
+    int *path = malloc(graph->numberVertices * sizeof(int));
+    int end = graph->numberVertices - 1;
+    printf("\nPath query: %d vertices, %d edges\n",
+           graph->numberVertices, graphNumberEdges(graph));
+
+    double parallelTime = 0.0;
+    double serialTime = 0.0;
+    int queries = 0;
+    int wrong = 0;
+    int player = CUT_PLAYER;
+    for (int move = 0; move < PATH_MOVES; move++) {
+        double start = seconds();
+        int length = bfsShortestPath(graph, workspace, path);
+        parallelTime += seconds() - start;
+
+        int valid = (length == 0) || (path[0] == end && path[length-1] == 0);
+        for (int i = 0; valid && i + 1 < length; i++) {
+            valid = graphGetEdge(graph, path[i], path[i+1]) != NO_EDGE;
+        }
+
+        start = seconds();
+        int found = edgeBetweenness(graph, workspace, 0, end);
+        serialTime += seconds() - start;
+        if (!valid || (found == 0) != (length == 0) ||
+            (length > 0 && workspace->dist[end] != length - 1)) {
+            wrong++;
+        }
+        queries++;
+        if (length == 0) {
+            break; // Cut has won
+        }
+
+        // Play a random normal edge
+        int from, to;
+        randomCut(graph, &from, &to);
+        int state = (player == SHORT_PLAYER) ? LOCKED_EDGE : NO_EDGE;
+        graphSetEdge(graph, from, to, state);
+        graphSetEdge(graph, to, from, state);
+        workspaceObserve(workspace, graph, from, to, state);
+        player = 1 - player;
+    }
+    printf("  %d queries, %d wrong: parallel %.2f ms, serial %.2f ms per query\n", queries, wrong,
+           parallelTime / queries * 1000.0, serialTime / queries * 1000.0);
+
+    free(path);
+    workspaceDelete(workspace);
+    graphDelete(graph);
+}
+
+/** -------------------------------------------------------------------
+ * Create a game board with many vertices, the same way main() does.
+ * @param numberVertices the number of vertices
+ * @return the board
+ */
+Graph * createLargeBoard(int numberVertices) {
+    Graph *graph = graphCreate(numberVertices, sizeof(Vertex));
+    createVertices(graph, LARGE_BOARD_SIZE, LARGE_BOARD_SIZE, LARGE_BOARD_MARGIN,
+                   LARGE_BOARD_SPACING, FALSE);
+    createEdges(graph, 3, 4, LARGE_BOARD_SIZE, LARGE_BOARD_SIZE, LARGE_BOARD_EDGES);
+    return graph;
+}
+
+/** -------------------------------------------------------------------
+ * Measure how long the Lehman solver takes per turn while a game is
+ * played out on a large board with random moves.
+ */
+void benchmarkLehmanSolver() {
+    Graph *graph = createLargeBoard(SOLVER_BOARD_VERTICES);
+    printf("\nLehman solver: %d vertices, %d edges\n",
+           graph->numberVertices, graphNumberEdges(graph));
+
+    double total = 0.0;
+    double worst = 0.0;
+    int solves = 0;
+    int player = CUT_PLAYER;
+    for (int move = 0; move < SOLVER_MOVES; move++) {
+        double start = seconds();
+        TreePacking *packing = lehmanSolve(graph, player);
+        double elapsed = seconds() - start;
+        total += elapsed;
+        solves++;
+        if (elapsed > worst) {
+            worst = elapsed;
+        }
+        if (move % 50 == 0) {
+            printf("  move %3d: %s to move, %s wins (trees of %d edges) in %.2f ms\n", move,
+                   player == CUT_PLAYER ? "Cut" : "Short",
+                   packing->winner == SHORT_WINS ? "Short" : "Cut",
+                   packing->numberTreeEdges, elapsed * 1000.0);
+        }
+        treePackingDelete(packing);
+
+        // Play a random normal edge
+        int from, to;
+        randomCut(graph, &from, &to);
+        int state = (player == SHORT_PLAYER) ? LOCKED_EDGE : NO_EDGE;
+        graphSetEdge(graph, from, to, state);
+        graphSetEdge(graph, to, from, state);
+        player = 1 - player;
+    }
+    printf("  average %.2f ms, worst %.2f ms per solve\n",
+           total / solves * 1000.0, worst * 1000.0);
+    graphDelete(graph);
+}
+
+/** -------------------------------------------------------------------
+ * Measure how long the perfect Short AI takes to reply while a random
+ * Cut plays against it on a large board. Only the first reply builds
+ * the trees; every later one repairs them.
+ */
+void benchmarkTreePair() {
+    Graph *graph = createLargeBoard(SOLVER_BOARD_VERTICES);
+    TreePair *pair = treePairCreate(graph->numberVertices);
+    printf("\nShort's tree pair: %d vertices, %d edges\n",
+           graph->numberVertices, graphNumberEdges(graph));
+
+    double first = 0.0;
+    double total = 0.0;
+    double worst = 0.0;
+    int replies = 0;
+    for (int move = 0; move < SOLVER_MOVES; move++) {
+        // Cut moves first
+        int from, to;
+        randomCut(graph, &from, &to);
+        graphSetEdge(graph, from, to, NO_EDGE);
+        graphSetEdge(graph, to, from, NO_EDGE);
+        treePairObserve(pair, graph, from, to, NO_EDGE);
+
+        Edge edge;
+        double start = seconds();
+        int found = treePairReply(pair, graph, &edge);
+        double elapsed = seconds() - start;
+        if (!found) {
+            break; // Cut won, or Short has connected the terminals
+        }
+        graphSetEdge(graph, edge.fromVertex, edge.toVertex, LOCKED_EDGE);
+        graphSetEdge(graph, edge.toVertex, edge.fromVertex, LOCKED_EDGE);
+        treePairObserve(pair, graph, edge.fromVertex, edge.toVertex, LOCKED_EDGE);
+
+        if (move == 0) {
+            first = elapsed;
+        } else {
+            total += elapsed;
+            replies++;
+            if (elapsed > worst) {
+                worst = elapsed;
+            }
+        }
+    }
+    printf("  first reply (builds the trees) %.2f ms\n", first * 1000.0);
+    if (replies > 0) {
+        printf("  %d repairs: average %.2f us, worst %.2f us, %d rebuilds in all\n",
+               replies, total / replies * 1.0e6, worst * 1.0e6, pair->rebuilds);
+    }
+    treePairDelete(pair);
+    graphDelete(graph);
+}
+
+/** -------------------------------------------------------------------
+ * Measure how long the perfect Cut AI takes per move while a random
+ * Short plays against it on a large board. Only the first move finds
+ * the maximum flow from nothing; every later one repairs it.
+ */
+void benchmarkMinCut() {
+    Graph *graph = createLargeBoard(SOLVER_BOARD_VERTICES);
+    MinCut *cut = minCutCreate(graph->numberVertices);
+    printf("\nCut's minimum cut: %d vertices, %d edges\n",
+           graph->numberVertices, graphNumberEdges(graph));
+
+    double first = 0.0;
+    double total = 0.0;
+    double worst = 0.0;
+    int moves = 0;
+    for (int move = 0; move < SOLVER_MOVES; move++) {
+        Edge edge;
+        double start = seconds();
+        int found = minCutMove(cut, graph, &edge);
+        double elapsed = seconds() - start;
+        if (!found) {
+            break; // The game is over
+        }
+        if (move == 0) {
+            first = elapsed;
+            printf("  maximum flow %d at the start\n", cut->flowValue);
+        } else {
+            total += elapsed;
+            moves++;
+            if (elapsed > worst) {
+                worst = elapsed;
+            }
+        }
+        graphSetEdge(graph, edge.fromVertex, edge.toVertex, NO_EDGE);
+        graphSetEdge(graph, edge.toVertex, edge.fromVertex, NO_EDGE);
+        minCutObserve(cut, graph, edge.fromVertex, edge.toVertex, NO_EDGE);
+
+        // Short locks a random edge
+        int from, to;
+        randomCut(graph, &from, &to);
+        graphSetEdge(graph, from, to, LOCKED_EDGE);
+        graphSetEdge(graph, to, from, LOCKED_EDGE);
+        minCutObserve(cut, graph, from, to, LOCKED_EDGE);
+    }
+    printf("  first move (finds the flow) %.2f ms\n", first * 1000.0);
+    if (moves > 0) {
+        printf("  %d more moves: average %.2f us, worst %.2f us, %d full solves in all\n",
+               moves, total / moves * 1.0e6, worst * 1.0e6, cut->fullSolves);
+    }
+    minCutDelete(cut);
+    graphDelete(graph);
+}
+
+/** -------------------------------------------------------------------
+ * Create a small game board with an exact number of edges. Boards are
+ * made with about 5 vertices for every 8 edges until one has the
+ * number of edges wanted.
+ * @param numberEdges the number of edges
+ * @return the board
+ */
+Graph * createSearchBoard(int numberEdges) {
+    for (int tries = 0; ; tries++) {
+        int numberVertices = numberEdges * 5 / 8 + tries % 3 - 1;
+        Graph *graph = graphCreate(numberVertices, sizeof(Vertex));
+        createVertices(graph, SEARCH_BOARD_SIZE, SEARCH_BOARD_SIZE, LARGE_BOARD_MARGIN,
+                       LARGE_BOARD_MARGIN, FALSE);
+        createEdges(graph, 2, 3, SEARCH_BOARD_SIZE, SEARCH_BOARD_SIZE, SEARCH_BOARD_EDGES);
+        if (graphNumberEdges(graph) == numberEdges) {
+            return graph;
+        }
+        graphDelete(graph);
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Check the perfect Cut AI against the alpha-beta search on games on
+ * small boards. Whenever Cut is to move, it must find a move exactly
+ * when the search says Cut wins, and the search must say Cut still
+ * wins after the move. Short plays random moves.
+ */
+void benchmarkPerfectCut() {
+    TranspositionTable *table = tableCreate(PERFECT_CUT_TABLE_BITS);
+    printf("\nPerfect Cut: %d games on boards of %d to %d edges, checked by alpha-beta\n",
+           PERFECT_CUT_GAMES, SEARCH_MIN_EDGES, PERFECT_CUT_MAX_EDGES);
+
+    int positions = 0;
+    int won = 0;
+    int wrong = 0;
+    double total = 0.0;
+    for (int game = 0; game < PERFECT_CUT_GAMES; game++) {
+        Graph *graph = createSearchBoard(SEARCH_MIN_EDGES +
+                                         game % (PERFECT_CUT_MAX_EDGES - SEARCH_MIN_EDGES + 1));
+        MinCut *cut = minCutCreate(graph->numberVertices);
+        Contraction *contraction = contractionCreate(graph->numberVertices);
+        int player = game % 2;
+        while (contractionWinner(contraction, graph) == GAME_UNDERWAY) {
+            int from, to;
+            if (player == CUT_PLAYER) {
+                Edge edge;
+                int winner = solvedWinner(graph, CUT_PLAYER, table);
+                double start = seconds();
+                int found = minCutWinningMove(cut, contraction, graph, &edge);
+                total += seconds() - start;
+                positions++;
+                won += (winner == CUT_WINS);
+                if (found != (winner == CUT_WINS)) {
+                    wrong++;
+                }
+                if (found) {
+                    from = edge.fromVertex;
+                    to = edge.toVertex;
+                    graphSetEdge(graph, from, to, NO_EDGE);
+                    graphSetEdge(graph, to, from, NO_EDGE);
+                    if (solvedWinner(graph, SHORT_PLAYER, table) != CUT_WINS) {
+                        wrong++;
+                    }
+                    graphSetEdge(graph, from, to, NORMAL_EDGE);
+                    graphSetEdge(graph, to, from, NORMAL_EDGE);
+                } else {
+                    randomCut(graph, &from, &to);
+                }
+            } else {
+                randomCut(graph, &from, &to);
+            }
+            int state = (player == SHORT_PLAYER) ? LOCKED_EDGE : NO_EDGE;
+            graphSetEdge(graph, from, to, state);
+            graphSetEdge(graph, to, from, state);
+            minCutObserve(cut, graph, from, to, state);
+            contractionObserve(contraction, graph, from, to, state);
+            player = 1 - player;
+        }
+        contractionDelete(contraction);
+        minCutDelete(cut);
+        graphDelete(graph);
+    }
+    printf("  %d positions with Cut to move, %d won by Cut, %d wrong, %.2f ms per move\n",
+           positions, won, wrong, positions > 0 ? total / positions * 1000.0 : 0.0);
+    tableDelete(table);
+}
+
+/** -------------------------------------------------------------------
+ * Find who wins a small board with the alpha-beta search.
+ * @param graph the board
+ * @param playerToMove CUT_PLAYER or SHORT_PLAYER
+ * @param table the transposition table; it is cleared first
+ * @return SHORT_WINS or CUT_WINS
+ */
+int solvedWinner(Graph *graph, int playerToMove, TranspositionTable *table) {
+    Position *position = positionCreate(graph, playerToMove);
+    tableClear(table);
+    int move;
+    AlphaBetaStatistics statistics;
+    int winner = alphaBetaSolve(position, table, &move, &statistics);
+    positionDelete(position);
+    return winner;
+}
+
+/** -------------------------------------------------------------------
+ * Measure how fast the alpha-beta search solves boards of a growing
+ * number of edges from the first move. The search time grows
+ * exponentially with the number of live edges, so the largest boards
+ * can take minutes.
+ */
+void benchmarkAlphaBeta() {
+    TranspositionTable *table = tableCreate(TRANSPOSITION_TABLE_BITS);
+    printf("\nAlpha-beta search: Cut to move on a new board\n");
+
+    for (int edges = SEARCH_MIN_EDGES; edges <= SEARCH_MAX_EDGES; edges += SEARCH_EDGES_STEP) {
+        Graph *graph = createSearchBoard(edges);
+        Position *position = positionCreate(graph, CUT_PLAYER);
+        tableClear(table);
+
+        int move;
+        AlphaBetaStatistics statistics;
+        double start = seconds();
+        int winner = alphaBetaSolve(position, table, &move, &statistics);
+        double elapsed = seconds() - start;
+        printf("  %2d vertices, %2d edges: %s wins, %lld nodes (%lld from the table) in %.2f ms,"
+               " %.0f nodes/s\n", graph->numberVertices, edges,
+               winner == SHORT_WINS ? "Short" : "Cut", statistics.nodes, statistics.tableHits,
+               elapsed * 1000.0, elapsed > 0.0 ? statistics.nodes / elapsed : 0.0);
+
+        positionDelete(position);
+        graphDelete(graph);
+    }
+    tableDelete(table);
+}
+
+/** -------------------------------------------------------------------
+ * Measure how deep the iterative deepening search gets in a set time on
+ * boards too big to solve at once, and how close to the time it stops.
+ */
+void benchmarkDeepening() {
+    TranspositionTable *table = tableCreate(TRANSPOSITION_TABLE_BITS);
+    printf("\nIterative deepening: Cut to move on a new board, %d ms per move\n", DEEPEN_TIME);
+
+    for (int edges = DEEPEN_MIN_EDGES; edges <= DEEPEN_MAX_EDGES; edges += SEARCH_EDGES_STEP) {
+        Graph *graph = createSearchBoard(edges);
+        Position *position = positionCreate(graph, CUT_PLAYER);
+        tableClear(table);
+
+        int move;
+        AlphaBetaStatistics statistics;
+        double start = seconds();
+        int winner = alphaBetaDeepen(position, table, DEEPEN_TIME, NULL, &move, &statistics);
+        double elapsed = seconds() - start;
+        printf("  %2d vertices, %2d edges: depth %2d, %s, %lld nodes in %.1f ms\n",
+               graph->numberVertices, edges, statistics.depth,
+               winner == SHORT_WINS ? "Short wins" : winner == CUT_WINS ? "Cut wins" : "not solved",
+               statistics.nodes, elapsed * 1000.0);
+
+        positionDelete(position);
+        graphDelete(graph);
+    }
+    tableDelete(table);
+}
+
+/** -------------------------------------------------------------------
+ * Measure how much faster the distances and the alpha-beta search are
+ * on the rows of bits of a small board than on its lists of edges, and
+ * check that both find the same distances, winner and nodes.
+ */
+void benchmarkBitboard() {
+    TranspositionTable *table = tableCreate(TRANSPOSITION_TABLE_BITS);
+    printf("\nBitboards: Cut to move on a new board, distances found %d times\n", BITBOARD_CALLS);
+    printf(" vertices  edges  distances (ns): lists  bits  speedup   solve (ms): lists   bits  speedup  same\n");
+
+    for (int edges = SEARCH_MIN_EDGES; edges <= BITBOARD_MAX_EDGES; edges += SEARCH_EDGES_STEP) {
+        Graph *graph = createSearchBoard(edges);
+        Position *lists = positionCreate(graph, CUT_PLAYER);
+        Position *bits = positionCreate(graph, CUT_PLAYER);
+        lists->bitboard = FALSE;
+
+        double time[2];
+        int same = TRUE;
+        for (int k = 0; k < 2; k++) {
+            Position *position = (k == 0) ? lists : bits;
+            double start = seconds();
+            for (int i = 0; i < BITBOARD_CALLS; i++) {
+                positionDistances(position);
+            }
+            time[k] = seconds() - start;
+        }
+        for (int v = 0; v < graph->numberVertices; v++) {
+            same = same && lists->distStart[v] == bits->distStart[v] &&
+                   lists->distEnd[v] == bits->distEnd[v];
+        }
+
+        double solve[2];
+        int winner[2];
+        long long nodes[2];
+        for (int k = 0; k < 2; k++) {
+            int move;
+            AlphaBetaStatistics statistics;
+            tableClear(table);
+            double start = seconds();
+            winner[k] = alphaBetaSolve(k == 0 ? lists : bits, table, &move, &statistics);
+            solve[k] = seconds() - start;
+            nodes[k] = statistics.nodes;
+        }
+        same = same && winner[0] == winner[1] && nodes[0] == nodes[1];
+
+        printf("%9d %6d %21.0f %5.0f %8.2f %18.2f %6.2f %8.2f  %s\n", graph->numberVertices, edges,
+               time[0] / BITBOARD_CALLS * 1.0e9, time[1] / BITBOARD_CALLS * 1.0e9, time[0] / time[1],
+               solve[0] * 1000.0, solve[1] * 1000.0, solve[0] / solve[1], same ? "yes" : "NO");
+        positionDelete(lists);
+        positionDelete(bits);
+        graphDelete(graph);
+    }
+    tableDelete(table);
+}
+
+/** -------------------------------------------------------------------
+ * Measure how fast the proof-number search proves who wins boards of a
+ * growing number of edges from the first move, and check the winner
+ * against the tree packing solver. The largest board proved is proved
+ * again in a small table, to show what the replacement costs.
+ */
+void benchmarkProofNumber() {
+    ProofTable *table = proofTableCreate(PROOF_TABLE_MEGABYTES);
+    ProofTable *smallTable = proofTableCreate(PROOF_SMALL_TABLE);
+    Graph *largest = NULL;
+    printf("\nProof-number search: Cut to move on a new board, %d MB table, at most %d ms\n",
+           PROOF_TABLE_MEGABYTES, PROOF_TIME);
+
+    for (int edges = SEARCH_MIN_EDGES; edges <= PROOF_MAX_EDGES; edges += SEARCH_EDGES_STEP) {
+        Graph *graph = createSearchBoard(edges);
+        Position *position = positionCreate(graph, CUT_PLAYER);
+        proofTableClear(table);
+
+        int move;
+        ProofStatistics statistics;
+        int winner = proofSolve(position, table, PROOF_TIME, &move, &statistics);
+        TreePacking *packing = lehmanSolve(graph, CUT_PLAYER);
+        printf("  %2d vertices, %2d edges: %s, proof tree of %lld nodes, %lld nodes searched"
+               " in %.1f ms, %.0f nodes/s, %d entries used\n", graph->numberVertices, edges,
+               winner == SHORT_WINS ? "Short wins" : winner == CUT_WINS ? "Cut wins" : "not solved",
+               statistics.proofSize, statistics.nodes, statistics.milliseconds,
+               statistics.milliseconds > 0.0 ? statistics.nodes * 1000.0 / statistics.milliseconds
+                                             : 0.0, statistics.used);
+        if (winner != GAME_UNDERWAY && winner != packing->winner) {
+            printf("ERROR in benchmarkProofNumber. The tree packing solver says %s wins.\n",
+                   packing->winner == SHORT_WINS ? "Short" : "Cut");
+        }
+        treePackingDelete(packing);
+        positionDelete(position);
+
+        if (winner == GAME_UNDERWAY) {
+            graphDelete(graph);
+            break;
+        }
+        if (largest != NULL) {
+            graphDelete(largest);
+        }
+        largest = graph;
+    }
+
+    if (largest != NULL) {
+        Position *position = positionCreate(largest, CUT_PLAYER);
+        int move;
+        ProofStatistics statistics;
+        int winner = proofSolve(position, smallTable, PROOF_TIME, &move, &statistics);
+        printf("  %d edges in a %.1f MB table: %s, %lld nodes in %.1f ms,"
+               " %lld positions pushed out\n", position->numberEdges,
+               statistics.bytes / 1048576.0,
+               winner == SHORT_WINS ? "Short wins" : winner == CUT_WINS ? "Cut wins" : "not solved",
+               statistics.nodes, statistics.milliseconds, statistics.replaced);
+        positionDelete(position);
+        graphDelete(largest);
+    }
+    proofTableDelete(smallTable);
+    proofTableDelete(table);
+}
+
+/** -------------------------------------------------------------------
+ * Measure how long the tablebase takes to build, open and probe, and
+ * check the winners it holds against the tree packing solver on games
+ * played with random moves until they have few live edges left.
+ */
+void benchmarkTablebase() {
+    TablebaseStatistics build;
+    printf("\nTablebase: every position with up to %d live edges\n", TABLEBASE_MAX_EDGES);
+    if (!tablebaseBuild(TABLEBASE_FILE, TABLEBASE_MAX_EDGES, searchThreadPool(), &build)) {
+        printf("ERROR in benchmarkTablebase. Could not write %s.\n", TABLEBASE_FILE);
+        return;
+    }
+    for (int edges = 1; edges <= TABLEBASE_MAX_EDGES; edges++) {
+        printf("  %d live edges: %d positions\n", edges, build.positions[edges]);
+    }
+    printf("  built in %.1f ms, %lld moves taken back, %.0f KB\n",
+           build.milliseconds, build.moves, build.bytes / 1024.0);
+
+    double start = seconds();
+    Tablebase *tablebase = tablebaseOpen(TABLEBASE_FILE);
+    double openTime = seconds() - start;
+    if (tablebase == NULL) {
+        printf("ERROR in benchmarkTablebase. Could not open %s.\n", TABLEBASE_FILE);
+        return;
+    }
+
+    double probeTime = 0.0;
+    double solverTime = 0.0;
+    int probes = 0;
+    int disagreements = 0;
+    for (int game = 0; game < TABLEBASE_GAMES; game++) {
+        Graph *graph = createSearchBoard(SEARCH_MIN_EDGES + game % (SEARCH_MAX_EDGES - SEARCH_MIN_EDGES));
+        Contraction *contraction = contractionCreate(graph->numberVertices);
+        int player = CUT_PLAYER;
+        while (contractionWinner(contraction, graph) == GAME_UNDERWAY) {
+            if (contractionLive(contraction, graph) <= TABLEBASE_MAX_EDGES) {
+                start = seconds();
+                int winner = tablebaseWinner(tablebase, graph, contraction, player);
+                probeTime += seconds() - start;
+                start = seconds();
+                TreePacking *packing = lehmanSolve(graph, player);
+                solverTime += seconds() - start;
+                disagreements += (winner != packing->winner);
+                treePackingDelete(packing);
+                probes++;
+            }
+
+            int from, to;
+            do {
+                randomCut(graph, &from, &to);
+            } while (!contractionIsLive(contraction, graph, from, to));
+            int state = (player == SHORT_PLAYER) ? LOCKED_EDGE : NO_EDGE;
+            graphSetEdge(graph, from, to, state);
+            graphSetEdge(graph, to, from, state);
+            contractionObserve(contraction, graph, from, to, state);
+            player = 1 - player;
+        }
+        contractionDelete(contraction);
+        graphDelete(graph);
+    }
+    printf("  opened in %.1f us, %d probes in %d games, %.2f us per probe"
+           " (tree packing solver %.2f us), %d disagreements\n",
+           openTime * 1.0e6, probes, TABLEBASE_GAMES,
+           probes > 0 ? probeTime / probes * 1.0e6 : 0.0,
+           probes > 0 ? solverTime / probes * 1.0e6 : 0.0, disagreements);
+    tablebaseClose(tablebase);
+}
+
+/** -------------------------------------------------------------------
+ * Count how often a table keyed by the canonical keys of positions
+ * finds a position it has seen before, against one keyed by their
+ * Zobrist hashes, over a corpus of games of random moves on many
+ * boards. Every position is also given its key again with its nodes
+ * numbered at random, which must give the same key.
+ */
+void benchmarkCanonical() {
+    unsigned long long *hashes = calloc((size_t) 1 << CANONICAL_SET_BITS, sizeof(unsigned long long));
+    unsigned long long *keys = calloc((size_t) 1 << CANONICAL_SET_BITS, sizeof(unsigned long long));
+    CorpusCounts counts = {0, 0, 0, 0, 0.0};
+    printf("\nCanonical keys: %d games of random moves on boards of %d to %d edges,"
+           " every line %d moves deep\n", CANONICAL_GAMES, CANONICAL_MIN_EDGES,
+           CANONICAL_MAX_EDGES_BENCHMARK, CANONICAL_DEPTH);
+
+    for (int game = 0; game < CANONICAL_GAMES; game++) {
+        int edges = CANONICAL_MIN_EDGES + game % (CANONICAL_MAX_EDGES_BENCHMARK - CANONICAL_MIN_EDGES + 1);
+        Graph *graph = createSearchBoard(edges);
+        Position *position = positionCreate(graph, game % 2 == 0 ? CUT_PLAYER : SHORT_PLAYER);
+        int moves[POSITION_MAX_EDGES];
+        int numberMoves;
+        while ((numberMoves = alphaBetaMoves(position, moves)) > 0) {
+            probeTree(position, CANONICAL_DEPTH, hashes, keys, &counts);
+            positionMake(position, moves[rand() % numberMoves]);
+        }
+        positionDelete(position);
+        graphDelete(graph);
+    }
+    long long probes = counts.probes;
+    printf("  %lld positions probed, %.2f us per canonical key, %d disagreements after shuffling\n",
+           probes, probes > 0 ? counts.keyTime / probes * 1.0e6 : 0.0, counts.disagreements);
+    printf("  Zobrist hashes: %lld hits (%.1f%%), canonical keys: %lld hits (%.1f%%)\n",
+           counts.hashHits, probes > 0 ? 100.0 * counts.hashHits / probes : 0.0,
+           counts.keyHits, probes > 0 ? 100.0 * counts.keyHits / probes : 0.0);
+    printf("  positions to store: %lld by Zobrist hash, %lld by canonical key (%.2f times fewer)\n",
+           probes - counts.hashHits, probes - counts.keyHits,
+           probes > counts.keyHits ? (double) (probes - counts.hashHits) / (probes - counts.keyHits)
+                                   : 0.0);
+    free(hashes);
+    free(keys);
+}
+
+/** -------------------------------------------------------------------
+ * Probe both tables with every position a few moves deep, the way a
+ * search would, and check that shuffling the nodes of each position
+ * keeps its canonical key.
+ * @param position the position; the game must not be over
+ * @param depth the moves left to look ahead
+ * @param hashes the positions seen so far, by Zobrist hash
+ * @param keys the positions seen so far, by canonical key
+ * @param counts the counters to add to
+ */
+void probeTree(Position *position, int depth, unsigned long long *hashes,
+               unsigned long long *keys, CorpusCounts *counts) {
+    int moves[POSITION_MAX_EDGES];
+    int numberMoves = alphaBetaMoves(position, moves);
+    for (int i = 0; i < numberMoves && depth > 0; i++) {
+        positionMake(position, moves[i]);
+        int replies[POSITION_MAX_EDGES];
+        if (alphaBetaMoves(position, replies) > 0) {
+            double start = seconds();
+            unsigned long long key = canonicalKey(position);
+            counts->keyTime += seconds() - start;
+            counts->probes++;
+            counts->hashHits += seenBefore(hashes, position->hash);
+            counts->keyHits += seenBefore(keys, key);
+
+            // The same board with its inner nodes shuffled
+            CanonicalGraph board;
+            CanonicalGraph shuffled;
+            int label[CANONICAL_MAX_NODES];
+            int shuffle[CANONICAL_MAX_NODES];
+            canonicalFromPosition(position, &board);
+            for (int v = 0; v < board.numberNodes; v++) {
+                shuffle[v] = v;
+            }
+            for (int v = board.numberNodes - 2; v > 1; v--) {
+                int w = 1 + rand() % v;
+                int swap = shuffle[v];
+                shuffle[v] = shuffle[w];
+                shuffle[w] = swap;
+            }
+            shuffled = board;
+            for (int e = 0; e < board.numberEdges; e++) {
+                shuffled.from[e] = shuffle[board.to[e]];
+                shuffled.to[e] = shuffle[board.from[e]];
+            }
+            counts->disagreements += (canonicalLabel(&board, label) != canonicalLabel(&shuffled, label));
+
+            probeTree(position, depth - 1, hashes, keys, counts);
+        }
+        positionUnmake(position, moves[i]);
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Look a key up in a set, and add it if it is not there.
+ * @param set the set: an open-addressing hash table of
+ *            2^CANONICAL_SET_BITS keys, 0 if empty
+ * @param key the key, not 0
+ * @return TRUE if the key was in the set
+ */
+int seenBefore(unsigned long long *set, unsigned long long key) {
+    unsigned long long mask = ((unsigned long long) 1 << CANONICAL_SET_BITS) - 1;
+    for (unsigned long long slot = key & mask; ; slot = (slot + 1) & mask) {
+        if (set[slot] == key) {
+            return TRUE;
+        }
+        if (set[slot] == 0) {
+            set[slot] = key;
+            return FALSE;
+        }
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Measure how the number of playouts of the Monte Carlo search grows
+ * with the number of threads, from 1 up to one per processor.
+ */
+void benchmarkMonteCarlo() {
+    Graph *graph = createLargeBoard(SOLVER_BOARD_VERTICES);
+    MonteCarloTree *tree = monteCarloCreate(MONTE_CARLO_TREE_NODES);
+    Contraction *contraction = contractionCreate(graph->numberVertices);
+    printf("\nMonte Carlo search: %d vertices, %d edges, %d ms per move\n",
+           graph->numberVertices, graphNumberEdges(graph), MONTE_CARLO_BENCHMARK_TIME);
+    printf(" threads   playouts/s    speedup  tree nodes  win rate\n");
+
+    double baseline = 0.0;
+    int processors = numberProcessors();
+    for (int threads = 1; ; threads *= 2) {
+        if (threads > processors) {
+            threads = processors;
+        }
+        ThreadPool *pool = threadPoolCreate(threads);
+        Edge edge;
+        MonteCarloStatistics statistics;
+        monteCarloMove(tree, graph, contraction, CUT_PLAYER, pool, MONTE_CARLO_BENCHMARK_TIME,
+                       &edge, &statistics);
+        threadPoolDelete(pool);
+
+        double rate = statistics.playouts / statistics.seconds;
+        if (threads == 1) {
+            baseline = rate;
+        }
+        printf("%8d %12.0f %10.2f %11d %9.3f\n", threads, rate, rate / baseline,
+               statistics.treeNodes, statistics.winRate);
+        if (threads == processors) {
+            break;
+        }
+    }
+    contractionDelete(contraction);
+    monteCarloDelete(tree);
+    graphDelete(graph);
+}
+
+/** -------------------------------------------------------------------
+ * Measure how fast random games are played out one at a time, the way
+ * the Monte Carlo search plays them on big boards, and PLAYOUT_LANES
+ * at a time on the small ones, and check that both give Short the same
+ * chance of winning. Then measure the playouts of the Monte Carlo
+ * search itself on the same boards.
+ */
+void benchmarkPlayouts() {
+    MonteCarloTree *tree = monteCarloCreate(MONTE_CARLO_TREE_NODES);
+    ThreadPool *pool = threadPoolCreate(1);
+    printf("\nRandom playouts: %d games each way on the contracted boards, 1 thread\n",
+           PLAYOUT_BENCHMARK_GAMES);
+    printf("   edges  nodes  one at a time/s   batched/s  speedup  Short wins (one/batched)"
+           "  search playouts/s\n");
+
+    for (int edges = SEARCH_MIN_EDGES; edges <= SEARCH_MAX_EDGES; edges += 2 * SEARCH_EDGES_STEP) {
+        Graph *graph = createSearchBoard(edges);
+        Position *position = positionCreate(graph, CUT_PLAYER);
+        int moves[POSITION_MAX_EDGES];
+        if (alphaBetaMoves(position, moves) == 0) {
+            positionDelete(position);
+            graphDelete(graph);
+            continue;
+        }
+        CanonicalGraph contracted;
+        canonicalFromPosition(position, &contracted);
+        Edge list[PLAYOUT_MAX_EDGES];
+        for (int e = 0; e < contracted.numberEdges; e++) {
+            list[e].fromVertex = contracted.from[e];
+            list[e].toVertex = contracted.to[e];
+        }
+        PlayoutBoard board;
+        playoutSetBoard(&board, contracted.numberNodes, contracted.numberEdges, list);
+        unsigned long long all = (contracted.numberEdges == 64) ? ~0ULL
+                                 : (1ULL << contracted.numberEdges) - 1;
+
+        unsigned long long random = 220;
+        int scalarWins = 0;
+        double start = seconds();
+        for (int i = 0; i < PLAYOUT_BENCHMARK_GAMES; i++) {
+            scalarWins += scalarPlayout(&contracted, CUT_PLAYER, &random);
+        }
+        double scalarTime = seconds() - start;
+
+        int batchedWins = 0;
+        start = seconds();
+        for (int i = 0; i < PLAYOUT_BENCHMARK_GAMES / PLAYOUT_LANES; i++) {
+            batchedWins += playoutCount(playoutRun(&board, all, 0, CUT_PLAYER, &random, NULL));
+        }
+        double batchedTime = seconds() - start;
+
+        Contraction *contraction = contractionCreate(graph->numberVertices);
+        Edge edge;
+        MonteCarloStatistics statistics;
+        monteCarloMove(tree, graph, contraction, CUT_PLAYER, pool, PLAYOUT_BENCHMARK_TIME,
+                       &edge, &statistics);
+
+        printf("%8d %6d %16.0f %11.0f %8.1f %11.3f / %-11.3f %18.0f\n", edges, contracted.numberNodes,
+               PLAYOUT_BENCHMARK_GAMES / scalarTime, PLAYOUT_BENCHMARK_GAMES / batchedTime,
+               scalarTime / batchedTime, (double) scalarWins / PLAYOUT_BENCHMARK_GAMES,
+               (double) batchedWins / PLAYOUT_BENCHMARK_GAMES, statistics.playouts / statistics.seconds);
+        contractionDelete(contraction);
+        positionDelete(position);
+        graphDelete(graph);
+    }
+    threadPoolDelete(pool);
+    monteCarloDelete(tree);
+}
+
+/** -------------------------------------------------------------------
+ * Play one random game to the end the way the Monte Carlo search does
+ * on a big board: shuffle the edges, give them out in turn, and join
+ * Short's with union-find.
+ * @param graph the contracted board, every edge still to be taken
+ * @param playerToMove Either CUT_PLAYER or SHORT_PLAYER
+ * @param random the state of a xorshift64* generator
+ * @return TRUE if Short wins
+ */
+int scalarPlayout(CanonicalGraph *graph, int playerToMove, unsigned long long *random) {
+    int order[CANONICAL_MAX_EDGES];
+    int parent[CANONICAL_MAX_NODES];
+    for (int e = 0; e < graph->numberEdges; e++) {
+        order[e] = e;
+    }
+    for (int v = 0; v < graph->numberNodes; v++) {
+        parent[v] = v;
+    }
+    int player = playerToMove;
+    for (int i = 0; i < graph->numberEdges; i++) {
+        unsigned long long x = *random;
+        x ^= x >> 12;
+        x ^= x << 25;
+        x ^= x >> 27;
+        *random = x;
+        int j = i + (int) ((x * 0x2545F4914F6CDD1DULL) % (unsigned long long) (graph->numberEdges - i));
+        int e = order[j];
+        order[j] = order[i];
+        order[i] = e;
+        if (player == SHORT_PLAYER) {
+            int a = graph->from[e];
+            int b = graph->to[e];
+            while (parent[a] != a) {
+                a = parent[a] = parent[parent[a]];
+            }
+            while (parent[b] != b) {
+                b = parent[b] = parent[parent[b]];
+            }
+            parent[a] = b;
+        }
+        player = 1 - player;
+    }
+    int a = 0;
+    int b = graph->numberNodes - 1;
+    while (parent[a] != a) {
+        a = parent[a];
+    }
+    while (parent[b] != b) {
+        b = parent[b];
+    }
+    return a == b;
+}
+
+/** -------------------------------------------------------------------
+ * Measure how the lookahead speeds up with the number of threads, from
+ * 1 up to one per processor, and check that every number of threads
+ * picks the same edges.
+ */
+void benchmarkLookahead() {
+    Graph *graph = createLargeBoard(SOLVER_BOARD_VERTICES);
+    SearchWorkspace *scratch = workspaceCreate(graph->numberVertices);
+    Adjacency *board = adjacencyFromGraph(graph, NORMAL_EDGE);
+    Adjacency *locked = adjacencyFromGraph(graph, LOCKED_EDGE);
+    Lookahead *lookahead = lookaheadCreate(board->numberVertices, board->numberArcs);
+    int shortest = edgeBetweenness(graph, scratch, 0, graph->numberVertices - 1);
+    int found = lookaheadAddFlowEdges(lookahead, board, locked, scratch->edges, scratch->scores, shortest);
+    printf("\nLookahead: %d vertices, %d edges, %d edges on a shortest path, %d candidates\n",
+           graph->numberVertices, graphNumberEdges(graph), shortest, found);
+    printf(" threads   ms per move    speedup    searches  same edges\n");
+
+    double baseline = 0.0;
+    Edge first[2];
+    int processors = numberProcessors();
+    for (int threads = 1; ; threads *= 2) {
+        if (threads > processors) {
+            threads = processors;
+        }
+        ThreadPool *pool = threadPoolCreate(threads);
+        double milliseconds = 0.0;
+        long long searches = 0;
+        int same = TRUE;
+        for (int i = 0; i < LOOKAHEAD_REPETITIONS; i++) {
+            for (int player = CUT_PLAYER; player <= SHORT_PLAYER; player++) {
+                Edge edge;
+                LookaheadStatistics statistics;
+                lookaheadMove(lookahead, board, locked, player, scratch->edges, scratch->scores, found,
+                              pool, &edge, &statistics);
+                milliseconds += statistics.milliseconds;
+                searches += statistics.searches;
+                if (threads == 1 && i == 0) {
+                    first[player] = edge;
+                }
+                same = same && edge.fromVertex == first[player].fromVertex &&
+                       edge.toVertex == first[player].toVertex;
+            }
+        }
+        threadPoolDelete(pool);
+
+        double perMove = milliseconds / (2 * LOOKAHEAD_REPETITIONS);
+        if (threads == 1) {
+            baseline = perMove;
+        }
+        printf("%8d %13.2f %10.2f %11lld  %s\n", threads, perMove, baseline / perMove,
+               searches / (2 * LOOKAHEAD_REPETITIONS), same ? "yes" : "NO");
+        if (threads == processors) {
+            break;
+        }
+    }
+    lookaheadDelete(lookahead);
+    adjacencyDelete(board);
+    adjacencyDelete(locked);
+    workspaceDelete(scratch);
+    graphDelete(graph);
+}
+
+/** -------------------------------------------------------------------
+ * Measure how the thread pool shares out uneven work: a loop whose
+ * tasks get longer and longer, cut into one block per worker by hand
+ * and handed to the pool one index at a time, and a tree of tasks of
+ * random shape that fork and join.
+ */
+void benchmarkScheduler() {
+    unsigned long long *sums = malloc(SCHEDULER_TASKS * sizeof(unsigned long long));
+    printf("\nScheduler: %d uneven tasks, fork/join tree %d deep\n", SCHEDULER_TASKS, SCHEDULER_DEPTH);
+    printf(" threads  blocks (ms)  stealing (ms)  speedup  fork/join (ms)  speedup  same sums\n");
+
+    double loopBaseline = 0.0;
+    double treeBaseline = 0.0;
+    unsigned long long firstLoop = 0;
+    unsigned long long firstTree = 0;
+    int processors = numberProcessors();
+    for (int threads = 1; ; threads *= 2) {
+        if (threads > processors) {
+            threads = processors;
+        }
+        ThreadPool *pool = threadPoolCreate(threads);
+
+        // The same loop cut into even blocks of indexes, then stolen
+        UnevenLoop loop = {threads, sums};
+        double start = seconds();
+        threadPoolFor(pool, threads, unevenTask, &loop);
+        double blocks = seconds() - start;
+        loop.numberBlocks = 0;
+        start = seconds();
+        threadPoolFor(pool, SCHEDULER_TASKS, unevenTask, &loop);
+        double stealing = seconds() - start;
+        unsigned long long loopSum = 0;
+        for (int i = 0; i < SCHEDULER_TASKS; i++) {
+            loopSum += sums[i];
+        }
+
+        ForkNode root = {pool, SCHEDULER_DEPTH, 220, 0};
+        start = seconds();
+        forkTask(&root, 0, 0);
+        double tree = seconds() - start;
+        threadPoolDelete(pool);
+
+        if (threads == 1) {
+            loopBaseline = stealing;
+            treeBaseline = tree;
+            firstLoop = loopSum;
+            firstTree = root.sum;
+        }
+        printf("%8d %12.1f %14.1f %8.2f %15.1f %8.2f  %s\n", threads, blocks * 1000.0,
+               stealing * 1000.0, loopBaseline / stealing, tree * 1000.0, treeBaseline / tree,
+               loopSum == firstLoop && root.sum == firstTree ? "yes" : "NO");
+        if (threads == processors) {
+            break;
+        }
+    }
+    free(sums);
+}
+
+/** -------------------------------------------------------------------
+ * Run one index of the uneven loop, or one even block of indexes.
+ * @param context the UnevenLoop
+ * @param taskIndex the index, or the block
+ * @param workerIndex the index of the worker
+ */
+void unevenTask(void *context, int taskIndex, int workerIndex) {
+    UnevenLoop *loop = context;
+    int first = taskIndex;
+    int last = taskIndex + 1;
+    if (loop->numberBlocks > 0) {
+        first = (int) ((long long) SCHEDULER_TASKS * taskIndex / loop->numberBlocks);
+        last = (int) ((long long) SCHEDULER_TASKS * (taskIndex + 1) / loop->numberBlocks);
+    }
+    for (int i = first; i < last; i++) {
+        loop->sums[i] = work((unsigned long long) i, (i + 1) * SCHEDULER_WORK);
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Run a task of the fork/join tree: fork one to three tasks one level
+ * down and add up their sums, or do the work of a leaf.
+ * @param context an array of ForkNode
+ * @param taskIndex the node of the array
+ * @param workerIndex the index of the worker
+ */
+void forkTask(void *context, int taskIndex, int workerIndex) {
+    ForkNode *node = (ForkNode *) context + taskIndex;
+    if (node->depth == 0) {
+        node->sum = work(node->seed, SCHEDULER_LEAF_WORK);
+        return;
+    }
+    ForkNode children[3];
+    int numberChildren = 1 + (int) (work(node->seed, 1) % 3);
+    TaskGroup group = {0};
+    for (int i = 0; i < numberChildren; i++) {
+        children[i].pool = node->pool;
+        children[i].depth = node->depth - 1;
+        children[i].seed = node->seed * 3 + (unsigned int) i + 1;
+        children[i].sum = 0;
+        threadPoolFork(node->pool, &group, forkTask, children, i);
+    }
+    threadPoolJoin(node->pool, &group);
+    node->sum = 0;
+    for (int i = 0; i < numberChildren; i++) {
+        node->sum += children[i].sum;
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Do some work that the compiler cannot leave out.
+ * @param seed where to start
+ * @param steps the number of steps
+ * @return a mix of the seed
+ */
+unsigned long long work(unsigned long long seed, int steps) {
+    unsigned long long x = seed + 0x9E3779B97F4A7C15ULL;
+    for (int i = 0; i < steps; i++) {
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 27;
+    }
+    return x;
+}
+
+/** -------------------------------------------------------------------
+ * Pick random edges of a board to lock.
+ * @param board the board
+ * @param percent the percentage of the edges to lock
+ * @return the locked edges
+ */
+Adjacency * lockSomeEdges(Adjacency *board, int percent) {
+    int n = board->numberVertices;
+    char *lock = malloc((size_t) board->numberArcs);
+    int *degree = calloc((size_t) n, sizeof(int));
+    for (int v = 0; v < n; v++) {
+        for (int k = board->offsets[v]; k < board->offsets[v+1]; k++) {
+            int w = board->neighbors[k];
+            lock[k] = (char) (v < w && rand() % 100 < percent);
+            if (lock[k]) {
+                degree[v]++;
+                degree[w]++;
+            }
+        }
+    }
+
+    int numberArcs = 0;
+    for (int v = 0; v < n; v++) {
+        numberArcs += degree[v];
+    }
+    Adjacency *locked = adjacencyCreate(n, numberArcs);
+    locked->offsets[0] = 0;
+    for (int v = 0; v < n; v++) {
+        locked->offsets[v+1] = locked->offsets[v] + degree[v];
+        degree[v] = locked->offsets[v]; // Re-used as the next free slot
+    }
+    for (int v = 0; v < n; v++) {
+        for (int k = board->offsets[v]; k < board->offsets[v+1]; k++) {
+            if (lock[k]) {
+                int w = board->neighbors[k];
+                locked->neighbors[degree[v]++] = w;
+                locked->neighbors[degree[w]++] = v;
+            }
+        }
+    }
+
+    free(lock);
+    free(degree);
+    return locked;
+}
+
+/** -------------------------------------------------------------------
+ * Measure how long the resistor network takes to solve, and how many
+ * conjugate gradient iterations it needs. The times spread widely from
+ * one run to the next, so the worst solve is shown as well.
+ */
+void benchmarkResistance() {
+    Adjacency *board = createStressBoard(CIRCUIT_BOARD_WIDTH, CIRCUIT_BOARD_HEIGHT);
+    Adjacency *locked = lockSomeEdges(board, CIRCUIT_LOCKED_PERCENT);
+    ResistanceSolver *solver = resistanceCreate(board->numberVertices, board->numberArcs);
+    printf("\nResistor network: %d vertices, %d edges, %d locked\n",
+           board->numberVertices, board->numberArcs / 2, locked->numberArcs / 2);
+
+    double total = 0.0;
+    double best = 1.0e30;
+    double worst = 0.0;
+    for (int j = 0; j < CIRCUIT_REPETITIONS; j++) {
+        resistanceForget(solver);
+        double start = seconds();
+        resistanceSolve(solver, board, locked);
+        double elapsed = seconds() - start;
+        total += elapsed;
+        if (elapsed < best) {
+            best = elapsed;
+        }
+        if (elapsed > worst) {
+            worst = elapsed;
+        }
+    }
+    printf("  %d nodes, %d iterations, effective resistance %.4f ohms\n",
+           solver->numberUnknowns, solver->iterations, solver->effectiveResistance);
+    printf("  average %.2f ms, best %.2f ms, worst %.2f ms per solve\n",
+           total / CIRCUIT_REPETITIONS * 1000.0, best * 1000.0, worst * 1000.0);
+
+    resistanceDelete(solver);
+    adjacencyDelete(locked);
+    adjacencyDelete(board);
+}
+
+/** -------------------------------------------------------------------
+ * Measure how much solving the resistor network from the voltages of
+ * the last turn saves over solving it from nothing, while the edge
+ * with the most current is locked or cut on every turn.
+ */
+void benchmarkWarmStart() {
+    Graph *graph = createLargeBoard(SOLVER_BOARD_VERTICES);
+    int arcs = 2 * graphNumberEdges(graph);
+    ResistanceSolver *warm = resistanceCreate(graph->numberVertices, arcs);
+    ResistanceSolver *cold = resistanceCreate(graph->numberVertices, arcs);
+    printf("\nResistor network between moves: %d vertices, %d edges\n",
+           graph->numberVertices, arcs / 2);
+
+    double warmTime = 0.0;
+    double coldTime = 0.0;
+    long long warmIterations = 0;
+    long long coldIterations = 0;
+    int moves = 0;
+    for (int move = 0; move < SOLVER_MOVES; move++) {
+        Adjacency *board = adjacencyFromGraph(graph, NORMAL_EDGE);
+        Adjacency *locked = adjacencyFromGraph(graph, LOCKED_EDGE);
+        double start = seconds();
+        int underway = resistanceSolve(warm, board, locked);
+        double middle = seconds();
+        resistanceForget(cold);
+        resistanceSolve(cold, board, locked);
+        double end = seconds();
+        adjacencyDelete(board);
+        adjacencyDelete(locked);
+        if (!underway) {
+            break;
+        }
+
+        // The first solve has nothing to start from
+        if (move > 0) {
+            warmTime += middle - start;
+            coldTime += end - middle;
+            warmIterations += warm->iterations;
+            coldIterations += cold->iterations;
+            moves++;
+        }
+
+        // Short and Cut take turns playing the edge with the most current
+        double best = 0.0;
+        int from = -1;
+        int to = -1;
+        for (int u = 0; u < graph->numberVertices; u++) {
+            for (int j = 0; j < graph->degree[u]; j++) {
+                int v = graph->neighbors[u][j];
+                double current = resistanceCurrent(warm, u, v);
+                if (graphGetEdge(graph, u, v) == NORMAL_EDGE && current > best) {
+                    best = current;
+                    from = u;
+                    to = v;
+                }
+            }
+        }
+        if (from == -1) {
+            break;
+        }
+        int state = (move % 2 == 0) ? NO_EDGE : LOCKED_EDGE;
+        graphSetEdge(graph, from, to, state);
+        graphSetEdge(graph, to, from, state);
+    }
+    if (moves > 0) {
+        printf("  %d moves: from the last voltages %.2f ms (%.1f iterations),"
+               " from nothing %.2f ms (%.1f iterations)\n", moves,
+               warmTime / moves * 1000.0, (double) warmIterations / moves,
+               coldTime / moves * 1000.0, (double) coldIterations / moves);
+    }
+
+    resistanceDelete(warm);
+    resistanceDelete(cold);
+    graphDelete(graph);
+}
+
+/** -------------------------------------------------------------------
+ * Measure how fast the spanning tree sampler estimates the currents,
+ * and how close it gets to the currents of the resistance solver, for
+ * more and more trees.
+ */
+void benchmarkTreeSampler() {
+    Adjacency *board = createStressBoard(CIRCUIT_BOARD_WIDTH, CIRCUIT_BOARD_HEIGHT);
+    Adjacency *locked = lockSomeEdges(board, CIRCUIT_LOCKED_PERCENT);
+    ResistanceSolver *solver = resistanceCreate(board->numberVertices, board->numberArcs);
+    TreeSampler *sampler = samplerCreate(board->numberVertices, board->numberArcs);
+    ThreadPool *pool = threadPoolCreate(numberProcessors());
+    printf("\nSpanning tree sampler: %d vertices, %d edges, %d threads\n",
+           board->numberVertices, board->numberArcs / 2, pool->numberThreads);
+    printf("   trees    time (ms)  steps/tree   rms error  best edge\n");
+
+    // The solver's currents are for 1 volt; the sampler's are for 1 amp
+    resistanceSolve(solver, board, locked);
+    double scale = solver->effectiveResistance;
+
+    for (int trees = SAMPLER_BENCHMARK_TREES; trees <= SAMPLER_BENCHMARK_MOST; trees *= 4) {
+        double start = seconds();
+        samplerRun(sampler, board, locked, pool, trees, INT_MAX);
+        double elapsed = seconds() - start;
+
+        // Compare every edge, and the current of the edge each one picks
+        double error = 0.0;
+        double exactBest = 0.0;
+        double sampledBest = 0.0;
+        double picked = 0.0;
+        for (int u = 0; u < board->numberVertices; u++) {
+            for (int k = board->offsets[u]; k < board->offsets[u+1]; k++) {
+                int v = board->neighbors[k];
+                double exact = resistanceCurrent(solver, u, v) * scale;
+                double sampled = samplerCurrent(sampler, u, v);
+                error += (exact - sampled) * (exact - sampled);
+                if (exact > exactBest) {
+                    exactBest = exact;
+                }
+                if (sampled > sampledBest) {
+                    sampledBest = sampled;
+                    picked = exact;
+                }
+            }
+        }
+        printf("%8d %12.1f %11.0f %11.4f %9.0f%%\n", sampler->trees, elapsed * 1000.0,
+               (double) sampler->steps / sampler->trees, sqrt(error / board->numberArcs),
+               picked / exactBest * 100.0);
+    }
+
+    threadPoolDelete(pool);
+    samplerDelete(sampler);
+    resistanceDelete(solver);
+    adjacencyDelete(locked);
+    adjacencyDelete(board);
+}
+
+/** -------------------------------------------------------------------
+ * Measure how fast the contracted board tells if the game is over,
+ * against two searches of the whole board (for a path through
+ * the normal and locked edges, and for one through only the locked
+ * edges), while Cut and Short play random moves on a large board.
+ * Also measure how many of the normal edges are live before each move,
+ * which is the number of moves worth considering, and how early the
+ * bridges decide the game.
+ */
+void benchmarkContraction() {
+    Graph *graph = createLargeBoard(SOLVER_BOARD_VERTICES);
+    int *queue = malloc(graph->numberVertices * sizeof(int));
+    char *seen = malloc((size_t) graph->numberVertices);
+    Contraction *contraction = contractionCreate(graph->numberVertices);
+    printf("\nGame over test: %d vertices, %d edges, random moves\n",
+           graph->numberVertices, graphNumberEdges(graph));
+
+    double contractionTime = 0.0;
+    double searchTime = 0.0;
+    double blockTime = 0.0;
+    long long normalEdges = 0;
+    long long liveEdges = 0;
+    int moves = 0;
+    int decided = 0;
+    int disagreements = 0;
+    int winner = GAME_UNDERWAY;
+    for (int player = CUT_PLAYER; winner == GAME_UNDERWAY; player = 1 - player) {
+        contractionLive(contraction, graph);
+        normalEdges += contraction->live.normalEdges;
+        liveEdges += contraction->live.liveEdges;
+
+        int from, to;
+        int state = (player == SHORT_PLAYER) ? LOCKED_EDGE : NO_EDGE;
+        randomCut(graph, &from, &to);
+        graphSetEdge(graph, from, to, state);
+        graphSetEdge(graph, to, from, state);
+        contractionObserve(contraction, graph, from, to, state);
+        moves++;
+
+        double start = seconds();
+        winner = contractionWinner(contraction, graph);
+        contractionTime += seconds() - start;
+
+        start = seconds();
+        int searched = !reachesEnd(graph, NORMAL_EDGE, queue, seen) ? CUT_WINS
+                       : reachesEnd(graph, LOCKED_EDGE, queue, seen) ? SHORT_WINS : GAME_UNDERWAY;
+        searchTime += seconds() - start;
+        disagreements += (searched != winner);
+
+        start = seconds();
+        int bridgeWinner = contractionDecided(contraction, graph, 1 - player);
+        blockTime += seconds() - start;
+        if (decided == 0 && bridgeWinner != GAME_UNDERWAY) {
+            decided = moves;
+        }
+    }
+    printf("  %s wins after %d moves, %d groups left, %d disagreements\n",
+           winner == SHORT_WINS ? "Short" : "Cut", moves, contraction->numberGroups, disagreements);
+    printf("  contracted board %.2f us per move, two searches %.2f us per move\n",
+           contractionTime / moves * 1.0e6, searchTime / moves * 1.0e6);
+    printf("  live edges: %.1f of %.1f normal edges per move (%.0f%%), blocks %.2f us per move\n",
+           (double) liveEdges / moves, (double) normalEdges / moves,
+           normalEdges > 0 ? 100.0 * liveEdges / normalEdges : 0.0, blockTime / moves * 1.0e6);
+    printf("  blocks found %d times, kept after %d moves on dead edges\n",
+           contraction->live.analyses, contraction->live.deadMoves);
+    printf("  decided by the bridges after %d moves\n", decided);
+
+    contractionDelete(contraction);
+    free(queue);
+    free(seen);
+    graphDelete(graph);
+}
+
+/** -------------------------------------------------------------------
+ * Search the whole board breadth first for a path from the starting to
+ * the ending vertex.
+ * @param graph the board
+ * @param minimumState NORMAL_EDGE to follow every edge, or LOCKED_EDGE
+ *                     to follow only the locked edges
+ * @param queue scratch space for the vertices
+ * @param seen scratch space for the vertices
+ * @return TRUE if there is a path
+ */
+int reachesEnd(Graph *graph, int minimumState, int *queue, char *seen) {
+    int n = graph->numberVertices;
+    memset(seen, 0, (size_t) n);
+    int head = 0;
+    int tail = 0;
+    queue[tail++] = 0;
+    seen[0] = 1;
+    while (head < tail) {
+        int u = queue[head++];
+        if (u == n - 1) {
+            return TRUE;
+        }
+        for (int j = 0; j < graph->degree[u]; j++) {
+            int v = graph->neighbors[u][j];
+            if (!seen[v] && graphGetEdge(graph, u, v) >= minimumState) {
+                seen[v] = 1;
+                queue[tail++] = v;
+            }
+        }
+    }
+    return FALSE;
+}
+
+/** -------------------------------------------------------------------
+ * Pick a random normal edge of the board.
+ * @param graph the board; it must have a normal edge
+ * @param from output: one end of the edge
+ * @param to output: the other end of the edge
+ */
+void randomCut(Graph *graph, int *from, int *to) {
+    do {
+        do {
+            *from = rand() % graph->numberVertices;
+        } while (graph->degree[*from] == 0);
+        *to = graph->neighbors[*from][rand() % graph->degree[*from]];
+    } while (graphGetEdge(graph, *from, *to) != NORMAL_EDGE);
+}
@@ -0,0 +1,34 @@
+/** PEX4_tablebase.c
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: Build the endgame tablebase the game reads at
+ *          startup. Run it from a console in the folder the game
+ *          is run from.
+ * ===========================================================
+ */
+
+#include <windows.h>
+#include <stdio.h>
+#include "gameLogic.h"
+#include "search.h"
+#include "tablebase.h"
+
+int main() {
+    TablebaseStatistics statistics;
+    ThreadPool *pool = searchThreadPool();
+    printf("Endgame tablebase: every position with up to %d live edges, %d threads\n",
+           TABLEBASE_MAX_EDGES, pool->numberThreads);
+    if (!tablebaseBuild(TABLEBASE_FILE, TABLEBASE_MAX_EDGES, pool, &statistics)) {
+        return 1;
+    }
+
+    for (int edges = 1; edges <= TABLEBASE_MAX_EDGES; edges++) {
+        printf("  %d live edges: %d positions\n", edges, statistics.positions[edges]);
+    }
+    printf("  %lld moves taken back in %.1f ms, %.1f KB written to %s\n", statistics.moves,
+           statistics.milliseconds, statistics.bytes / 1024.0, TABLEBASE_FILE);
+    return 0;
+}
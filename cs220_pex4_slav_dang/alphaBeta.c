@@ -0,0 +1,407 @@
+/** alphaBeta.c
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The implementation of an exact game-tree search
+ *          (negamax with alpha-beta pruning and a
+ *          transposition table) for small and mid-size boards.
+ * ===========================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include "alphaBeta.h"
+#include "threadPool.h"
+
+// The values of a position for the player to move. A position that is
+// not searched to the end is worth something in between.
+#define WIN    1000
+#define LOSS  -1000
+
+// Short's score of a position at the search horizon: each normal edge
+// on a shortest path between the terminals counts for Short, and each
+// edge Short still needs on one counts against
+#define PATH_EDGE_SCORE   1
+#define DISTANCE_SCORE    8
+
+// The search checks the clock every this many nodes
+#define CLOCK_NODES     256
+
+// What one search shares between its nodes.
+typedef struct alphaBetaSearch {
+    TranspositionTable * table;
+    AlphaBetaStatistics * statistics;
+    LONGLONG deadline;         // When to stop, in QueryPerformanceCounter()
+                               //   ticks; 0 for no limit
+    volatile LONG * stop;      // Another thread sets it to stop; may be NULL
+    int aborted;               // TRUE once the time is up
+    int horizon;               // TRUE if a position was left unsearched
+} AlphaBetaSearch;
+
+// Local functions
+static int negamax(Position *position, AlphaBetaSearch *search, int depth, int alpha, int beta,
+                   int firstMove, int *bestMove);
+static int evaluate(Position *position);
+static int candidateMoves(Position *position, int *moves);
+static int orderMoves(Position *position, int *moves);
+static int mostCriticalMove(Position *position);
+static int edgeCode(Position *position, int e);
+
+/** -------------------------------------------------------------------
+ * Create an empty transposition table.
+ * @param bits the table has 2^bits entries
+ * @return a pointer to a transposition table struct
+ */
+TranspositionTable * tableCreate(int bits) {
+    TranspositionTable *table = malloc(sizeof(TranspositionTable));
+    table->size = 1 << bits;
+    table->entries = calloc((size_t) table->size, sizeof(TranspositionEntry));
+    return table;
+}
+
+/** -------------------------------------------------------------------
+ * Delete a transposition table
+ * @param table the table to delete
+ */
+void tableDelete(TranspositionTable *table) {
+    free(table->entries);
+    free(table);
+}
+
+/** -------------------------------------------------------------------
+ * Forget every entry of a transposition table.
+ * @param table the table
+ */
+void tableClear(TranspositionTable *table) {
+    for (int i = 0; i < table->size; i++) {
+        table->entries[i].key = 0;
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Solve a position exactly with a negamax search. The moves are tried
+ * most critical first: the edges on the shortest paths between the
+ * terminals.
+ * @param position the position; it is the same when the search returns
+ * @param table the transposition table; it can be kept between turns
+ * @param bestMove output: the index of a best edge to play, or -1 if
+ *                 the game is already over
+ * @param statistics output, may be NULL
+ * @return SHORT_WINS or CUT_WINS with perfect play
+ */
+int alphaBetaSolve(Position *position, TranspositionTable *table, int *bestMove,
+                   AlphaBetaStatistics *statistics) {
+    AlphaBetaStatistics counters = {0, 0, 0};
+    AlphaBetaSearch search = {table, &counters, 0, NULL, FALSE, FALSE};
+    int mover = position->playerToMove;
+    int value = negamax(position, &search, POSITION_MAX_EDGES, LOSS, WIN, -1, bestMove);
+
+    // A lost position from the table has no best edge; play the most
+    // critical one
+    if (*bestMove == -1) {
+        *bestMove = mostCriticalMove(position);
+    }
+    if (statistics != NULL) {
+        *statistics = counters;
+    }
+
+    int moverWins = (mover == SHORT_PLAYER) ? SHORT_WINS : CUT_WINS;
+    int otherWins = (mover == SHORT_PLAYER) ? CUT_WINS : SHORT_WINS;
+    return (value == WIN) ? moverWins : otherWins;
+}
+
+/** -------------------------------------------------------------------
+ * Search a position one move deeper at a time until the time is up
+ * (iterative deepening). The best move of each finished depth is
+ * searched first at the next one, and the positions solved on the way
+ * stay in the table, so each depth costs little more than the last.
+ * The depth that was cut short by the clock is thrown away, so the move
+ * is always the best one of a finished search.
+ * @param position the position; it is the same when the search returns
+ * @param table the transposition table; it can be kept between turns
+ * @param milliseconds how long to search
+ * @param stop the search also ends once another thread sets *stop to
+ *             TRUE; may be NULL
+ * @param bestMove output: the index of the edge to play, or -1 if the
+ *                 game is already over
+ * @param statistics output, may be NULL
+ * @return SHORT_WINS or CUT_WINS if the search reached the end of the
+ *         game, or GAME_UNDERWAY if the time ran out first
+ */
+int alphaBetaDeepen(Position *position, TranspositionTable *table, int milliseconds,
+                    volatile LONG *stop, int *bestMove, AlphaBetaStatistics *statistics) {
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    AlphaBetaStatistics counters = {0, 0, 0};
+    AlphaBetaSearch search = {table, &counters, 0, stop, FALSE, FALSE};
+    search.deadline = ticks() + (LONGLONG) milliseconds * frequency.QuadPart / 1000;
+
+    int mover = position->playerToMove;
+    int winner = GAME_UNDERWAY;
+    *bestMove = -1;
+    for (int depth = 1; depth <= POSITION_MAX_EDGES; depth++) {
+        int move;
+        search.horizon = FALSE;
+        int value = negamax(position, &search, depth, LOSS, WIN, *bestMove, &move);
+        if (search.aborted) {
+            break;
+        }
+        counters.depth = depth;
+        if (move != -1) {
+            *bestMove = move;
+        }
+
+        // Stop once the result is proven, or nothing was left to search
+        if (value == WIN || value == LOSS || !search.horizon) {
+            int moverWins = (mover == SHORT_PLAYER) ? SHORT_WINS : CUT_WINS;
+            winner = (value > 0) ? moverWins : SHORT_WINS + CUT_WINS - moverWins;
+            break;
+        }
+    }
+
+    if (*bestMove == -1) {
+        *bestMove = mostCriticalMove(position);
+    }
+    if (statistics != NULL) {
+        *statistics = counters;
+    }
+    return winner;
+}
+
+/** -------------------------------------------------------------------
+ * List the moves the search tries in a position, most critical first.
+ * Moves that cannot be better than another move are left out.
+ * @param position the position
+ * @param moves output: the edge indexes (up to POSITION_MAX_EDGES)
+ * @return the number of moves; 0 if the game is over or the player to
+ *         move has lost
+ */
+int alphaBetaMoves(Position *position, int *moves) {
+    if (positionDistances(position) != GAME_UNDERWAY) {
+        return 0;
+    }
+    return candidateMoves(position, moves);
+}
+
+/** -------------------------------------------------------------------
+ * Negamax search to a set depth. A game that is searched to the end is
+ * worth WIN or LOSS to the player to move; a position at the depth
+ * limit gets a score in between from evaluate(). Because the search
+ * fails soft, a WIN or LOSS is only ever returned when it is proven,
+ * and only those results go in the table, which keeps the table exact.
+ * @param position the position
+ * @param search the table, counters and clock of the search
+ * @param depth the number of moves left to look ahead
+ * @param alpha the value the player to move is already sure of
+ * @param beta the value the opponent is already sure to hold it to
+ * @param firstMove the edge to search first, or -1
+ * @param bestMove output: the best edge, or -1 if the game is over
+ * @return the value of the position for the player to move; not to be
+ *         used if search->aborted is set
+ */
+int negamax(Position *position, AlphaBetaSearch *search, int depth, int alpha, int beta,
+            int firstMove, int *bestMove) {
+    AlphaBetaStatistics *statistics = search->statistics;
+    TranspositionTable *table = search->table;
+    statistics->nodes++;
+    *bestMove = -1;
+    if (search->deadline != 0 && statistics->nodes % CLOCK_NODES == 0 &&
+        (ticks() >= search->deadline || (search->stop != NULL && *search->stop))) {
+        search->aborted = TRUE;
+    }
+    if (search->aborted) {
+        return 0;
+    }
+    int moverWins = (position->playerToMove == SHORT_PLAYER) ? SHORT_WINS : CUT_WINS;
+
+    // A position seen before
+    TranspositionEntry *entry = &table->entries[position->hash & (table->size - 1)];
+    if (entry->key == position->hash) {
+        statistics->tableHits++;
+        if (entry->bestEdge != -1) {
+            int n = position->numberVertices;
+            *bestMove = positionFindEdge(position, entry->bestEdge / n, entry->bestEdge % n);
+        }
+        return (entry->winner == moverWins) ? WIN : LOSS;
+    }
+
+    int winner = positionDistances(position);
+    if (winner != GAME_UNDERWAY) {
+        return (winner == moverWins) ? WIN : LOSS;
+    }
+
+    int moves[POSITION_MAX_EDGES];
+    int numberMoves = candidateMoves(position, moves);
+    if (depth == 0 && numberMoves > 0) {
+        search->horizon = TRUE;
+        return evaluate(position);
+    }
+    for (int i = 1; i < numberMoves; i++) {
+        if (moves[i] == firstMove) {
+            moves[i] = moves[0];
+            moves[0] = firstMove;
+        }
+    }
+
+    int best = LOSS;
+    int bestEdge = -1;
+    for (int i = 0; i < numberMoves && alpha < beta; i++) {
+        int reply;
+        positionMake(position, moves[i]);
+        int value = -negamax(position, search, depth - 1, -beta, -alpha, -1, &reply);
+        positionUnmake(position, moves[i]);
+        if (search->aborted) {
+            return 0;
+        }
+        if (value > best || bestEdge == -1) {
+            best = value;
+            bestEdge = moves[i];
+        }
+        if (value > alpha) {
+            alpha = value;
+        }
+    }
+
+    if (best == WIN || best == LOSS) {
+        entry->key = position->hash;
+        entry->winner = (best == WIN) ? moverWins : SHORT_WINS + CUT_WINS - moverWins;
+        entry->bestEdge = (best == WIN) ? edgeCode(position, bestEdge) : -1;
+    }
+    *bestMove = bestEdge;
+    return best;
+}
+
+/** -------------------------------------------------------------------
+ * Score a position that is not searched any deeper. Short is better
+ * off the fewer edges it still needs, and the more ways there are to
+ * get them. positionDistances() must be called first.
+ * @param position the position; the game must not be over
+ * @return a value between LOSS and WIN for the player to move
+ */
+int evaluate(Position *position) {
+    int distance = position->distStart[position->numberVertices - 1];
+    int score = -DISTANCE_SCORE * distance;
+    for (int e = 0; e < position->numberEdges; e++) {
+        if (position->state[e] == NORMAL_EDGE && positionPathLength(position, e) == distance) {
+            score += PATH_EDGE_SCORE;
+        }
+    }
+    return (position->playerToMove == SHORT_PLAYER) ? score : -score;
+}
+
+/** -------------------------------------------------------------------
+ * List the moves worth searching. Threats of an immediate win decide
+ * most positions without a search:
+ *   - A normal edge between the locked groups of the two terminals
+ *     wins for Short. Cut must cut it, and loses if there are two.
+ *   - A bridge between the terminals wins for Cut. Short must lock it,
+ *     and loses if there are two.
+ * Otherwise every live edge is a move. An edge that is not live is on
+ * no simple path between the terminals, so playing it is a pass, and
+ * a pass is never better than a move (an extra locked edge never hurts
+ * Short, and an extra cut edge never hurts Cut).
+ * positionDistances() must be called first.
+ * @param position the position; the game must not be over
+ * @param moves output: the edge indexes, most critical first
+ * @return the number of moves; 0 if the player to move has lost
+ */
+int candidateMoves(Position *position, int *moves) {
+    int threats = 0;
+    int threat = -1;
+    for (int e = 0; e < position->numberEdges; e++) {
+        if (position->state[e] == NORMAL_EDGE && positionPathLength(position, e) == 1) {
+            threats++;
+            threat = e;
+        }
+    }
+    int bridges[POSITION_MAX_EDGES];
+    int numberBridges = positionBlocks(position, bridges);
+
+    if (position->playerToMove == SHORT_PLAYER) {
+        if (threats > 0 || numberBridges == 1) {
+            moves[0] = (threats > 0) ? threat : bridges[0];
+            return 1;
+        }
+        if (numberBridges > 1) {
+            return 0;
+        }
+    } else {
+        if (numberBridges > 0 || threats == 1) {
+            moves[0] = (numberBridges > 0) ? bridges[0] : threat;
+            return 1;
+        }
+        if (threats > 1) {
+            return 0;
+        }
+    }
+
+    return orderMoves(position, moves);
+}
+
+/** -------------------------------------------------------------------
+ * List the live normal edges, most critical first. Short's moves are
+ * ordered by the length of the shortest path through the edge. Cut
+ * does best near the start, where the paths have not spread out yet,
+ * so Cut's moves are ordered by their distance from the start first.
+ * positionDistances() and positionBlocks() must be called first.
+ * @param position the position
+ * @param moves output: the edge indexes
+ * @return the number of moves
+ */
+int orderMoves(Position *position, int *moves) {
+    int score[POSITION_MAX_EDGES];
+    int count = 0;
+    for (int e = 0; e < position->numberEdges; e++) {
+        if (position->state[e] != NORMAL_EDGE || !position->live[e]) {
+            continue;
+        }
+        int s = positionPathLength(position, e);
+        if (position->playerToMove == CUT_PLAYER) {
+            int u = position->edges[e].fromVertex;
+            int v = position->edges[e].toVertex;
+            int near = (position->distStart[u] < position->distStart[v]) ? position->distStart[u]
+                                                                        : position->distStart[v];
+            s += near * 2 * POSITION_MAX_EDGES;
+        }
+
+        // Insertion sort; there are at most POSITION_MAX_EDGES moves
+        int i = count++;
+        while (i > 0 && score[i-1] > s) {
+            score[i] = score[i-1];
+            moves[i] = moves[i-1];
+            i--;
+        }
+        score[i] = s;
+        moves[i] = e;
+    }
+    return count;
+}
+
+/** -------------------------------------------------------------------
+ * Find the most critical edge, for a position that no search has
+ * found a better move in.
+ * @param position the position
+ * @return the index of the edge, or -1 if the game is over
+ */
+int mostCriticalMove(Position *position) {
+    int moves[POSITION_MAX_EDGES];
+    int bridges[POSITION_MAX_EDGES];
+    if (positionDistances(position) != GAME_UNDERWAY) {
+        return -1;
+    }
+    positionBlocks(position, bridges);
+    return (orderMoves(position, moves) > 0) ? moves[0] : -1;
+}
+
+/** -------------------------------------------------------------------
+ * Get the code of an edge that is the same on every turn.
+ * @param position the position
+ * @param e the index of the edge
+ * @return fromVertex*numberVertices+toVertex
+ */
+int edgeCode(Position *position, int e) {
+    return position->edges[e].fromVertex * position->numberVertices + position->edges[e].toVertex;
+}
@@ -0,0 +1,107 @@
+/** alphaBeta.h
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The definition of an exact game-tree search
+ *          (negamax with alpha-beta pruning and a
+ *          transposition table) for small and mid-size boards.
+ * ===========================================================
+ */
+
+#ifndef ALPHA_BETA_H
+#define ALPHA_BETA_H
+
+#include <windows.h>
+#include "position.h"
+
+// The transposition table has 2^TRANSPOSITION_TABLE_BITS entries
+#define TRANSPOSITION_TABLE_BITS  20
+
+// One solved position. The winner and the best edge are stored in
+// board terms, so an entry stays good from one turn to the next.
+typedef struct transpositionEntry {
+    unsigned long long key;    // The hash of the position, 0 if empty
+    int bestEdge;              // fromVertex*numberVertices+toVertex, or -1
+    int winner;                // SHORT_WINS or CUT_WINS
+} TranspositionEntry;
+
+// A hash table of solved positions. A new entry replaces whatever was
+// in its slot.
+typedef struct transpositionTable {
+    int size;                  // A power of 2
+    TranspositionEntry * entries;
+} TranspositionTable;
+
+// Counters of one search.
+typedef struct alphaBetaStatistics {
+    long long nodes;           // Positions visited
+    long long tableHits;       // Positions answered by the table
+    int depth;                 // The moves looked ahead by the last depth
+                               //   alphaBetaDeepen() finished
+} AlphaBetaStatistics;
+
+/** -------------------------------------------------------------------
+ * Create an empty transposition table.
+ * @param bits the table has 2^bits entries
+ * @return a pointer to a transposition table struct
+ */
+TranspositionTable * tableCreate(int bits);
+
+/** -------------------------------------------------------------------
+ * Delete a transposition table
+ * @param table the table to delete
+ */
+void tableDelete(TranspositionTable *table);
+
+/** -------------------------------------------------------------------
+ * Forget every entry of a transposition table.
+ * @param table the table
+ */
+void tableClear(TranspositionTable *table);
+
+/** -------------------------------------------------------------------
+ * Solve a position exactly with a negamax search. The moves are tried
+ * most critical first: the edges on the shortest paths between the
+ * terminals.
+ * @param position the position; it is the same when the search returns
+ * @param table the transposition table; it can be kept between turns
+ * @param bestMove output: the index of a best edge to play, or -1 if
+ *                 the game is already over
+ * @param statistics output, may be NULL
+ * @return SHORT_WINS or CUT_WINS with perfect play
+ */
+int alphaBetaSolve(Position *position, TranspositionTable *table, int *bestMove,
+                   AlphaBetaStatistics *statistics);
+
+/** -------------------------------------------------------------------
+ * Search a position one move deeper at a time until the time is up
+ * (iterative deepening), keeping the best move of the deepest search
+ * that finished. The search stops early once it reaches the end of the
+ * game on every line.
+ * @param position the position; it is the same when the search returns
+ * @param table the transposition table; it can be kept between turns
+ * @param milliseconds how long to search
+ * @param stop the search also ends once another thread sets *stop to
+ *             TRUE; may be NULL
+ * @param bestMove output: the index of the edge to play, or -1 if the
+ *                 game is already over
+ * @param statistics output, may be NULL
+ * @return SHORT_WINS or CUT_WINS if the search reached the end of the
+ *         game, or GAME_UNDERWAY if the time ran out first
+ */
+int alphaBetaDeepen(Position *position, TranspositionTable *table, int milliseconds,
+                    volatile LONG *stop, int *bestMove, AlphaBetaStatistics *statistics);
+
+/** -------------------------------------------------------------------
+ * List the moves the search tries in a position, most critical first.
+ * Moves that cannot be better than another move are left out.
+ * @param position the position
+ * @param moves output: the edge indexes (up to POSITION_MAX_EDGES)
+ * @return the number of moves; 0 if the game is over or the player to
+ *         move has lost
+ */
+int alphaBetaMoves(Position *position, int *moves);
+
+#endif // ALPHA_BETA_H
@@ -0,0 +1,430 @@
+/** canonical.c
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The implementation of a canonical labeling of
+ *          contracted boards, so that boards that are the same up
+ *          to the numbering of their nodes share one key.
+ * ===========================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "canonical.h"
+
+// The most symmetries kept for skipping nodes
+#define MOST_GENERATORS  16
+
+// Mixed into the key of a position with Short to move
+#define SHORT_TO_MOVE_KEY  0x9E3779B97F4A7C15ULL
+
+// What one labeling shares between the ways down.
+typedef struct labeling {
+    CanonicalGraph * graph;
+    int offsets[CANONICAL_MAX_NODES + 1];  // The neighbors of node v are
+    int neighbors[2 * CANONICAL_MAX_EDGES];//   neighbors[offsets[v]..offsets[v+1]-1]
+    unsigned long long weight[CANONICAL_MAX_NODES]; // A random number for each color
+    int leaves;                            // The numberings tried
+    int bestLabel[CANONICAL_MAX_NODES];    // The numbering with the smallest
+    int bestCode[CANONICAL_MAX_EDGES];     //   sorted list of edges, and the list
+    int firstLabel[CANONICAL_MAX_NODES];   // The first numbering tried, and its
+    int firstCode[CANONICAL_MAX_EDGES];    //   list
+    int numberGenerators;                  // Symmetries found: generator[g][v] is
+    int generator[MOST_GENERATORS][CANONICAL_MAX_NODES]; // where one takes node v
+} Labeling;
+
+// Local functions
+static void search(Labeling *labeling, int *color, int *fixed, int depth);
+static int refine(Labeling *labeling, int *color);
+static void leaf(Labeling *labeling, int *label);
+static void addSymmetry(Labeling *labeling, int *to, int *from);
+static int sameOrbit(Labeling *labeling, int *fixed, int depth, int *tried, int numberTried,
+                     int v);
+static int compareCodes(int *a, int *b, int count);
+static unsigned long long mix(unsigned long long x);
+
+/** -------------------------------------------------------------------
+ * Number the nodes of a board the same way for every copy of it.
+ * @param graph the board
+ * @param label output: the new number of each node. The start keeps 0
+ *              and the end numberNodes-1.
+ * @return the key of the board: the same for every copy of it, and
+ *         different for boards that are not copies but for a 64-bit
+ *         hash collision
+ */
+unsigned long long canonicalLabel(CanonicalGraph *graph, int *label) {
+    Labeling labeling;
+    int n = graph->numberNodes;
+    labeling.graph = graph;
+    labeling.leaves = 0;
+    labeling.numberGenerators = 0;
+
+    // The neighbors of each node, with an edge listed once at each end
+    for (int v = 0; v <= n; v++) {
+        labeling.offsets[v] = 0;
+    }
+    for (int e = 0; e < graph->numberEdges; e++) {
+        labeling.offsets[graph->from[e] + 1]++;
+        labeling.offsets[graph->to[e] + 1]++;
+    }
+    for (int v = 0; v < n; v++) {
+        labeling.offsets[v+1] += labeling.offsets[v];
+    }
+    int next[CANONICAL_MAX_NODES];
+    memcpy(next, labeling.offsets, n * sizeof(int));
+    for (int e = 0; e < graph->numberEdges; e++) {
+        labeling.neighbors[next[graph->from[e]]++] = graph->to[e];
+        labeling.neighbors[next[graph->to[e]]++] = graph->from[e];
+    }
+
+    // A node's color is the place of its class in the numbering: the
+    // start is first, the end last, and the inner nodes in between
+    int color[CANONICAL_MAX_NODES];
+    int fixed[CANONICAL_MAX_NODES];
+    for (int v = 0; v < n; v++) {
+        color[v] = (v == 0) ? 0 : (v == n - 1) ? n - 1 : 1;
+        labeling.weight[v] = mix((unsigned long long) v + 1);
+    }
+    search(&labeling, color, fixed, 0);
+
+    unsigned long long key = mix((unsigned long long) n);
+    for (int e = 0; e < graph->numberEdges; e++) {
+        key = mix(key ^ (unsigned long long) labeling.bestCode[e]);
+    }
+    memcpy(label, labeling.bestLabel, n * sizeof(int));
+    return key;
+}
+
+/** -------------------------------------------------------------------
+ * Make the contracted board of a position: a node for each group of
+ * vertices joined by locked edges, and the live normal edges between
+ * the groups. positionBlocks() must have been called; its scratch
+ * space is used again here.
+ * @param position the position; the game must not be over
+ * @param graph output: the board
+ */
+void canonicalFromPosition(Position *position, CanonicalGraph *graph) {
+    int *group = position->discovered;
+    int *number = position->low;
+    for (int v = 0; v < position->numberVertices; v++) {
+        group[v] = v;
+        number[v] = -1;
+    }
+    for (int e = 0; e < position->numberEdges; e++) {
+        if (position->state[e] == LOCKED_EDGE) {
+            group[findGroup(group, position->edges[e].fromVertex)] =
+                findGroup(group, position->edges[e].toVertex);
+        }
+    }
+
+    // The groups are numbered as the edges reach them, the end last
+    int start = findGroup(group, 0);
+    int end = findGroup(group, position->numberVertices - 1);
+    int count = 1;
+    number[start] = 0;
+    graph->numberEdges = 0;
+    for (int e = 0; e < position->numberEdges; e++) {
+        if (position->state[e] != NORMAL_EDGE || !position->live[e]) {
+            continue;
+        }
+        int u = findGroup(group, position->edges[e].fromVertex);
+        int v = findGroup(group, position->edges[e].toVertex);
+        if (u == v) {
+            continue;
+        }
+        if (number[u] == -1 && u != end) {
+            number[u] = count++;
+        }
+        if (number[v] == -1 && v != end) {
+            number[v] = count++;
+        }
+        graph->from[graph->numberEdges] = u;
+        graph->to[graph->numberEdges] = v;
+        graph->numberEdges++;
+    }
+    number[end] = count++;
+    graph->numberNodes = count;
+    for (int e = 0; e < graph->numberEdges; e++) {
+        graph->from[e] = number[graph->from[e]];
+        graph->to[e] = number[graph->to[e]];
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Get the key of a position that is the same for every position with
+ * a copy of its contracted board and the same player to move.
+ * positionBlocks() must have been called.
+ * @param position the position; the game must not be over
+ * @return the key, never 0
+ */
+unsigned long long canonicalKey(Position *position) {
+    CanonicalGraph graph;
+    int label[CANONICAL_MAX_NODES];
+    canonicalFromPosition(position, &graph);
+    unsigned long long key = canonicalLabel(&graph, label);
+    if (position->playerToMove == SHORT_PLAYER) {
+        key ^= SHORT_TO_MOVE_KEY;
+    }
+    return (key == 0) ? 1 : key;
+}
+
+/** -------------------------------------------------------------------
+ * Refine the classes, then take out each node of the first class that
+ * is left with more than one node in turn, and go on down from there.
+ * A node that a symmetry found so far swaps with a node already taken
+ * out, without moving the nodes taken out above, gives the same list
+ * of edges and is skipped.
+ * @param labeling the labeling
+ * @param color the class of each node; it is refined in place
+ * @param fixed the nodes taken out on the way down
+ * @param depth the number of nodes taken out
+ */
+void search(Labeling *labeling, int *color, int *fixed, int depth) {
+    int n = labeling->graph->numberNodes;
+    if (refine(labeling, color) == n) {
+        leaf(labeling, color);
+        return;
+    }
+
+    // The first class with more than one node
+    int size[CANONICAL_MAX_NODES];
+    for (int c = 0; c < n; c++) {
+        size[c] = 0;
+    }
+    for (int v = 0; v < n; v++) {
+        size[color[v]]++;
+    }
+    int target = n;
+    for (int v = 0; v < n; v++) {
+        if (size[color[v]] > 1 && color[v] < target) {
+            target = color[v];
+        }
+    }
+
+    int tried[CANONICAL_MAX_NODES];
+    int numberTried = 0;
+    for (int v = 0; v < n; v++) {
+        if (color[v] != target) {
+            continue;
+        }
+        if (labeling->leaves >= CANONICAL_MOST_LEAVES) {
+            return;
+        }
+        if (sameOrbit(labeling, fixed, depth, tried, numberTried, v)) {
+            continue;
+        }
+        int child[CANONICAL_MAX_NODES];
+        for (int u = 0; u < n; u++) {
+            child[u] = (color[u] == target && u != v) ? target + 1 : color[u];
+        }
+        fixed[depth] = v;
+        search(labeling, child, fixed, depth + 1);
+        tried[numberTried++] = v;
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Split the classes by the classes of their nodes' neighbors until no
+ * class splits. The nodes of a class are told apart by a hash of the
+ * colors of their neighbors; two nodes with the same hash stay in the
+ * same class, so a collision only makes the search try more nodes.
+ * @param labeling the labeling
+ * @param color the class of each node: the place of its first node in
+ *              the numbering. It is refined in place.
+ * @return the number of classes
+ */
+int refine(Labeling *labeling, int *color) {
+    int n = labeling->graph->numberNodes;
+    int order[CANONICAL_MAX_NODES];
+    unsigned long long signature[CANONICAL_MAX_NODES];
+    char seen[CANONICAL_MAX_NODES];
+    memset(seen, 0, (size_t) n);
+    int classes = 0;
+    for (int v = 0; v < n; v++) {
+        classes += !seen[color[v]];
+        seen[color[v]] = TRUE;
+    }
+    for (;;) {
+        for (int v = 0; v < n; v++) {
+            signature[v] = 0;
+            for (int k = labeling->offsets[v]; k < labeling->offsets[v+1]; k++) {
+                signature[v] += labeling->weight[color[labeling->neighbors[k]]];
+            }
+        }
+
+        // Insertion sort by color, then signature
+        for (int i = 0; i < n; i++) {
+            int v = i;
+            int j = i;
+            while (j > 0 && (color[order[j-1]] > color[v] ||
+                             (color[order[j-1]] == color[v] && signature[order[j-1]] > signature[v]))) {
+                order[j] = order[j-1];
+                j--;
+            }
+            order[j] = v;
+        }
+
+        int count = 0;
+        int first = 0;
+        int newColor[CANONICAL_MAX_NODES];
+        for (int i = 0; i < n; i++) {
+            int v = order[i];
+            if (i == 0 || color[v] != color[order[i-1]] || signature[v] != signature[order[i-1]]) {
+                first = i;
+                count++;
+            }
+            newColor[v] = first;
+        }
+        memcpy(color, newColor, n * sizeof(int));
+        if (count == classes) {
+            return count;
+        }
+        classes = count;
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Score a numbering by its sorted list of edges. Keep it if its list
+ * is the smallest so far; if it gives the same list as the smallest or
+ * the first numbering, the two numbers show a symmetry.
+ * @param labeling the labeling
+ * @param label the number of each node
+ */
+void leaf(Labeling *labeling, int *label) {
+    CanonicalGraph *graph = labeling->graph;
+    int n = graph->numberNodes;
+    int code[CANONICAL_MAX_EDGES];
+    for (int e = 0; e < graph->numberEdges; e++) {
+        int a = label[graph->from[e]];
+        int b = label[graph->to[e]];
+        int c = (a < b) ? a * n + b : b * n + a;
+        int j = e;
+        while (j > 0 && code[j-1] > c) {
+            code[j] = code[j-1];
+            j--;
+        }
+        code[j] = c;
+    }
+
+    size_t labelBytes = n * sizeof(int);
+    size_t codeBytes = graph->numberEdges * sizeof(int);
+    if (labeling->leaves++ == 0) {
+        memcpy(labeling->firstLabel, label, labelBytes);
+        memcpy(labeling->firstCode, code, codeBytes);
+        memcpy(labeling->bestLabel, label, labelBytes);
+        memcpy(labeling->bestCode, code, codeBytes);
+        return;
+    }
+    int best = compareCodes(code, labeling->bestCode, graph->numberEdges);
+    if (best == 0) {
+        addSymmetry(labeling, labeling->bestLabel, label);
+    } else if (compareCodes(code, labeling->firstCode, graph->numberEdges) == 0) {
+        addSymmetry(labeling, labeling->firstLabel, label);
+    }
+    if (best < 0) {
+        memcpy(labeling->bestLabel, label, labelBytes);
+        memcpy(labeling->bestCode, code, codeBytes);
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Keep the symmetry between two numberings that give the same list of
+ * edges: it takes each node to the node the other numbering gives the
+ * same number.
+ * @param labeling the labeling
+ * @param to the numbering the symmetry leads to
+ * @param from the numbering it starts from
+ */
+void addSymmetry(Labeling *labeling, int *to, int *from) {
+    int n = labeling->graph->numberNodes;
+    if (labeling->numberGenerators == MOST_GENERATORS) {
+        return;
+    }
+    int node[CANONICAL_MAX_NODES];
+    for (int v = 0; v < n; v++) {
+        node[to[v]] = v;
+    }
+    int *generator = labeling->generator[labeling->numberGenerators];
+    int moves = FALSE;
+    for (int v = 0; v < n; v++) {
+        generator[v] = node[from[v]];
+        moves |= (generator[v] != v);
+    }
+    if (moves) {
+        labeling->numberGenerators++;
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Tell if a symmetry that leaves the nodes taken out in place takes a
+ * node to one that was already tried.
+ * @param labeling the labeling
+ * @param fixed the nodes taken out on the way down
+ * @param depth the number of nodes taken out
+ * @param tried the nodes tried in this class
+ * @param numberTried the number of them
+ * @param v the node
+ * @return TRUE if v can be skipped
+ */
+int sameOrbit(Labeling *labeling, int *fixed, int depth, int *tried, int numberTried, int v) {
+    if (numberTried == 0 || labeling->numberGenerators == 0) {
+        return FALSE;
+    }
+    int n = labeling->graph->numberNodes;
+    int parent[CANONICAL_MAX_NODES];
+    for (int u = 0; u < n; u++) {
+        parent[u] = u;
+    }
+    for (int g = 0; g < labeling->numberGenerators; g++) {
+        int *generator = labeling->generator[g];
+        int keeps = TRUE;
+        for (int d = 0; d < depth && keeps; d++) {
+            keeps = (generator[fixed[d]] == fixed[d]);
+        }
+        if (keeps) {
+            for (int u = 0; u < n; u++) {
+                parent[findGroup(parent, u)] = findGroup(parent, generator[u]);
+            }
+        }
+    }
+    int orbit = findGroup(parent, v);
+    for (int i = 0; i < numberTried; i++) {
+        if (findGroup(parent, tried[i]) == orbit) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/** -------------------------------------------------------------------
+ * Compare two sorted lists of edges.
+ * @param a a list
+ * @param b another, as long
+ * @param count their length
+ * @return less than, equal to or greater than 0 as a is smaller than,
+ *         the same as or larger than b
+ */
+int compareCodes(int *a, int *b, int count) {
+    for (int i = 0; i < count; i++) {
+        if (a[i] != b[i]) {
+            return a[i] - b[i];
+        }
+    }
+    return 0;
+}
+
+/** -------------------------------------------------------------------
+ * Scramble the bits of a number (the finalizer of splitmix64).
+ * @param x the number
+ * @return the scrambled number
+ */
+unsigned long long mix(unsigned long long x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
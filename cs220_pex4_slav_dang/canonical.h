@@ -0,0 +1,81 @@
+/** canonical.h
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The definition of a canonical labeling of contracted
+ *          boards, so that boards that are the same up to the
+ *          numbering of their nodes share one key.
+ * ===========================================================
+ */
+
+#ifndef CANONICAL_H
+#define CANONICAL_H
+
+#include "position.h"
+
+// The most nodes and edges of a board. A board made from a position has
+// at most one node more than it has edges.
+#define CANONICAL_MAX_EDGES  POSITION_MAX_EDGES
+#define CANONICAL_MAX_NODES  (CANONICAL_MAX_EDGES + 1)
+
+// The search for the smallest numbering stops after this many, and
+// keeps the smallest so far
+#define CANONICAL_MOST_LEAVES  2000
+
+// Two boards whose nodes are numbered differently can still be the same
+// board, and then they have the same winner. Numbering the nodes of
+// every board the same way (a canonical labeling) gives the copies the
+// same key, so a table entry found for one is found for all of them.
+//
+// The labeling works the way nauty does. The nodes start in three
+// classes (the start, the inner nodes and the end), and a class is
+// split by how many edges its nodes have to each other class until no
+// class splits any more (color refinement). If a class still holds
+// more than one node, each of its nodes in turn is taken out into a
+// class of its own (individualization) and the classes are refined
+// again. Every way down gives a numbering, and the one that gives the
+// smallest sorted list of edges is the canonical one. Two ways down
+// that give the same list show a symmetry of the board, and the nodes
+// a symmetry swaps are not tried again.
+
+// A contracted board: node 0 holds the start and node numberNodes-1
+// the end. There may be more than one edge between two nodes.
+typedef struct canonicalGraph {
+    int numberNodes;
+    int numberEdges;
+    int from[CANONICAL_MAX_EDGES];
+    int to[CANONICAL_MAX_EDGES];
+} CanonicalGraph;
+
+/** -------------------------------------------------------------------
+ * Number the nodes of a board the same way for every copy of it.
+ * @param graph the board
+ * @param label output: the new number of each node. The start keeps 0
+ *              and the end numberNodes-1.
+ * @return the key of the board: the same for every copy of it, and
+ *         different for boards that are not copies but for a 64-bit
+ *         hash collision
+ */
+unsigned long long canonicalLabel(CanonicalGraph *graph, int *label);
+
+/** -------------------------------------------------------------------
+ * Make the contracted board of a position: a node for each group of
+ * vertices joined by locked edges, and the live normal edges between
+ * the groups. positionBlocks() must have been called.
+ * @param position the position; the game must not be over
+ * @param graph output: the board
+ */
+void canonicalFromPosition(Position *position, CanonicalGraph *graph);
+
+/** -------------------------------------------------------------------
+ * Get the key of a position that is the same for every position with
+ * a copy of its contracted board and the same player to move.
+ * positionBlocks() must have been called.
+ * @param position the position; the game must not be over
+ * @return the key, never 0
+ */
+unsigned long long canonicalKey(Position *position);
+
+#endif // CANONICAL_H
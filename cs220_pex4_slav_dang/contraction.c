@@ -0,0 +1,650 @@
+/** contraction.c
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The implementation of the contracted board, which
+ *          merges the vertices joined by locked edges and keeps
+ *          it up to date after each move.
+ * ===========================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "contraction.h"
+
+// Local functions
+static void build(Contraction *contraction, Graph *graph);
+static void joinGroups(Contraction *contraction, int a, int b);
+static int walkGroups(Contraction *contraction, Graph *graph, Edge *edges, int *numberEdges,
+                      int stopAtEnd);
+static void keepPath(Contraction *contraction, Graph *graph);
+static void findBlocks(Contraction *contraction, Graph *graph);
+static void markBlock(Contraction *contraction, int r, int block);
+static int shareBlock(Contraction *contraction, int a, int b);
+
+/** -------------------------------------------------------------------
+ * Create a contracted board. It is built from the board on the first
+ * query.
+ * @param numberVertices the most vertices a board can have
+ * @return a pointer to a contraction struct
+ */
+Contraction * contractionCreate(int numberVertices) {
+    Contraction *contraction = malloc(sizeof(Contraction));
+    contraction->graph = NULL;
+    contraction->capacity = numberVertices;
+    contraction->arcCapacity = 0;
+    contraction->valid = FALSE;
+    contraction->group = malloc(numberVertices * sizeof(int));
+    contraction->size = malloc(numberVertices * sizeof(int));
+    contraction->firstArc = malloc(numberVertices * sizeof(int));
+    contraction->lastArc = malloc(numberVertices * sizeof(int));
+    contraction->nextArc = NULL;
+    contraction->arcVertex = NULL;
+    contraction->pathValid = FALSE;
+    contraction->pathTo = malloc(numberVertices * sizeof(int));
+    contraction->pathVertices = malloc(numberVertices * sizeof(int));
+    contraction->pathLength = 0;
+    contraction->liveValid = FALSE;
+    contraction->numberBridges = 0;
+    contraction->firstBlock = malloc(numberVertices * sizeof(int));
+    contraction->secondBlock = malloc(numberVertices * sizeof(int));
+    contraction->analyzed = malloc((size_t) numberVertices);
+    memset(&contraction->live, 0, sizeof(LiveStatistics));
+    contraction->node = malloc(numberVertices * sizeof(int));
+    contraction->generation = 0;
+    contraction->reached = calloc((size_t) numberVertices, sizeof(unsigned int));
+    contraction->parentArc = malloc(numberVertices * sizeof(int));
+    contraction->queue = malloc(numberVertices * sizeof(int));
+    contraction->discovered = malloc(numberVertices * sizeof(int));
+    contraction->low = malloc(numberVertices * sizeof(int));
+    contraction->cursor = malloc(numberVertices * sizeof(int));
+    contraction->stack = malloc(numberVertices * sizeof(int));
+    contraction->holdsEnd = malloc((size_t) numberVertices);
+    contraction->edgeStack = NULL;
+    contraction->numberGroups = 0;
+    contraction->numberArcs = 0;
+    contraction->numberNodes = 0;
+
+    if (contraction->group == NULL || contraction->holdsEnd == NULL) {
+        printf("ERROR in contractionCreate. Not enough memory for %d vertices.\n", numberVertices);
+        exit(1);
+    }
+    return contraction;
+}
+
+/** -------------------------------------------------------------------
+ * Delete a contracted board
+ * @param contraction the contracted board to delete
+ */
+void contractionDelete(Contraction *contraction) {
+    free(contraction->group);
+    free(contraction->size);
+    free(contraction->firstArc);
+    free(contraction->lastArc);
+    free(contraction->nextArc);
+    free(contraction->arcVertex);
+    free(contraction->pathTo);
+    free(contraction->pathVertices);
+    free(contraction->firstBlock);
+    free(contraction->secondBlock);
+    free(contraction->analyzed);
+    free(contraction->node);
+    free(contraction->reached);
+    free(contraction->parentArc);
+    free(contraction->queue);
+    free(contraction->discovered);
+    free(contraction->low);
+    free(contraction->cursor);
+    free(contraction->stack);
+    free(contraction->holdsEnd);
+    free(contraction->edgeStack);
+    free(contraction);
+}
+
+/** -------------------------------------------------------------------
+ * Update the groups after a move. Call it after the edge state has
+ * been changed on the board.
+ * @param contraction the contracted board
+ * @param graph the board
+ * @param fromVertex one end of the edge
+ * @param toVertex the other end of the edge
+ * @param state the new state of the edge
+ */
+void contractionObserve(Contraction *contraction, Graph *graph, int fromVertex, int toVertex,
+                        int state) {
+    if (!contraction->valid || contraction->graph != graph) {
+        return; // It is built from scratch on the next query anyway
+    }
+    if (contraction->liveValid && state != NORMAL_EDGE) {
+        int a = findGroup(contraction->group, fromVertex);
+        int b = findGroup(contraction->group, toVertex);
+        if (a != b && shareBlock(contraction, a, b)) {
+            contraction->liveValid = FALSE;
+        } else if (a != b && contraction->analyzed[a]) {
+            // A dead edge, so the live blocks are still the same
+            contraction->live.normalEdges--;
+            contraction->live.deadMoves++;
+        }
+    }
+    if (state == LOCKED_EDGE) {
+        joinGroups(contraction, fromVertex, toVertex);
+    } else if (state == NO_EDGE) {
+        // Its arcs go stale and are dropped when they are next seen
+        if (contraction->pathTo[fromVertex] == toVertex ||
+            contraction->pathTo[toVertex] == fromVertex) {
+            contraction->pathValid = FALSE;
+        }
+    } else {
+        // An edge came back; its arcs may already have been dropped
+        contraction->valid = FALSE;
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Work out if the game is over. Short has won if the terminals are in
+ * the same group, and Cut has won if no normal edges lead from the
+ * group of the start to the group of the end.
+ * @param contraction the contracted board
+ * @param graph the board
+ * @return SHORT_WINS, CUT_WINS or GAME_UNDERWAY
+ */
+int contractionWinner(Contraction *contraction, Graph *graph) {
+    if (!contraction->valid || contraction->graph != graph) {
+        build(contraction, graph);
+    }
+    int end = graph->numberVertices - 1;
+    if (findGroup(contraction->group, 0) == findGroup(contraction->group, end)) {
+        return SHORT_WINS;
+    }
+    if (!contraction->pathValid) {
+        walkGroups(contraction, graph, NULL, NULL, TRUE);
+        if (contraction->reached[findGroup(contraction->group, end)] != contraction->generation) {
+            return CUT_WINS;
+        }
+        keepPath(contraction, graph);
+    }
+    return GAME_UNDERWAY;
+}
+
+/** -------------------------------------------------------------------
+ * Find the live edges, unless no live edge was played since they were
+ * last found. contraction->live holds the counts.
+ * @param contraction the contracted board
+ * @param graph the board
+ * @return the number of live edges; 0 if the game is over
+ */
+int contractionLive(Contraction *contraction, Graph *graph) {
+    if (!contraction->valid || contraction->graph != graph) {
+        build(contraction, graph);
+    }
+    if (!contraction->liveValid) {
+        findBlocks(contraction, graph);
+    }
+    return contraction->live.liveEdges;
+}
+
+/** -------------------------------------------------------------------
+ * Tell if an edge is live: it is normal, and on a simple path between
+ * the terminals.
+ * @param contraction the contracted board
+ * @param graph the board
+ * @param fromVertex one end of the edge
+ * @param toVertex the other end of the edge
+ * @return TRUE if the edge is live
+ */
+int contractionIsLive(Contraction *contraction, Graph *graph, int fromVertex, int toVertex) {
+    contractionLive(contraction, graph);
+    if (graphGetEdge(graph, fromVertex, toVertex) != NORMAL_EDGE) {
+        return FALSE;
+    }
+    int a = findGroup(contraction->group, fromVertex);
+    int b = findGroup(contraction->group, toVertex);
+    return a != b && shareBlock(contraction, a, b);
+}
+
+/** -------------------------------------------------------------------
+ * Work out if the game is decided. On top of contractionWinner(), Cut
+ * has won if there is a bridge and Cut is to move, or if there are two
+ * bridges; Short has won if the only live edge is a bridge and Short
+ * is to move.
+ * @param contraction the contracted board
+ * @param graph the board
+ * @param playerToMove Either CUT_PLAYER or SHORT_PLAYER
+ * @return SHORT_WINS, CUT_WINS or GAME_UNDERWAY
+ */
+int contractionDecided(Contraction *contraction, Graph *graph, int playerToMove) {
+    int winner = contractionWinner(contraction, graph);
+    if (winner != GAME_UNDERWAY) {
+        return winner;
+    }
+    int liveEdges = contractionLive(contraction, graph);
+    int bridges = contraction->numberBridges;
+    if (bridges >= 2 || (bridges == 1 && playerToMove == CUT_PLAYER)) {
+        return CUT_WINS;
+    }
+    if (bridges == 1 && liveEdges == 1) {
+        return SHORT_WINS; // Short locks the last edge
+    }
+    return GAME_UNDERWAY;
+}
+
+/** -------------------------------------------------------------------
+ * Find a move that cannot wait: a bridge, which Cut wins by cutting
+ * and Short must lock.
+ * @param contraction the contracted board
+ * @param graph the board
+ * @param edge output: the bridge
+ * @return TRUE if there is a bridge
+ */
+int contractionForcedMove(Contraction *contraction, Graph *graph, Edge *edge) {
+    contractionLive(contraction, graph);
+    if (contraction->numberBridges == 0) {
+        return FALSE;
+    }
+    *edge = contraction->bridge;
+    return TRUE;
+}
+
+/** -------------------------------------------------------------------
+ * Number the groups that can still be reached from the start, and list
+ * the normal edges between them. The group of the start is node 0 and
+ * the group of the end is node numberNodes-1 (if it can be reached);
+ * contraction->node[v] is the node of vertex v, or -1 if it cannot be
+ * reached.
+ * @param contraction the contracted board
+ * @param graph the board
+ * @param edges output: the edges, as vertices of the board; it must
+ *              hold graphNumberEdges(graph) edges
+ * @param numberEdges output: the number of edges
+ * @return the number of nodes
+ */
+int contractionNumber(Contraction *contraction, Graph *graph, Edge *edges, int *numberEdges) {
+    if (!contraction->valid || contraction->graph != graph) {
+        build(contraction, graph);
+    }
+    int n = graph->numberVertices;
+    int *node = contraction->node;
+    int numberNodes = walkGroups(contraction, graph, edges, numberEdges, FALSE);
+
+    // The groups are numbered in the order they were reached, except
+    // that the group of the end swaps places with the last one
+    for (int v = 0; v < n; v++) {
+        node[v] = -1;
+    }
+    for (int i = 0; i < numberNodes; i++) {
+        node[contraction->queue[i]] = i;
+    }
+    int end = findGroup(contraction->group, n - 1);
+    if (node[end] != -1) {
+        node[contraction->queue[numberNodes - 1]] = node[end];
+        node[end] = numberNodes - 1;
+    }
+
+    // Each root holds the node of its group; pass it on to the rest
+    for (int v = 0; v < n; v++) {
+        node[v] = node[findGroup(contraction->group, v)];
+    }
+    contraction->numberNodes = numberNodes;
+    return numberNodes;
+}
+
+/** -------------------------------------------------------------------
+ * Build the groups and their arcs from the board.
+ * @param contraction the contracted board
+ * @param graph the board
+ */
+void build(Contraction *contraction, Graph *graph) {
+    int n = graph->numberVertices;
+    if (n > contraction->capacity) {
+        printf("ERROR in contraction. The board has %d vertices, it holds %d.\n", n,
+               contraction->capacity);
+        exit(1);
+    }
+    int arcs = 2 * graphNumberEdges(graph);
+    if (arcs > contraction->arcCapacity) {
+        free(contraction->nextArc);
+        free(contraction->arcVertex);
+        contraction->arcCapacity = arcs;
+        free(contraction->edgeStack);
+        contraction->nextArc = malloc(arcs * sizeof(int));
+        contraction->arcVertex = malloc(arcs * sizeof(int));
+        contraction->edgeStack = malloc((arcs / 2 + 1) * sizeof(int));
+    }
+
+    contraction->graph = graph;
+    contraction->numberGroups = n;
+    contraction->numberArcs = 0;
+    contraction->pathValid = FALSE;
+    contraction->pathLength = 0;
+    contraction->liveValid = FALSE;
+    contraction->numberBridges = 0;
+    memset(&contraction->live, 0, sizeof(LiveStatistics));
+    for (int v = 0; v < n; v++) {
+        contraction->pathTo[v] = -1;
+        contraction->group[v] = v;
+        contraction->size[v] = 1;
+        contraction->firstArc[v] = -1;
+        contraction->lastArc[v] = -1;
+    }
+
+    // Every normal edge gets an arc at each end, in the list of that end
+    for (int u = 0; u < n; u++) {
+        for (int j = 0; j < graph->degree[u]; j++) {
+            int v = graph->neighbors[u][j];
+            if (u < v && graphGetEdge(graph, u, v) == NORMAL_EDGE) {
+                int a = contraction->numberArcs;
+                contraction->numberArcs += 2;
+                contraction->arcVertex[a] = u;
+                contraction->arcVertex[a+1] = v;
+                for (int end = a; end <= a + 1; end++) {
+                    int x = contraction->arcVertex[end];
+                    contraction->nextArc[end] = -1;
+                    if (contraction->firstArc[x] == -1) {
+                        contraction->firstArc[x] = end;
+                    } else {
+                        contraction->nextArc[contraction->lastArc[x]] = end;
+                    }
+                    contraction->lastArc[x] = end;
+                }
+            }
+        }
+    }
+    contraction->valid = TRUE;
+
+    // The locked edges join their ends
+    for (int u = 0; u < n; u++) {
+        for (int j = 0; j < graph->degree[u]; j++) {
+            int v = graph->neighbors[u][j];
+            if (u < v && graphGetEdge(graph, u, v) == LOCKED_EDGE) {
+                joinGroups(contraction, u, v);
+            }
+        }
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Join the groups of two vertices, and their lists of arcs.
+ * @param contraction the contracted board
+ * @param a a vertex
+ * @param b another vertex
+ */
+void joinGroups(Contraction *contraction, int a, int b) {
+    a = findGroup(contraction->group, a);
+    b = findGroup(contraction->group, b);
+    if (a == b) {
+        return;
+    }
+    if (contraction->size[a] < contraction->size[b]) {
+        int swap = a;
+        a = b;
+        b = swap;
+    }
+    contraction->group[b] = a;
+    contraction->size[a] += contraction->size[b];
+    contraction->numberGroups--;
+
+    // If the edge was dead, at most one side is in live blocks
+    if (contraction->firstBlock[a] == -1) {
+        contraction->firstBlock[a] = contraction->firstBlock[b];
+        contraction->secondBlock[a] = contraction->secondBlock[b];
+    }
+    contraction->analyzed[a] |= contraction->analyzed[b];
+
+    if (contraction->firstArc[b] != -1) {
+        if (contraction->firstArc[a] == -1) {
+            contraction->firstArc[a] = contraction->firstArc[b];
+        } else {
+            contraction->nextArc[contraction->lastArc[a]] = contraction->firstArc[b];
+        }
+        contraction->lastArc[a] = contraction->lastArc[b];
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Search the groups breadth first from the group of the start, over
+ * the normal edges, and drop the stale arcs on the way. The roots of
+ * the groups that are reached are put in contraction->queue[] in the
+ * order they were reached, and marked in contraction->reached[].
+ * @param contraction the contracted board; it must be built
+ * @param graph the board
+ * @param edges output, may be NULL: the edges between the groups that
+ *              were reached, each once
+ * @param numberEdges output, may be NULL: the number of those edges
+ * @param stopAtEnd TRUE to stop once the group of the end is reached
+ * @return the number of groups reached
+ */
+int walkGroups(Contraction *contraction, Graph *graph, Edge *edges, int *numberEdges,
+               int stopAtEnd) {
+    int *group = contraction->group;
+    unsigned int *reached = contraction->reached;
+    int *queue = contraction->queue;
+    int n = graph->numberVertices;
+    contraction->generation++;
+    if (contraction->generation == 0) {
+        // The stamps wrapped around, so old stamps could look current
+        memset(reached, 0, contraction->capacity * sizeof(unsigned int));
+        contraction->generation = 1;
+    }
+    unsigned int generation = contraction->generation;
+    if (numberEdges != NULL) {
+        *numberEdges = 0;
+    }
+
+    int end = findGroup(group, n - 1);
+    int head = 0;
+    int tail = 0;
+    queue[tail] = findGroup(group, 0);
+    reached[queue[tail]] = generation;
+    tail++;
+    while (head < tail) {
+        int r = queue[head++];
+        if (stopAtEnd && r == end) {
+            break;
+        }
+
+        int previous = -1;
+        for (int a = contraction->firstArc[r]; a != -1; a = contraction->nextArc[a]) {
+            int u = contraction->arcVertex[a];
+            int v = contraction->arcVertex[a ^ 1];
+            int s = findGroup(group, v);
+            if (s == r || graphGetEdge(graph, u, v) != NORMAL_EDGE) {
+                // Stale: unlink it, and keep walking from the same place
+                if (previous == -1) {
+                    contraction->firstArc[r] = contraction->nextArc[a];
+                } else {
+                    contraction->nextArc[previous] = contraction->nextArc[a];
+                }
+                if (contraction->lastArc[r] == a) {
+                    contraction->lastArc[r] = previous;
+                }
+                continue;
+            }
+            previous = a;
+
+            if (reached[s] != generation) {
+                reached[s] = generation;
+                contraction->parentArc[s] = a;
+                queue[tail++] = s;
+            }
+            // Both ends of an edge are walked; count it at its even arc
+            if (numberEdges != NULL && (a & 1) == 0) {
+                if (edges != NULL) {
+                    edges[*numberEdges].fromVertex = u;
+                    edges[*numberEdges].toVertex = v;
+                }
+                (*numberEdges)++;
+            }
+        }
+    }
+    return tail;
+}
+
+/** -------------------------------------------------------------------
+ * Remember the path to the group of the end that walkGroups() found.
+ * @param contraction the contracted board; the group of the end must
+ *                    have been reached by the last walk
+ * @param graph the board
+ */
+void keepPath(Contraction *contraction, Graph *graph) {
+    for (int i = 0; i < contraction->pathLength; i++) {
+        contraction->pathTo[contraction->pathVertices[i]] = -1;
+    }
+    contraction->pathLength = 0;
+
+    int start = findGroup(contraction->group, 0);
+    int r = findGroup(contraction->group, graph->numberVertices - 1);
+    while (r != start) {
+        int a = contraction->parentArc[r];
+        int u = contraction->arcVertex[a];
+        contraction->pathTo[u] = contraction->arcVertex[a ^ 1];
+        contraction->pathVertices[contraction->pathLength++] = u;
+        r = findGroup(contraction->group, u);
+    }
+    contraction->pathValid = TRUE;
+}
+
+/** -------------------------------------------------------------------
+ * Split the groups that can be reached from the start into blocks,
+ * mark the groups of the live blocks, and count the bridges. This is
+ * Tarjan's algorithm, as in positionBlocks(), on the contracted board:
+ * a depth-first search keeps the edges it meets on a stack, and when
+ * nothing below a child reaches back above its parent, the edges down
+ * to the child's tree edge form a block. The block is live if the end
+ * is below the child. Parallel edges are different arcs, so only the
+ * tree arc itself is skipped.
+ * @param contraction the contracted board; it must be built
+ * @param graph the board
+ */
+void findBlocks(Contraction *contraction, Graph *graph) {
+    int n = graph->numberVertices;
+    int *group = contraction->group;
+    int *discovered = contraction->discovered;
+    int *low = contraction->low;
+    int *parentArc = contraction->parentArc;
+    int *cursor = contraction->cursor;
+    int *stack = contraction->stack;
+    for (int v = 0; v < n; v++) {
+        contraction->firstBlock[v] = -1;
+        contraction->secondBlock[v] = -1;
+        contraction->analyzed[v] = FALSE;
+    }
+
+    // The walk drops every stale arc of the groups it reaches
+    int reached = walkGroups(contraction, graph, NULL, &contraction->live.normalEdges, FALSE);
+    for (int i = 0; i < reached; i++) {
+        discovered[contraction->queue[i]] = -1;
+        contraction->analyzed[contraction->queue[i]] = TRUE;
+    }
+    contraction->live.liveEdges = 0;
+    contraction->live.analyses++;
+    contraction->numberBridges = 0;
+    contraction->liveValid = TRUE;
+
+    int start = findGroup(group, 0);
+    int end = findGroup(group, n - 1);
+    if (start == end || !contraction->analyzed[end]) {
+        return; // The game is over, so every edge is dead
+    }
+
+    int blocks = 0;
+    int edgeTop = 0;
+    int time = 0;
+    int top = 0;
+    stack[0] = start;
+    discovered[start] = low[start] = time++;
+    parentArc[start] = -1;
+    cursor[start] = contraction->firstArc[start];
+    contraction->holdsEnd[start] = FALSE;
+    while (top >= 0) {
+        int x = stack[top];
+        if (cursor[x] != -1) {
+            int a = cursor[x];
+            cursor[x] = contraction->nextArc[a];
+            if (parentArc[x] != -1 && a == (parentArc[x] ^ 1)) {
+                continue; // The tree edge back to the parent
+            }
+            int y = findGroup(group, contraction->arcVertex[a ^ 1]);
+            if (discovered[y] == -1) {
+                discovered[y] = low[y] = time++;
+                parentArc[y] = a;
+                cursor[y] = contraction->firstArc[y];
+                contraction->holdsEnd[y] = (y == end);
+                stack[++top] = y;
+                contraction->edgeStack[edgeTop++] = a;
+            } else if (discovered[y] < discovered[x]) {
+                contraction->edgeStack[edgeTop++] = a; // An edge back to an ancestor
+                if (discovered[y] < low[x]) {
+                    low[x] = discovered[y];
+                }
+            }
+        } else {
+            // x is finished; report to its parent
+            top--;
+            if (top >= 0) {
+                int p = stack[top];
+                if (low[x] < low[p]) {
+                    low[p] = low[x];
+                }
+                if (low[x] >= discovered[p]) {
+                    // The edges down to x's tree edge form a block
+                    int size = 0;
+                    int f;
+                    do {
+                        f = contraction->edgeStack[--edgeTop];
+                        size++;
+                        if (contraction->holdsEnd[x]) {
+                            markBlock(contraction, findGroup(group, contraction->arcVertex[f]), blocks);
+                            markBlock(contraction, findGroup(group, contraction->arcVertex[f ^ 1]),
+                                      blocks);
+                            contraction->live.liveEdges++;
+                        }
+                    } while (f != parentArc[x]);
+                    if (contraction->holdsEnd[x]) {
+                        blocks++;
+                        if (size == 1) {
+                            contraction->bridge.fromVertex = contraction->arcVertex[f];
+                            contraction->bridge.toVertex = contraction->arcVertex[f ^ 1];
+                            contraction->numberBridges++;
+                        }
+                    }
+                }
+                if (contraction->holdsEnd[x]) {
+                    contraction->holdsEnd[p] = TRUE;
+                }
+            }
+        }
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Put a group in a live block.
+ * @param contraction the contracted board
+ * @param r the root of the group
+ * @param block the number of the block
+ */
+void markBlock(Contraction *contraction, int r, int block) {
+    if (contraction->firstBlock[r] == -1) {
+        contraction->firstBlock[r] = block;
+    } else if (contraction->firstBlock[r] != block) {
+        contraction->secondBlock[r] = block;
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Tell if two groups are in the same live block. An edge whose ends
+ * are both in a block is in that block, so this tells if it is live.
+ * @param contraction the contracted board; its blocks must be found
+ * @param a the root of one group
+ * @param b the root of the other group
+ * @return TRUE if they share a live block
+ */
+int shareBlock(Contraction *contraction, int a, int b) {
+    int a1 = contraction->firstBlock[a];
+    int a2 = contraction->secondBlock[a];
+    int b1 = contraction->firstBlock[b];
+    int b2 = contraction->secondBlock[b];
+    return (a1 != -1 && (a1 == b1 || a1 == b2)) || (a2 != -1 && (a2 == b1 || a2 == b2));
+}
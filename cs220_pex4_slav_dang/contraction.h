@@ -0,0 +1,201 @@
+/** contraction.h
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The definition of the contracted board, which merges
+ *          the vertices joined by locked edges and keeps it up
+ *          to date after each move.
+ * ===========================================================
+ */
+
+#ifndef CONTRACTION_H
+#define CONTRACTION_H
+
+#include "Graph.h"
+#include "gameLogic.h"
+
+// Once Short locks an edge its two ends are as good as one vertex, and
+// once Cut removes an edge it is gone. The contracted board keeps the
+// vertices joined by locked edges as one group (a union-find), and the
+// normal edges between groups as a multigraph, so it shrinks as the
+// game goes on.
+//
+// Each arc is one end of a normal edge, and sits in the list of the
+// group at that end. Locking an edge joins two groups and their lists
+// in O(1). Cutting an edge does nothing at once: an arc whose edge was
+// cut, or whose two ends ended up in the same group, is stale and is
+// dropped from its list the next time the list is walked.
+//
+// The game is over for Cut once no path of normal edges joins the group
+// of the start to the group of the end. The last path found stays good
+// until one of its edges is cut (a lock only merges groups along it),
+// so most moves need no search at all.
+//
+// Many normal edges are on no simple path between the terminals, for
+// example the edges of a dead end. Playing one is the same as passing,
+// so no player needs to consider them. The blocks (biconnected
+// components) of the groups form a block-cut tree, and the live edges
+// are the ones in the blocks on its path from the start to the end.
+// The other edges are dead, and stay dead for the rest of the game.
+// Playing a dead edge leaves the live blocks as they were, so the
+// blocks are only found again after a live edge is played.
+//
+// A live block with a single edge is a bridge: every path between the
+// terminals crosses it. Cut wins by cutting any bridge, so Short must
+// lock one at once, and two bridges are a win for Cut whoever moves.
+
+// How much the dead edges shrink the choice of moves.
+typedef struct liveStatistics {
+    int normalEdges;        // The normal edges between the groups that
+                            //   can be reached from the start
+    int liveEdges;          // The ones that are live
+    int analyses;           // The times the blocks were found
+    int deadMoves;          // The moves on dead edges, which kept them
+} LiveStatistics;
+
+typedef struct contraction {
+    Graph * graph;          // The board the groups belong to
+    int capacity;           // The number of vertices the buffers hold
+    int arcCapacity;        // The number of arcs the buffers hold
+    int valid;              // FALSE until built from the board, or
+                            //   after a change it cannot follow
+    int * group;            // Union-find of the vertices joined by
+    int * size;             //   locked edges, by size
+    int numberGroups;
+
+    // The arcs of group r are firstArc[r], nextArc[firstArc[r]], ...
+    // Arcs 2k and 2k+1 are the two ends of the same edge.
+    int * firstArc;         // -1 if the group has no arcs
+    int * lastArc;
+    int * nextArc;          // -1 at the end of a list
+    int * arcVertex;        // The vertex at this end of the arc
+    int numberArcs;
+
+    // The path from the group of the start to the group of the end
+    int pathValid;          // FALSE if it must be searched for again
+    int * pathTo;           // pathTo[u] == v if the path leaves the group
+                            //   of u by the edge u-v, and -1 if not
+    int * pathVertices;     // The vertices u with pathTo[u] != -1
+    int pathLength;
+
+    // The live blocks, numbered from the end, filled by contractionLive()
+    int liveValid;          // FALSE if the blocks must be found again
+    int * firstBlock;       // The live blocks the group of each root is
+    int * secondBlock;      //   in, or -1; only a cut vertex is in two
+    char * analyzed;        // TRUE if the group could be reached
+    int numberBridges;      // The live blocks with a single edge
+    Edge bridge;            // One of them, if there are any
+    LiveStatistics live;
+
+    // Filled by contractionNumber()
+    int * node;             // The node of the group of each vertex
+    int numberNodes;
+
+    unsigned int generation; // Scratch space of the search
+    unsigned int * reached;  // == generation if the group was reached
+    int * parentArc;         // The arc the group was reached by
+    int * queue;
+    int * discovered;        // Scratch space of the block search
+    int * low;
+    int * cursor;
+    int * stack;
+    char * holdsEnd;
+    int * edgeStack;         // One arc of each edge
+} Contraction;
+
+/** -------------------------------------------------------------------
+ * Create a contracted board. It is built from the board on the first
+ * query.
+ * @param numberVertices the most vertices a board can have
+ * @return a pointer to a contraction struct
+ */
+Contraction * contractionCreate(int numberVertices);
+
+/** -------------------------------------------------------------------
+ * Delete a contracted board
+ * @param contraction the contracted board to delete
+ */
+void contractionDelete(Contraction *contraction);
+
+/** -------------------------------------------------------------------
+ * Update the groups after a move. Call it after the edge state has
+ * been changed on the board.
+ * @param contraction the contracted board
+ * @param graph the board
+ * @param fromVertex one end of the edge
+ * @param toVertex the other end of the edge
+ * @param state the new state of the edge
+ */
+void contractionObserve(Contraction *contraction, Graph *graph, int fromVertex, int toVertex,
+                        int state);
+
+/** -------------------------------------------------------------------
+ * Work out if the game is over. Short has won if the terminals are in
+ * the same group, and Cut has won if no normal edges lead from the
+ * group of the start to the group of the end.
+ * @param contraction the contracted board
+ * @param graph the board
+ * @return SHORT_WINS, CUT_WINS or GAME_UNDERWAY
+ */
+int contractionWinner(Contraction *contraction, Graph *graph);
+
+/** -------------------------------------------------------------------
+ * Find the live edges, unless no live edge was played since they were
+ * last found. contraction->live holds the counts.
+ * @param contraction the contracted board
+ * @param graph the board
+ * @return the number of live edges; 0 if the game is over
+ */
+int contractionLive(Contraction *contraction, Graph *graph);
+
+/** -------------------------------------------------------------------
+ * Tell if an edge is live: it is normal, and on a simple path between
+ * the terminals.
+ * @param contraction the contracted board
+ * @param graph the board
+ * @param fromVertex one end of the edge
+ * @param toVertex the other end of the edge
+ * @return TRUE if the edge is live
+ */
+int contractionIsLive(Contraction *contraction, Graph *graph, int fromVertex, int toVertex);
+
+/** -------------------------------------------------------------------
+ * Work out if the game is decided. On top of contractionWinner(), Cut
+ * has won if there is a bridge and Cut is to move, or if there are two
+ * bridges; Short has won if the only live edge is a bridge and Short
+ * is to move.
+ * @param contraction the contracted board
+ * @param graph the board
+ * @param playerToMove Either CUT_PLAYER or SHORT_PLAYER
+ * @return SHORT_WINS, CUT_WINS or GAME_UNDERWAY
+ */
+int contractionDecided(Contraction *contraction, Graph *graph, int playerToMove);
+
+/** -------------------------------------------------------------------
+ * Find a move that cannot wait: a bridge, which Cut wins by cutting
+ * and Short must lock.
+ * @param contraction the contracted board
+ * @param graph the board
+ * @param edge output: the bridge
+ * @return TRUE if there is a bridge
+ */
+int contractionForcedMove(Contraction *contraction, Graph *graph, Edge *edge);
+
+/** -------------------------------------------------------------------
+ * Number the groups that can still be reached from the start, and list
+ * the normal edges between them. The group of the start is node 0 and
+ * the group of the end is node numberNodes-1 (if it can be reached);
+ * contraction->node[v] is the node of vertex v, or -1 if it cannot be
+ * reached.
+ * @param contraction the contracted board
+ * @param graph the board
+ * @param edges output: the edges, as vertices of the board; it must
+ *              hold graphNumberEdges(graph) edges
+ * @param numberEdges output: the number of edges
+ * @return the number of nodes
+ */
+int contractionNumber(Contraction *contraction, Graph *graph, Edge *edges, int *numberEdges);
+
+#endif // CONTRACTION_H
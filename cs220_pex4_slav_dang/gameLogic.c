@@ -13,6 +13,21 @@
 #include <time.h>
 #include <math.h>
 #include "gameLogic.h"
+#include "search.h"
+#include "heap.h"
+#include "treePacking.h"
+#include "treePair.h"
+#include "minCut.h"
+#include "alphaBeta.h"
+#include "monteCarlo.h"
+#include "resistance.h"
+#include "treeSampler.h"
+#include "ponder.h"
+#include "contraction.h"
+#include "proofNumber.h"
+#include "tablebase.h"
+#include "lookahead.h"
+#include "threadPool.h"
 
 #define MAXIMUM_TRIES_TO_SET_LOCATION     1000
 #define MAXIMUM_TRIES_TO_CREATE_EDGE      1000
@@ -22,11 +37,31 @@
 
 // The type of the two game players.
 static int playerType[2] = {HUMAN_PLAYER, HUMAN_PLAYER};
-static char * playerTypeNames[2] = {" (Human)", " (AI)"};
+static char * playerTypeNames[5] = {" (Human)", " (AI)", " (Perfect AI)", " (Search AI)",
+                                     " (Monte Carlo AI)"};
 
 static int activePlayer = CUT_PLAYER;
 static char * activePlayerName[] = { "Cut's turn", "Short's turn"};
 
+// How path lengths are measured by dijkstra().
+static int edgeCost = HOP_COST;
+
+// How the AI picks the most critical edge.
+static int edgeScore = BETWEENNESS_SCORE;
+
+// How long the search and Monte Carlo AIs think about a move, in
+// milliseconds.
+static int moveTime = MONTE_CARLO_MOVE_TIME;
+
+// The number of spanning trees sampled for TREE_SCORE.
+static int treeSamples = SAMPLER_TREES;
+
+// The AI types that try to prove a win near the end of the game. The
+// perfect AIs know who wins already, alpha-beta solves these boards
+// faster than the proof-number search, and the plain AI does not
+// think about its moves, so only the Monte Carlo AI does at first.
+static int endgameProof[5] = {FALSE, FALSE, FALSE, FALSE, TRUE};
+
 // Local functions
 static void setLocation(Vertex *vertex, int width, int height, int margin);
 static int distance(Vertex *v1, Vertex *v2);
@@ -36,27 +71,155 @@ static int degree(Graph * graph, int index);
 static void findEdge(Graph *graph, int mouseX, int mouseY, Edge *edge);
 static int humanPlayer(Graph *graph, int mouseX, int mouseY);
 static int aiPlayer(Graph * graph);
+static int criticalEdge(Graph *graph, Edge *edge);
+static int currentEdge(Graph *graph, Edge *edge);
+static int sampledEdge(Graph *graph, Edge *edge);
+static int lookaheadEdge(Graph *graph, Edge *edge);
+static int pathEdge(Graph *graph, Edge *edge);
+static void setEdgeState(Graph *graph, int fromVertex, int toVertex, int state);
+static SearchWorkspace * gameWorkspace(Graph *graph);
+static TreePair * gameTreePair(Graph *graph);
+static MinCut * gameMinCut(Graph *graph);
+static Contraction * gameContraction(Graph *graph);
+static ResistanceSolver * gameResistance(Adjacency *board);
+static TreeSampler * gameSampler(Adjacency *board);
+static Lookahead * gameLookahead(Adjacency *board);
+static int searchMove(Graph *graph, Edge *edge, int milliseconds);
+static int endgameMove(Graph *graph, Edge *edge);
+static int timeLeft(LONGLONG start);
+static MonteCarloTree * gameMonteCarlo();
+static TranspositionTable * gameTable();
+static ProofTable * gameProofTable();
+static Tablebase * gameTablebase();
+static Ponder * gamePonder();
+static int perfectPlayWinner(Graph *graph);
 
 // Vertices are sorted according to their distance from the origin (0,0)
 static Vertex origin = {0, 0, 0};
 
+// Who wins the current position with perfect play; GAME_UNDERWAY
+// means it has not been worked out since the last move.
+static int predictedWinner = GAME_UNDERWAY;
+
+// The counters of the search AI's last move, shown under the status;
+// lastSearch.nodes is 0 if it has not moved yet.
+static AlphaBetaStatistics lastSearch = {0, 0, 0};
+
+// The counters of the last endgame proof an AI found; lastProof.nodes
+// is 0 if none was found yet.
+static ProofStatistics lastProof = {0, 0, 0.0, 0, 0, 0};
+
+// Scratch memory shared by every search of the game.
+static SearchWorkspace * workspace = NULL;
+
+// The trees that the perfect Short AI repairs after each of Cut's moves.
+static TreePair * shortTrees = NULL;
+
+// The maximum flow that the perfect Cut AI keeps up to date between turns.
+static MinCut * cutFlow = NULL;
+
+// The board with the vertices joined by locked edges merged, kept up to
+// date after every move. It decides when the game is over, and which
+// edges are dead.
+static Contraction * contracted = NULL;
+
+// The positions solved by the search AI. An entry is good for the rest
+// of the game, so the table is kept between turns.
+static TranspositionTable * searchTable = NULL;
+
+// The positions the endgame proofs worked on, kept between turns too.
+static ProofTable * proofTable = NULL;
+
+// Every position with a few live edges, solved ahead of time by
+// PEX4_tablebase. It is NULL if the file is not there.
+static Tablebase * endgameTablebase = NULL;
+static int tablebaseOpened = FALSE;
+
+// The search AI's replies, worked out while a human thinks.
+static Ponder * ponder = NULL;
+
+// The node pool of the Monte Carlo AI, which grows a new tree every move.
+static MonteCarloTree * monteCarloTree = NULL;
+
+// The resistor network used to score edges by their current.
+static ResistanceSolver * circuit = NULL;
 
-int min_vertex;
+// The random spanning trees used to estimate the currents.
+static TreeSampler * treeSampler = NULL;
 
+// The flow memory of each thread, used to score edges by looking ahead.
+static Lookahead * moveLookahead = NULL;
 
 
 /** -------------------------------------------------------------------
  * Set the type of player.
  * @param player Either CUT_PLAYER or SHORT_PLAYER
- * @param type Either HUMAN_PLAYER or AI_PLAYER
+ * @param type HUMAN_PLAYER, AI_PLAYER, PERFECT_AI_PLAYER, SEARCH_AI_PLAYER
+ *             or MONTE_CARLO_AI_PLAYER
  */
 void setPlayerType(int player, int type) {
     if ( (player == CUT_PLAYER || player == SHORT_PLAYER) &&
-         (type == HUMAN_PLAYER || type == AI_PLAYER) ) {
+         (type >= HUMAN_PLAYER && type <= MONTE_CARLO_AI_PLAYER) ) {
         playerType[player] = type;
     }
 }
 
+/** -------------------------------------------------------------------
+ * Set how long the search and Monte Carlo AIs think about each move.
+ * @param milliseconds the time per move; must be positive
+ */
+void setMoveTime(int milliseconds) {
+    if (milliseconds > 0) {
+        moveTime = milliseconds;
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Set how the length of a path is measured.
+ * @param cost Either HOP_COST or LENGTH_COST
+ */
+void setEdgeCost(int cost) {
+    if (cost == HOP_COST || cost == LENGTH_COST) {
+        edgeCost = cost;
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Set how the AI scores the edges it can play.
+ * @param score BETWEENNESS_SCORE, CURRENT_SCORE, TREE_SCORE or
+ *              LOOKAHEAD_SCORE
+ */
+void setEdgeScore(int score) {
+    if (score == BETWEENNESS_SCORE || score == CURRENT_SCORE || score == TREE_SCORE ||
+        score == LOOKAHEAD_SCORE) {
+        edgeScore = score;
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Set how many random spanning trees the AI samples to score the edges
+ * with TREE_SCORE.
+ * @param trees the number of trees; must be positive
+ */
+void setTreeSamples(int trees) {
+    if (trees > 0) {
+        treeSamples = trees;
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Set whether an AI tries to prove a win with a proof-number search
+ * once few live edges are left, before it plays as usual.
+ * @param type AI_PLAYER, PERFECT_AI_PLAYER, SEARCH_AI_PLAYER or
+ *             MONTE_CARLO_AI_PLAYER
+ * @param prove TRUE to try, FALSE not to
+ */
+void setEndgameProof(int type, int prove) {
+    if (type >= AI_PLAYER && type <= MONTE_CARLO_AI_PLAYER) {
+        endgameProof[type] = prove;
+    }
+}
+
 /** -------------------------------------------------------------------
  * Set the active player. This should be called only once at
  * the start of the game to determine who goes first.
@@ -247,6 +410,11 @@ void createEdges(Graph * graph, int minNumberEdges, int maxNumberEdges,
             //MYCHANGE
             graphSetEdge(graph, toVertex, nodeIndex, NORMAL_EDGE);
 
+            // Remember the length so path searches don't recompute it
+            int length = distance(vertices + nodeIndex, vertices + toVertex);
+            graphSetWeight(graph, nodeIndex, toVertex, length);
+            graphSetWeight(graph, toVertex, nodeIndex, length);
+
         }
     }
 }
@@ -258,13 +426,7 @@ void createEdges(Graph * graph, int minNumberEdges, int maxNumberEdges,
  * @return the number of edges leaving vertex[index]
  */
 int degree(Graph * graph, int index) {
-    int count = 0;
-    for (int j = 0; j < graph->numberVertices; j++) {
-        if (graph->edges[index][j] > NO_EDGE) {
-            count++;
-        }
-    }
-    return count;
+    return graph->degree[index];
 }
 
 
@@ -299,7 +461,7 @@ void drawGraph(Graph *graph, HWND hwnd, int labelVertices) {
     HDC hdc = BeginPaint(hwnd, &ps);
     int brush;
     int pen;
-    char textString[40];
+    char textString[64];
     Vertex * vertices = (Vertex *) graph->vertices;
 
     clearBackground(hwnd, hdc, SOLID_THIN_WHITE, MY_WHITE_BRUSH);
@@ -317,6 +479,39 @@ void drawGraph(Graph *graph, HWND hwnd, int labelVertices) {
         strcpy(textString, activePlayerName[activePlayer]);
         strcat(textString, playerTypeNames[playerType[activePlayer]]);
         drawText(hdc, 3, 3, textString);
+
+        // Display who wins from here with perfect play.
+        if (predictedWinner == GAME_UNDERWAY) {
+            predictedWinner = perfectPlayWinner(graph);
+        }
+        if (predictedWinner == SHORT_WINS) {
+            strcpy(textString, "Perfect play: Short wins");
+        } else {
+            strcpy(textString, "Perfect play: Cut wins");
+        }
+        drawText(hdc, 3, 20, textString);
+
+        // Display how many of the normal edges are worth playing.
+        Contraction *board = gameContraction(graph);
+        contractionLive(board, graph);
+        sprintf(textString, "Live edges: %d of %d, %d bridges", board->live.liveEdges,
+                board->live.normalEdges, board->numberBridges);
+        drawText(hdc, 3, 37, textString);
+    }
+
+    // Display how far the search AI looked on its last move.
+    if (lastSearch.nodes > 0) {
+        sprintf(textString, "Search: depth %d, %lld nodes", lastSearch.depth, lastSearch.nodes);
+        drawText(hdc, 3, 54, textString);
+    }
+
+    // Display the last endgame proof.
+    if (lastProof.nodes > 0) {
+        double rate = (lastProof.milliseconds > 0.0) ? lastProof.nodes * 1000.0 / lastProof.milliseconds
+                                                     : 0.0;
+        sprintf(textString, "Endgame proof: tree of %lld nodes, %.0f nodes/s, %d MB",
+                lastProof.proofSize, rate, (int) (lastProof.bytes >> 20));
+        drawText(hdc, 3, 71, textString);
     }
 
     // Draw the edges
@@ -447,14 +642,9 @@ int humanPlayer(Graph *graph, int mouseX, int mouseY) {
         return FALSE;
     } else {
         if (activePlayer == SHORT_PLAYER) {
-            graphSetEdge(graph, edge.fromVertex, edge.toVertex, LOCKED_EDGE);
-            graphSetEdge(graph, edge.toVertex, edge.fromVertex, LOCKED_EDGE);
-
-
+            setEdgeState(graph, edge.fromVertex, edge.toVertex, LOCKED_EDGE);
         } else { // activePlayer == CUT_PLAYER
-            graphSetEdge(graph, edge.fromVertex, edge.toVertex, NO_EDGE);
-            graphSetEdge(graph, edge.toVertex, edge.fromVertex, NO_EDGE);
-
+            setEdgeState(graph, edge.fromVertex, edge.toVertex, NO_EDGE);
         }
         return TRUE;
     }
@@ -467,47 +657,360 @@ int humanPlayer(Graph *graph, int mouseX, int mouseY) {
  *         was not taken.
  */
 int aiPlayer(Graph * graph) {
-    Path* ai_shortpath = dijkstra(graph);
+    Edge edge;
+    LONGLONG moveStart = ticks();
+
+    /**Forced moves - A bridge is a normal edge that every path between the terminals goes through. Cut wins by
+     * cutting it, so Short must lock it at once. Every AI plays a bridge before it thinks about anything else.
+     */
+    if (contractionForcedMove(gameContraction(graph), graph, &edge)) {
+        int state = (activePlayer == SHORT_PLAYER) ? LOCKED_EDGE : NO_EDGE;
+        setEdgeState(graph, edge.fromVertex, edge.toVertex, state);
+        return TRUE;
+    }
+
+    /**Perfect Short AI - When Short can win, two edge-disjoint spanning trees connect the terminals. Whenever Cut
+     * breaks one of them, we lock the edge of the other tree that joins it back together. The trees are kept
+     * between turns, so each reply only searches the smaller part of the broken tree.
+     */
+    if (activePlayer == SHORT_PLAYER && playerType[SHORT_PLAYER] == PERFECT_AI_PLAYER &&
+        treePairReply(gameTreePair(graph), graph, &edge)) {
+        setEdgeState(graph, edge.fromVertex, edge.toVertex, LOCKED_EDGE);
+        return TRUE;
+    }
 
+    /**Perfect Cut AI - When Cut can win (Lehman's theorem tells), we cut an edge after which Short, to move, still
+     * loses, checking each reply the same way. The edge of the minimum cut is tried first: the fewest edges Cut must
+     * remove is the maximum flow between the terminals, and an edge that is in every minimum cut is usually the
+     * winning one. It is not always, so the other live edges are tried after it. The flow is repaired, not
+     * recomputed, after each move. If Cut cannot win we play as usual.
+     */
+    if (activePlayer == CUT_PLAYER && playerType[CUT_PLAYER] == PERFECT_AI_PLAYER &&
+        minCutWinningMove(gameMinCut(graph), gameContraction(graph), graph, &edge)) {
+        setEdgeState(graph, edge.fromVertex, edge.toVertex, NO_EDGE);
+        return TRUE;
+    }
 
-    /**Short Player AI - For the short player AI, we locked the edge on the shortest path (which is found using
-     * dijkstra's algorithm) that is closest to the ending vertex. The next turn, it will either follow along this
-     * path or start a new one if a new shortest path is found.
+    /**Tablebase - Once no more than TABLEBASE_MAX_EDGES live edges are left, every position the game can still reach
+     * was solved ahead of time and is in the tablebase file. We look up a winning move there, which takes no time at
+     * all. If there is none, or no file, we play as usual.
+     */
+    if (gameTablebase() != NULL &&
+        tablebaseMove(gameTablebase(), graph, gameContraction(graph), activePlayer, &edge)) {
+        int state = (activePlayer == SHORT_PLAYER) ? LOCKED_EDGE : NO_EDGE;
+        setEdgeState(graph, edge.fromVertex, edge.toVertex, state);
+        return TRUE;
+    }
+
+    /**Endgame - Once few live edges are left, the AIs that are set to (see setEndgameProof) try to prove a win with
+     * a proof-number search (df-pn), which works on the line closest to a proof first. It gets part of moveTime,
+     * and the search below gets what is left. If a proof is found we play its first move; if not, we play as
+     * usual. The table keeps the positions worked on, so the next turn picks up where this one stopped.
+     */
+    if (endgameProof[playerType[activePlayer]] && endgameMove(graph, &edge)) {
+        int state = (activePlayer == SHORT_PLAYER) ? LOCKED_EDGE : NO_EDGE;
+        setEdgeState(graph, edge.fromVertex, edge.toVertex, state);
+        return TRUE;
+    }
+
+    /**Search AI - On small boards we search the game tree (negamax with alpha-beta pruning and a transposition
+     * table) one move deeper at a time until moveTime is up, and play the best move of the deepest search that
+     * finished. Lines that are not searched to the end are scored by how close Short is to a path. When the search
+     * reaches the end of every line we play a move that wins if there is one.
+     */
+    if (playerType[activePlayer] == SEARCH_AI_PLAYER && searchMove(graph, &edge, timeLeft(moveStart))) {
+        int state = (activePlayer == SHORT_PLAYER) ? LOCKED_EDGE : NO_EDGE;
+        setEdgeState(graph, edge.fromVertex, edge.toVertex, state);
+        return TRUE;
+    }
+
+    /**Monte Carlo AI - For boards too big to search to the end, every processor plays random games from the
+     * current position for what is left of moveTime, growing a shared tree of the most promising lines (UCT with
+     * RAVE). On boards of up to 64 vertices and edges each random game is played 64 times at once, one game in
+     * each bit of a word. We play the move that was tried the most.
+     */
+    if (playerType[activePlayer] == MONTE_CARLO_AI_PLAYER &&
+        monteCarloMove(gameMonteCarlo(), graph, gameContraction(graph), activePlayer, searchThreadPool(),
+                       timeLeft(moveStart), &edge, NULL)) {
+        int state = (activePlayer == SHORT_PLAYER) ? LOCKED_EDGE : NO_EDGE;
+        setEdgeState(graph, edge.fromVertex, edge.toVertex, state);
+        return TRUE;
+    }
+
+    if (!criticalEdge(graph, &edge)) {
+        return FALSE; // There is no edge left to play on a shortest path
+    }
+
+    /**Short Player AI - For the short player AI, we lock the normal edge that the most shortest paths (counted
+     * with edgeBetweenness) go through. Ties go to the edge closest to the ending vertex. Locking it keeps the
+     * most shortest paths open. With setEdgeScore(CURRENT_SCORE), the board is a resistor network instead and
+     * we play the edge that carries the most current, which counts every path and not just the shortest ones.
+     * setEdgeScore(TREE_SCORE) estimates the same currents from random spanning trees on boards too large to
+     * solve in time. setEdgeScore(LOOKAHEAD_SCORE) tries every edge on a shortest path, on every processor at
+     * once, and plays the one that leaves Short the most edge-disjoint paths (Cut the fewest). On boards with at
+     * least PARALLEL_BFS_MIN_VERTICES vertices the paths are not counted: we play the normal edge closest to the
+     * ending vertex on one shortest path, which dijkstra() finds with the parallel breadth-first search.
      */
     if (activePlayer == SHORT_PLAYER) {
-        int turn = 0; // turn is not taken
-        int index = 0;
-        while (turn == 0) {
-            if (graphGetEdge(graph, ai_shortpath->vertices[index], ai_shortpath->vertices[index + 1]) == 1 &&
-                    graph) {
-                graphSetEdge(graph, ai_shortpath->vertices[index], ai_shortpath->vertices[index + 1], LOCKED_EDGE);
-                graphSetEdge(graph, ai_shortpath->vertices[index+1], ai_shortpath->vertices[index], LOCKED_EDGE);
-                turn = 1;
-            }
-            index++;
-        }
+        setEdgeState(graph, edge.fromVertex, edge.toVertex, LOCKED_EDGE);
     }
 
-    /**Short Player AI - For the cut player AI, we took the same idea of the short player ai. We cut the edge on the
-     * shortest path (which is found using dijkstra's algorithm) that is closest to the ending vertex. The next turn,
-     * it will either follow along this path or start a new one if a new shortest path is found.
+    /**Cut Player AI - For the cut player AI, we took the same idea of the short player ai. Cutting the edge that
+     * the most shortest paths go through destroys the most shortest paths at once.
     */
     else { //activePlayer = CUT_PLAYER
-        int turn = 0; // turn is not taken
-        int index = 0;
-        while (turn == 0) {
-            if (graphGetEdge(graph, ai_shortpath->vertices[index], ai_shortpath->vertices[index + 1]) == 1) {
-                graphSetEdge(graph, ai_shortpath->vertices[index], ai_shortpath->vertices[index + 1], NO_EDGE);
-                graphSetEdge(graph, ai_shortpath->vertices[index+1], ai_shortpath->vertices[index], NO_EDGE);
-                turn = 1;
+        setEdgeState(graph, edge.fromVertex, edge.toVertex, NO_EDGE);
+    }
+
+    return TRUE;
+}
+
+/** -------------------------------------------------------------------
+ * Find the normal edge that the most shortest paths from the starting
+ * to the ending vertex go through, or that carries the most current
+ * if the edges are scored by current (exactly or from sampled trees).
+ * Dead edges, which are on no simple path between them, are never
+ * picked. Large boards are not scored; see pathEdge().
+ * @param graph the graph
+ * @param edge output: the most critical edge
+ * @return TRUE if an edge was found. Return FALSE if no normal edge
+ *         is on a shortest path.
+ */
+int criticalEdge(Graph *graph, Edge *edge) {
+    if (edgeScore == CURRENT_SCORE) {
+        return currentEdge(graph, edge);
+    }
+    if (edgeScore == TREE_SCORE) {
+        return sampledEdge(graph, edge);
+    }
+    if (edgeScore == LOOKAHEAD_SCORE) {
+        return lookaheadEdge(graph, edge);
+    }
+    if (graph->numberVertices >= PARALLEL_BFS_MIN_VERTICES) {
+        return pathEdge(graph, edge);
+    }
+
+    SearchWorkspace *scratch = gameWorkspace(graph);
+    Contraction *board = gameContraction(graph);
+    int found = edgeBetweenness(graph, scratch, 0, graph->numberVertices - 1);
+    Edge *edges = scratch->edges;
+    double *paths = scratch->scores;
+
+    // The edges are listed from the starting vertex outward; search them
+    // backward so that ties go to the edge closest to the ending vertex.
+    int best = -1;
+    for (int k = found - 1; k >= 0; k--) {
+        if (contractionIsLive(board, graph, edges[k].fromVertex, edges[k].toVertex) &&
+            (best == -1 || paths[k] > paths[best])) {
+            best = k;
+        }
+    }
+    if (best != -1) {
+        *edge = edges[best];
+    }
+    return best != -1;
+}
+
+/** -------------------------------------------------------------------
+ * Find the normal edge closest to the ending vertex on a shortest path
+ * found by dijkstra(), which uses the parallel breadth-first search on
+ * boards this large. Every edge of a shortest path is on a simple path
+ * between the terminals, so the edge is never dead.
+ * @param graph the graph
+ * @param edge output: the edge
+ * @return TRUE if an edge was found. Return FALSE if the game is over.
+ */
+int pathEdge(Graph *graph, Edge *edge) {
+    int *path = gameWorkspace(graph)->path;
+    int length = dijkstra(graph, path);
+
+    // The path is listed from the ending vertex back to the starting one
+    for (int i = 0; i + 1 < length; i++) {
+        if (graph->edges[path[i]][path[i+1]] == NORMAL_EDGE) {
+            edge->fromVertex = path[i+1];
+            edge->toVertex = path[i];
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/** -------------------------------------------------------------------
+ * Find the normal edge that carries the most current when the start is
+ * held at 1 volt and the end at 0 volts, and every normal edge is a 1
+ * ohm resistor. Locked edges have no resistance.
+ * @param graph the graph
+ * @param edge output: the edge with the most current
+ * @return TRUE if an edge was found. Return FALSE if the game is over.
+ */
+int currentEdge(Graph *graph, Edge *edge) {
+    Adjacency *network = adjacencyFromGraph(graph, NORMAL_EDGE);
+    Adjacency *locked = adjacencyFromGraph(graph, LOCKED_EDGE);
+    ResistanceSolver *solver = gameResistance(network);
+    Contraction *board = gameContraction(graph);
+
+    double best = 0.0;
+    if (resistanceSolve(solver, network, locked)) {
+        for (int u = 0; u < graph->numberVertices; u++) {
+            for (int j = 0; j < graph->degree[u]; j++) {
+                int v = graph->neighbors[u][j];
+                double current = resistanceCurrent(solver, u, v);
+                if (u < v && current > best && contractionIsLive(board, graph, u, v)) {
+                    best = current;
+                    edge->fromVertex = u;
+                    edge->toVertex = v;
+                }
             }
-            index++;
         }
     }
 
+    adjacencyDelete(network);
+    adjacencyDelete(locked);
+    return best > 0.0;
+}
 
-    return TRUE;
+/** -------------------------------------------------------------------
+ * Find the normal edge that the most current flows through, estimated
+ * from random spanning trees. It takes at most SAMPLER_TIME_LIMIT
+ * milliseconds, however large the board is.
+ * @param graph the graph
+ * @param edge output: the edge with the most current
+ * @return TRUE if an edge was found. Return FALSE if the game is over.
+ */
+int sampledEdge(Graph *graph, Edge *edge) {
+    Adjacency *network = adjacencyFromGraph(graph, NORMAL_EDGE);
+    Adjacency *locked = adjacencyFromGraph(graph, LOCKED_EDGE);
+    TreeSampler *sampler = gameSampler(network);
+    Contraction *board = gameContraction(graph);
+
+    double best = 0.0;
+    if (samplerRun(sampler, network, locked, searchThreadPool(), treeSamples, SAMPLER_TIME_LIMIT)) {
+        for (int u = 0; u < graph->numberVertices; u++) {
+            for (int j = 0; j < graph->degree[u]; j++) {
+                int v = graph->neighbors[u][j];
+                double current = samplerCurrent(sampler, u, v);
+                if (u < v && current > best && contractionIsLive(board, graph, u, v)) {
+                    best = current;
+                    edge->fromVertex = u;
+                    edge->toVertex = v;
+                }
+            }
+        }
+    }
+
+    adjacencyDelete(network);
+    adjacencyDelete(locked);
+    return best > 0.0;
+}
+
+/** -------------------------------------------------------------------
+ * Find the edge that is best for the active player one move ahead:
+ * Short locks the edge that leaves the most edge-disjoint paths
+ * between the terminals, and Cut cuts the one that leaves the fewest.
+ * The edges tried are those on a shortest path and those that carry
+ * flow between the terminals. Ties go to the edge with the most
+ * shortest paths through it. The edges are tried in parallel.
+ * @param graph the graph
+ * @param edge output: the best edge
+ * @return TRUE if an edge was found. Return FALSE if no live normal
+ *         edge is on a shortest path or carries flow.
+ */
+int lookaheadEdge(Graph *graph, Edge *edge) {
+    SearchWorkspace *scratch = gameWorkspace(graph);
+    Contraction *board = gameContraction(graph);
+    Adjacency *network = adjacencyFromGraph(graph, NORMAL_EDGE);
+    Adjacency *locked = adjacencyFromGraph(graph, LOCKED_EDGE);
+    int found = edgeBetweenness(graph, scratch, 0, graph->numberVertices - 1);
+    found = lookaheadAddFlowEdges(gameLookahead(network), network, locked, scratch->edges,
+                                  scratch->scores, found);
+
+    // Only the live edges are tried, in the same order
+    int count = 0;
+    for (int k = 0; k < found; k++) {
+        if (contractionIsLive(board, graph, scratch->edges[k].fromVertex, scratch->edges[k].toVertex)) {
+            scratch->edges[count] = scratch->edges[k];
+            scratch->scores[count] = scratch->scores[k];
+            count++;
+        }
+    }
+
+    int picked = lookaheadMove(gameLookahead(network), network, locked, activePlayer, scratch->edges,
+                               scratch->scores, count, searchThreadPool(), edge, NULL);
+    adjacencyDelete(network);
+    adjacencyDelete(locked);
+    return picked;
 }
+
+/** -------------------------------------------------------------------
+ * Find the active player's best move by searching the game tree.
+ * @param graph the graph
+ * @param edge output: the edge to play
+ * @param milliseconds how long to search
+ * @return TRUE if a move was found. Return FALSE if the board is too
+ *         large to search or the game is over.
+ */
+int searchMove(Graph *graph, Edge *edge, int milliseconds) {
+    Position *position = positionCreate(graph, activePlayer);
+    if (position == NULL) {
+        return FALSE;
+    }
+
+    // The reply may have been worked out while the human thought
+    int move;
+    if (!ponderReply(gamePonder(), position, milliseconds, &move, &lastSearch)) {
+        alphaBetaDeepen(position, gameTable(), milliseconds, NULL, &move, &lastSearch);
+    }
+    if (move != -1) {
+        *edge = position->edges[move];
+    }
+    positionDelete(position);
+    return move != -1;
+}
+
+/** -------------------------------------------------------------------
+ * Try to prove that the active player wins with a proof-number search
+ * for part of moveTime, once few enough live edges are left.
+ * @param graph the graph
+ * @param edge output: the first move of the proof
+ * @return TRUE if a win was proven. Return FALSE if the board is too
+ *         large, the active player loses, or the time ran out first.
+ */
+int endgameMove(Graph *graph, Edge *edge) {
+    int liveEdges = contractionLive(gameContraction(graph), graph);
+    if (liveEdges == 0 || liveEdges > PROOF_ENDGAME_EDGES) {
+        return FALSE;
+    }
+    Position *position = positionCreate(graph, activePlayer);
+    if (position == NULL) {
+        return FALSE;
+    }
+
+    int move;
+    ProofStatistics statistics;
+    int winner = proofSolve(position, gameProofTable(), moveTime / PROOF_ENDGAME_SHARE, &move,
+                            &statistics);
+    int activeWins = (activePlayer == SHORT_PLAYER) ? SHORT_WINS : CUT_WINS;
+    int proven = (winner == activeWins && move != -1);
+    if (proven) {
+        *edge = position->edges[move];
+        lastProof = statistics;
+    }
+    positionDelete(position);
+    return proven;
+}
+
+/** -------------------------------------------------------------------
+ * Get how much of moveTime is left for the AI's search.
+ * @param start when the AI started to think about its move, in ticks()
+ * @return the milliseconds left; at least 1
+ */
+int timeLeft(LONGLONG start) {
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    LONGLONG spent = (ticks() - start) * 1000 / frequency.QuadPart;
+    return (spent < moveTime) ? moveTime - (int) spent : 1;
+}
+
 /** -------------------------------------------------------------------
  * Take one turn in the Shannon Switching game. If the turn was successful,
  * the active player changes to the other player and the window is redrawn.
@@ -521,6 +1024,11 @@ void doTurn(Graph *graph, int mouseX, int mouseY) {
 
     int turnIsDone = FALSE;
 
+    // The AI's search needs the table the background search is using
+    if (ponder != NULL && playerType[activePlayer] != HUMAN_PLAYER) {
+        ponderStop(ponder);
+    }
+
     if (playerType[activePlayer] == HUMAN_PLAYER) {
         turnIsDone = humanPlayer(graph, mouseX, mouseY);
     } else {
@@ -530,86 +1038,78 @@ void doTurn(Graph *graph, int mouseX, int mouseY) {
 
     if (turnIsDone) {
         activePlayer = 1 - activePlayer; // swap active player
+        predictedWinner = GAME_UNDERWAY; // worked out again on the redraw
         redraw();
     }
 
 
-    /**Cut_Player wins: If the first value in the path array for the original adjacency matrix is a -1, this means that
-     * there is no shortest path, or no path at all, that exists. Therefore, cut_player wins.**/
-    Path *shortest_path = dijkstra(graph);
-    Graph* locked_edge = locked_edge_graph(graph);
-    Path* lockedpath_exists = dijkstra(locked_edge);
-
-    if (shortest_path->vertices[0] == -1) {
-        game_status = 2;
-    }
+    /**Short_Player wins: The locked edges join the starting and ending vertices into one group of the contracted
+     * board. Cut_Player wins: No normal edges lead from the starting vertex's group to the ending vertex's group.
+     * The groups are kept up to date after each move, so this only searches the groups, not the whole board.
+     * The game is also over as soon as a bridge decides it: Cut wins if Cut is to move and can cut one, or if
+     * there are two, and Short wins if Short is to move and the only live edge is a bridge.**/
+    game_status = contractionDecided(gameContraction(graph), graph, activePlayer);
 
-    /**Short_Player wins: If the first value in the path array for the adjacency matrix that is composed only of locked
-     * edges is a -1, this means that there is no shortest path through just the locked edges, that exists.
-     * Therefore, short_player wins.**/
-    else if(lockedpath_exists->vertices[0] != -1){
-        game_status = 1;
-    }
-    else{
-        game_status = 0;
+    /**Pondering - While a human thinks about their move, a background thread works out the search AI's replies
+     * to the human's most critical moves, so the AI can answer at once when the human picks one of them.
+     */
+    if (game_status == GAME_UNDERWAY && playerType[activePlayer] == HUMAN_PLAYER &&
+        playerType[1 - activePlayer] == SEARCH_AI_PLAYER && gamePonder()->thread == NULL) {
+        ponderStart(ponder, graph, activePlayer, gameTable(), moveTime);
     }
 }
 
 /** -------------------------------------------------------------------
- * Finds the shortest path using the dijkstra algorithm
+ * Finds the shortest path using the dijkstra algorithm. The vertices
+ * are kept in a binary heap, so the search takes O(E log V) time. Each
+ * edge costs 1, or its length when setEdgeCost(LENGTH_COST) was called.
  * @param graph the graph
- * @return shortest_path - an array of vertices that make up the shortest path
+ * @param shortest_path output: the vertices that make up the shortest
+ *                      path, the ending vertex first. Must hold
+ *                      graph->numberVertices entries.
+ * @return the number of vertices on the path; 0 if no path exists
  */
-Path* dijkstra (Graph* graph) {
-
-    int alt;
-    Path* shortest_path = createpath();
+int dijkstra (Graph* graph, int* shortest_path) {
 
+    // Every edge costs 1, so on large boards the parallel breadth-first
+    // search finds a shortest path much faster.
+    if (edgeCost == HOP_COST && graph->numberVertices >= PARALLEL_BFS_MIN_VERTICES) {
+        return bfsShortestPath(graph, gameWorkspace(graph), shortest_path);
+    }
 
-    int Q[graph->numberVertices];
-    int dist[graph->numberVertices];
-    int prev[graph->numberVertices];
+    SearchWorkspace* workspace = gameWorkspace(graph);
+    int* dist = workspace->dist;
+    int* prev = workspace->prev;
+    Heap* Q = workspace->heap;
 
-    for (int v = 0; v < graph->numberVertices; v++) {
-        dist[v] = 10000;
-        prev[v] = -1;
-        Q[v] = -1;
-        shortest_path->vertices[v] = -1;
-    }
+    // A vertex's dist is only meaningful once it has been reached in
+    // this search, so nothing needs to be cleared first.
+    workspaceBegin(workspace);
+    unsigned int generation = workspace->generation;
 
     dist[0] = 0;
-
-    int emptyset = 1;
+    workspace->reached[0] = generation;
+    heapDecreaseKey(Q, 0, 0);
 
     //while Q is not empty
-    while (emptyset != 0) {
-
-        //find min_vertex
-        int min_dist = 100000000;
-        for (int i = 0; i < graph->numberVertices; i++) {
-            if (dist[i] < min_dist && Q[i] == -1) {
-                min_dist = dist[i];
-                min_vertex = i;
-            }
-        }
-        Q[min_vertex] = 0; //Taken out of Q
-
-        emptyset = 0;
-        for (int i = 0; i < graph->numberVertices; i++) {
-            if (Q[i] != 0) {
-                emptyset = 1; //emptyset is TRUE when all Q not equal to 0
-            }
+    while (!heapIsEmpty(Q)) {
+        int min_vertex = heapPopMin(Q);
+        workspace->settled[min_vertex] = generation; //Taken out of Q
+        if (min_vertex == graph->numberVertices - 1) {
+            break; // The ending vertex is settled; nothing shorter remains
         }
 
         //for each neighbor v of u
-        for (int i = 0; i < graph->numberVertices; i++){
-            if (graph->edges[min_vertex][i] == 1 | graph->edges[min_vertex][i] == 2) { //find neighbors of v
-                if (Q[i] == -1) {// check to see if neighbor is still in Q
-                    alt = dist[min_vertex] + 1;
-                    if (alt < dist[i]){
-                        dist[i] = alt;
-                        prev[i]= min_vertex;
-                    }
+        for (int j = 0; j < graph->degree[min_vertex]; j++) {
+            int i = graph->neighbors[min_vertex][j];
+            if (workspace->settled[i] != generation) {
+                int alt = dist[min_vertex];
+                alt += (edgeCost == LENGTH_COST) ? graph->weights[min_vertex][i] : 1;
+                if (workspace->reached[i] != generation || alt < dist[i]) {
+                    workspace->reached[i] = generation;
+                    dist[i] = alt;
+                    prev[i] = min_vertex;
+                    heapDecreaseKey(Q, i, alt);
                 }
             }
         }
@@ -618,39 +1118,233 @@ Path* dijkstra (Graph* graph) {
     int current_vertex = graph->numberVertices - 1;
 
     int i = 0;
-    if (dist[current_vertex] < 10000){
+    if (workspace->reached[current_vertex] == generation){
         while (current_vertex != 0) {
-            shortest_path->vertices[i] = current_vertex;
+            shortest_path[i] = current_vertex;
             current_vertex = prev[current_vertex];
             i++;
         }
-        shortest_path->vertices[i] = 0;
-    }
-    else{
-        shortest_path->vertices[0] = -1; //indicates that no path exists
+        shortest_path[i] = 0;
+        i++;
     }
+    //else i == 0 indicates that no path exists
 
-    return shortest_path;
+    return i;
 }
 
 
 /** -------------------------------------------------------------------
- * Finds all the locked edges and puts it in another adjacency matrix
+ * Change the state of an edge in both directions and tell everything
+ * that is kept up to date between turns. Every move goes through here.
  * @param graph the graph
- * @return locked_graph - a graph structure whose edge substructure is
- * the adjacency matrix with all locked edges
- */
-Graph* locked_edge_graph (Graph* graph){
-    Graph* locked_graph = graphCreate(graph->numberVertices, sizeof(Vertex));
-    for (int u = 0; u< graph->numberVertices; u++){
-        for (int v = 0; v< graph->numberVertices; v++){
-            if (graphGetEdge(graph, u, v) == 2){
-                locked_graph->edges[u][v] = 1;
-            }
-            else{
-                locked_graph->edges[u][v] = 0;
-            }
+ * @param fromVertex one end of the edge
+ * @param toVertex the other end of the edge
+ * @param state the new state of the edge
+ */
+void setEdgeState(Graph *graph, int fromVertex, int toVertex, int state) {
+    graphSetEdge(graph, fromVertex, toVertex, state);
+    graphSetEdge(graph, toVertex, fromVertex, state);
+
+    if (contracted != NULL) {
+        contractionObserve(contracted, graph, fromVertex, toVertex, state);
+    }
+    if (shortTrees != NULL) {
+        treePairObserve(shortTrees, graph, fromVertex, toVertex, state);
+    }
+    if (cutFlow != NULL) {
+        minCutObserve(cutFlow, graph, fromVertex, toVertex, state);
+    }
+    if (workspace != NULL) {
+        workspaceObserve(workspace, graph, fromVertex, toVertex, state);
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Work out who wins the current position with perfect play.
+ * @param graph the graph
+ * @return SHORT_WINS or CUT_WINS
+ */
+int perfectPlayWinner(Graph *graph) {
+    TreePacking *packing = lehmanSolve(graph, activePlayer);
+    int winner = packing->winner;
+    treePackingDelete(packing);
+    return winner;
+}
+
+/** -------------------------------------------------------------------
+ * Get the scratch memory for the game's searches. It is created for the
+ * first graph that needs it and replaced only if a bigger graph comes
+ * along, so searches never allocate memory on their own.
+ * @param graph the graph about to be searched
+ * @return the game's search workspace
+ */
+SearchWorkspace * gameWorkspace(Graph *graph) {
+    if (workspace == NULL || workspace->capacity < graph->numberVertices) {
+        if (workspace != NULL) {
+            workspaceDelete(workspace);
         }
+        workspace = workspaceCreate(graph->numberVertices);
+    }
+    return workspace;
+}
+
+/** -------------------------------------------------------------------
+ * Get the tree pair of the perfect Short AI. Like the workspace, it is
+ * replaced only if a bigger graph comes along.
+ * @param graph the board
+ * @return the game's tree pair
+ */
+TreePair * gameTreePair(Graph *graph) {
+    if (shortTrees == NULL || shortTrees->numberVertices < graph->numberVertices) {
+        if (shortTrees != NULL) {
+            treePairDelete(shortTrees);
+        }
+        shortTrees = treePairCreate(graph->numberVertices);
+    }
+    return shortTrees;
+}
+
+/** -------------------------------------------------------------------
+ * Get the flow of the perfect Cut AI. Like the workspace, it is
+ * replaced only if a bigger graph comes along.
+ * @param graph the board
+ * @return the game's min cut finder
+ */
+MinCut * gameMinCut(Graph *graph) {
+    if (cutFlow == NULL || cutFlow->numberVertices < graph->numberVertices) {
+        if (cutFlow != NULL) {
+            minCutDelete(cutFlow);
+        }
+        cutFlow = minCutCreate(graph->numberVertices);
+    }
+    return cutFlow;
+}
+
+/** -------------------------------------------------------------------
+ * Get the contracted board that decides when the game is over and
+ * which edges are dead. Like the workspace, it is replaced only if a
+ * bigger board comes along.
+ * @param graph the board
+ * @return the game's contracted board
+ */
+Contraction * gameContraction(Graph *graph) {
+    if (contracted == NULL || contracted->capacity < graph->numberVertices) {
+        if (contracted != NULL) {
+            contractionDelete(contracted);
+        }
+        contracted = contractionCreate(graph->numberVertices);
+    }
+    return contracted;
+}
+
+/** -------------------------------------------------------------------
+ * Get the resistor network used to score edges by their current. Like
+ * the workspace, it is replaced only if a bigger board comes along.
+ * @param board the normal and locked edges of the board
+ * @return the game's resistance solver
+ */
+ResistanceSolver * gameResistance(Adjacency *board) {
+    if (circuit == NULL || circuit->capacity < board->numberVertices ||
+        circuit->arcCapacity < board->numberArcs) {
+        if (circuit != NULL) {
+            resistanceDelete(circuit);
+        }
+        circuit = resistanceCreate(board->numberVertices, board->numberArcs);
+    }
+    return circuit;
+}
+
+/** -------------------------------------------------------------------
+ * Get the spanning tree sampler. Like the resistor network, it is
+ * replaced only if a bigger board comes along.
+ * @param board the normal and locked edges of the board
+ * @return the game's tree sampler
+ */
+TreeSampler * gameSampler(Adjacency *board) {
+    if (treeSampler == NULL || treeSampler->capacity < board->numberVertices ||
+        treeSampler->arcCapacity < board->numberArcs) {
+        if (treeSampler != NULL) {
+            samplerDelete(treeSampler);
+        }
+        treeSampler = samplerCreate(board->numberVertices, board->numberArcs);
+    }
+    return treeSampler;
+}
+
+/** -------------------------------------------------------------------
+ * Get the lookahead used to score edges one move ahead. Like the
+ * resistor network, it is replaced only if a bigger board comes along.
+ * @param board the normal and locked edges of the board
+ * @return the game's lookahead
+ */
+Lookahead * gameLookahead(Adjacency *board) {
+    if (moveLookahead == NULL || moveLookahead->capacity < board->numberVertices ||
+        moveLookahead->arcCapacity < board->numberArcs) {
+        if (moveLookahead != NULL) {
+            lookaheadDelete(moveLookahead);
+        }
+        moveLookahead = lookaheadCreate(board->numberVertices, board->numberArcs);
+    }
+    return moveLookahead;
+}
+
+/** -------------------------------------------------------------------
+ * Get the transposition table of the search AI. It is created the first
+ * time it is needed and kept for the rest of the game.
+ * @return the game's transposition table
+ */
+TranspositionTable * gameTable() {
+    if (searchTable == NULL) {
+        searchTable = tableCreate(TRANSPOSITION_TABLE_BITS);
+    }
+    return searchTable;
+}
+
+/** -------------------------------------------------------------------
+ * Get the proof table of the endgame searches. It is created the first
+ * time it is needed and kept for the rest of the game.
+ * @return the game's proof table
+ */
+ProofTable * gameProofTable() {
+    if (proofTable == NULL) {
+        proofTable = proofTableCreate(PROOF_TABLE_MEGABYTES);
+    }
+    return proofTable;
+}
+
+/** -------------------------------------------------------------------
+ * Get the endgame tablebase. The file is opened the first time it is
+ * needed and kept open for the rest of the game.
+ * @return the game's tablebase, or NULL if there is no tablebase file
+ */
+Tablebase * gameTablebase() {
+    if (!tablebaseOpened) {
+        endgameTablebase = tablebaseOpen(TABLEBASE_FILE);
+        tablebaseOpened = TRUE;
+    }
+    return endgameTablebase;
+}
+
+/** -------------------------------------------------------------------
+ * Get the background search of the search AI. It is created the first
+ * time it is needed and kept for the rest of the game.
+ * @return the game's background search
+ */
+Ponder * gamePonder() {
+    if (ponder == NULL) {
+        ponder = ponderCreate();
+    }
+    return ponder;
+}
+
+/** -------------------------------------------------------------------
+ * Get the node pool of the Monte Carlo AI. It is created the first
+ * time it is needed and kept for the rest of the game.
+ * @return the game's Monte Carlo tree
+ */
+MonteCarloTree * gameMonteCarlo() {
+    if (monteCarloTree == NULL) {
+        monteCarloTree = monteCarloCreate(MONTE_CARLO_TREE_NODES);
     }
-    return locked_graph;
+    return monteCarloTree;
 }
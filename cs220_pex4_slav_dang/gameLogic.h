@@ -25,6 +25,19 @@
 #define NORMAL_EDGE  1 // Normal edge
 #define LOCKED_EDGE  2 // An edge selected by the "SHORT player"
 
+// How the length of a path is measured.
+#define HOP_COST     0 // Every edge costs 1
+#define LENGTH_COST  1 // Every edge costs its length in pixels
+
+// How the AI scores the edges it can play.
+#define BETWEENNESS_SCORE 0 // The number of shortest paths through the edge
+#define CURRENT_SCORE     1 // The current through the edge when every
+                            // normal edge is a 1 ohm resistor
+#define TREE_SCORE        2 // The same current, estimated from random
+                            // spanning trees (see setTreeSamples)
+#define LOOKAHEAD_SCORE   3 // The edge-disjoint paths left once the edge
+                            // is played (see lookahead.h)
+
 // The types of graph vertices.
 #define NORMAL_VERTEX        0
 #define STARTING_VERTEX      1
@@ -50,9 +63,23 @@ typedef struct edge {
 #define SHORT_PLAYER 1
 
 // Each player's turn can be made from user input (HUMAN_PLAYER)
-// or by computer logic (AI_PLAYER).
-#define HUMAN_PLAYER 0
-#define AI_PLAYER    1
+// or by computer logic (AI_PLAYER). A PERFECT_AI_PLAYER uses the
+// theory of the game: either player plays a winning strategy whenever
+// it can win, and plays like an AI_PLAYER otherwise. A
+// SEARCH_AI_PLAYER searches the game tree one move deeper at a time
+// for a set time (see setMoveTime) on boards of up to
+// POSITION_MAX_EDGES edges, and plays like an AI_PLAYER on larger
+// boards. A MONTE_CARLO_AI_PLAYER plays random games for the same time
+// on any board. Once few live edges are left, the Monte Carlo AI first
+// spends part of that time trying to prove a win (see proofNumber.h and
+// setEndgameProof). With only a handful left, every AI that has no
+// winning strategy to follow looks the winning move up in the
+// tablebase file (see tablebase.h).
+#define HUMAN_PLAYER          0
+#define AI_PLAYER             1
+#define PERFECT_AI_PLAYER     2
+#define SEARCH_AI_PLAYER      3
+#define MONTE_CARLO_AI_PLAYER 4
 
 // Game status
 int game_status;
@@ -65,10 +92,48 @@ int game_status;
 /** -------------------------------------------------------------------
  * Set the type of player.
  * @param player Either CUT_PLAYER or SHORT_PLAYER
- * @param type Either HUMAN_PLAYER or AI_PLAYER
+ * @param type HUMAN_PLAYER, AI_PLAYER, PERFECT_AI_PLAYER, SEARCH_AI_PLAYER
+ *             or MONTE_CARLO_AI_PLAYER
  */
 void setPlayerType(int player, int type);
 
+/** -------------------------------------------------------------------
+ * Set how long the search and Monte Carlo AIs think about each move.
+ * @param milliseconds the time per move; must be positive
+ */
+void setMoveTime(int milliseconds);
+
+/** -------------------------------------------------------------------
+ * Set how the length of a path is measured by dijkstra().
+ * @param cost Either HOP_COST or LENGTH_COST
+ */
+void setEdgeCost(int cost);
+
+/** -------------------------------------------------------------------
+ * Set how the AI scores the edges it can play.
+ * @param score BETWEENNESS_SCORE, CURRENT_SCORE, TREE_SCORE or
+ *              LOOKAHEAD_SCORE
+ */
+void setEdgeScore(int score);
+
+/** -------------------------------------------------------------------
+ * Set how many random spanning trees the AI samples to score the edges
+ * with TREE_SCORE. More trees are slower but more exact.
+ * @param trees the number of trees; must be positive
+ */
+void setTreeSamples(int trees);
+
+/** -------------------------------------------------------------------
+ * Set whether an AI tries to prove a win with a proof-number search
+ * once few live edges are left, before it plays as usual. The proof
+ * comes out of the AI's time per move, so its move takes no longer.
+ * Only the Monte Carlo AI does at the start.
+ * @param type AI_PLAYER, PERFECT_AI_PLAYER, SEARCH_AI_PLAYER or
+ *             MONTE_CARLO_AI_PLAYER
+ * @param prove TRUE to try, FALSE not to
+ */
+void setEndgameProof(int type, int prove);
+
 /** -------------------------------------------------------------------
  * Set the active player. This should be called only once at
  * the start of the game to determine who goes first.
@@ -135,18 +200,14 @@ void drawGraph(Graph *graph, HWND hwnd, int labelVertices);
 void doTurn(Graph *graph, int mouseX, int mouseY);
 
 /** -------------------------------------------------------------------
- * Finds the shortest path using the dijkstra algorithm
- * @param graph the graph
- * @return shortest_path - an array of vertices that make up the shortest path
- */
-Path* dijkstra(Graph* graph);
-
-/** -------------------------------------------------------------------
- * Finds all the locked edges and puts it in another adjacency matrix
+ * Finds the shortest path using the dijkstra algorithm. Each edge
+ * costs 1, or its length when setEdgeCost(LENGTH_COST) was called.
  * @param graph the graph
- * @return locked_graph - a graph structure whose edge substructure is
- * the adjacency matrix with all locked edges
+ * @param shortest_path output: the vertices that make up the shortest
+ *                      path, the ending vertex first. Must hold
+ *                      graph->numberVertices entries.
+ * @return the number of vertices on the path; 0 if no path exists
  */
-Graph* locked_edge_graph (Graph* graph);
+int dijkstra(Graph* graph, int* shortest_path);
 
 #endif // GAME_LOGIC_H
\ No newline at end of file
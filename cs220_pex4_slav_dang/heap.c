@@ -0,0 +1,153 @@
+/** heap.c
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The implementation of an indexed binary min-heap.
+ * ===========================================================
+ */
+
+#include <stdlib.h>
+#include "heap.h"
+
+// Local functions
+static void siftUp(Heap *heap, int index);
+static void siftDown(Heap *heap, int index);
+static void place(Heap *heap, int index, int item);
+
+/** -------------------------------------------------------------------
+ * Create an empty heap.
+ * @param capacity the number of different items, [0, capacity-1]
+ * @return a pointer to a heap struct
+ */
+Heap * heapCreate(int capacity) {
+    Heap *heap = malloc(sizeof(Heap));
+    heap->capacity = capacity;
+    heap->size = 0;
+    heap->items = malloc(capacity * sizeof(int));
+    heap->keys = malloc(capacity * sizeof(int));
+    heap->position = malloc(capacity * sizeof(int));
+    for (int item = 0; item < capacity; item++) {
+        heap->position[item] = -1;
+    }
+    return heap;
+}
+
+/** -------------------------------------------------------------------
+ * Delete a heap
+ * @param heap the heap to delete
+ */
+void heapDelete(Heap *heap) {
+    free(heap->items);
+    free(heap->keys);
+    free(heap->position);
+    free(heap);
+}
+
+/** -------------------------------------------------------------------
+ * Insert an item, or lower its key if it is already in the heap.
+ * Nothing happens if the item is in the heap with a smaller key.
+ * @param heap the heap
+ * @param item the item [0, capacity-1]
+ * @param key the item's priority; smaller keys come out first
+ */
+void heapDecreaseKey(Heap *heap, int item, int key) {
+    if (heap->position[item] == -1) {
+        heap->keys[item] = key;
+        place(heap, heap->size, item);
+        heap->size++;
+        siftUp(heap, heap->size - 1);
+    } else if (key < heap->keys[item]) {
+        heap->keys[item] = key;
+        siftUp(heap, heap->position[item]);
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Remove the item with the smallest key.
+ * @param heap the heap; it must not be empty
+ * @return the item that was removed
+ */
+int heapPopMin(Heap *heap) {
+    int item = heap->items[0];
+    heap->position[item] = -1;
+    heap->size--;
+    if (heap->size > 0) {
+        place(heap, 0, heap->items[heap->size]);
+        siftDown(heap, 0);
+    }
+    return item;
+}
+
+/** -------------------------------------------------------------------
+ * Remove every item from a heap. This takes time proportional to the
+ * number of items left in it, not to its capacity.
+ * @param heap the heap
+ */
+void heapClear(Heap *heap) {
+    for (int j = 0; j < heap->size; j++) {
+        heap->position[heap->items[j]] = -1;
+    }
+    heap->size = 0;
+}
+
+/** -------------------------------------------------------------------
+ * Check if a heap is empty.
+ * @param heap the heap
+ * @return TRUE if the heap holds no items
+ */
+int heapIsEmpty(Heap *heap) {
+    return heap->size == 0;
+}
+
+/** -------------------------------------------------------------------
+ * Move an item up until its parent's key is not larger.
+ * @param heap the heap
+ * @param index the position of the item in the heap
+ */
+void siftUp(Heap *heap, int index) {
+    int item = heap->items[index];
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (heap->keys[heap->items[parent]] <= heap->keys[item]) {
+            break;
+        }
+        place(heap, index, heap->items[parent]);
+        index = parent;
+    }
+    place(heap, index, item);
+}
+
+/** -------------------------------------------------------------------
+ * Move an item down until neither child has a smaller key.
+ * @param heap the heap
+ * @param index the position of the item in the heap
+ */
+void siftDown(Heap *heap, int index) {
+    int item = heap->items[index];
+    while (2 * index + 1 < heap->size) {
+        int child = 2 * index + 1;
+        if (child + 1 < heap->size &&
+            heap->keys[heap->items[child+1]] < heap->keys[heap->items[child]]) {
+            child++;
+        }
+        if (heap->keys[item] <= heap->keys[heap->items[child]]) {
+            break;
+        }
+        place(heap, index, heap->items[child]);
+        index = child;
+    }
+    place(heap, index, item);
+}
+
+/** -------------------------------------------------------------------
+ * Put an item at a position in the heap and remember where it is.
+ * @param heap the heap
+ * @param index the position in the heap
+ * @param item the item
+ */
+void place(Heap *heap, int index, int item) {
+    heap->items[index] = item;
+    heap->position[item] = index;
+}
@@ -0,0 +1,69 @@
+/** heap.h
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The definition of an indexed binary min-heap, used as
+ *          the priority queue of Dijkstra's algorithm.
+ * ===========================================================
+ */
+
+#ifndef HEAP_H
+#define HEAP_H
+
+// The items in the heap are the integers [0, capacity-1] (vertex
+// indexes). Each item is in the heap at most once, so its key can be
+// lowered in place.
+typedef struct heap {
+    int   capacity;
+    int   size;
+    int * items;      // The heap, ordered by key
+    int * keys;       // keys[item] is the priority of item
+    int * position;   // position[item] is its index in items, or -1
+} Heap;
+
+/** -------------------------------------------------------------------
+ * Create an empty heap.
+ * @param capacity the number of different items, [0, capacity-1]
+ * @return a pointer to a heap struct
+ */
+Heap * heapCreate(int capacity);
+
+/** -------------------------------------------------------------------
+ * Delete a heap
+ * @param heap the heap to delete
+ */
+void heapDelete(Heap *heap);
+
+/** -------------------------------------------------------------------
+ * Insert an item, or lower its key if it is already in the heap.
+ * Nothing happens if the item is in the heap with a smaller key.
+ * @param heap the heap
+ * @param item the item [0, capacity-1]
+ * @param key the item's priority; smaller keys come out first
+ */
+void heapDecreaseKey(Heap *heap, int item, int key);
+
+/** -------------------------------------------------------------------
+ * Remove the item with the smallest key.
+ * @param heap the heap; it must not be empty
+ * @return the item that was removed
+ */
+int heapPopMin(Heap *heap);
+
+/** -------------------------------------------------------------------
+ * Remove every item from a heap. This takes time proportional to the
+ * number of items left in it, not to its capacity.
+ * @param heap the heap
+ */
+void heapClear(Heap *heap);
+
+/** -------------------------------------------------------------------
+ * Check if a heap is empty.
+ * @param heap the heap
+ * @return TRUE if the heap holds no items
+ */
+int heapIsEmpty(Heap *heap);
+
+#endif // HEAP_H
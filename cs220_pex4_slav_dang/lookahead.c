@@ -0,0 +1,303 @@
+/** lookahead.c
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The implementation of a one-move lookahead that plays
+ *          each candidate edge and counts the edge-disjoint
+ *          paths left, with the candidates shared out among
+ *          the threads of a pool.
+ * ===========================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lookahead.h"
+
+// Local functions
+static void prepare(Lookahead *lookahead, Adjacency *board, Adjacency *locked, int numberWorkers);
+static void lookaheadTask(void *context, int taskIndex, int workerIndex);
+static int countPaths(Lookahead *lookahead, LookaheadWorker *worker, int arc);
+static int findArc(Adjacency *board, int fromVertex, int toVertex);
+
+/** -------------------------------------------------------------------
+ * Create a lookahead.
+ * @param numberVertices the most vertices a board can have
+ * @param numberArcs the most arcs (twice the edges) a board can have
+ * @return a pointer to a lookahead struct
+ */
+Lookahead * lookaheadCreate(int numberVertices, int numberArcs) {
+    Lookahead *lookahead = calloc(1, sizeof(Lookahead));
+    lookahead->capacity = numberVertices;
+    lookahead->arcCapacity = numberArcs;
+    lookahead->reverse = malloc((numberArcs + 1) * sizeof(int));
+    lookahead->locked = malloc((size_t) numberArcs + 1);
+    lookahead->listed = malloc((size_t) numberArcs + 1);
+    lookahead->paths = malloc((numberArcs + 1) * sizeof(int));
+
+    if (lookahead->reverse == NULL || lookahead->locked == NULL || lookahead->listed == NULL ||
+        lookahead->paths == NULL) {
+        printf("ERROR in lookaheadCreate. Not enough memory for %d vertices.\n", numberVertices);
+        exit(1);
+    }
+    return lookahead;
+}
+
+/** -------------------------------------------------------------------
+ * Delete a lookahead
+ * @param lookahead the lookahead to delete
+ */
+void lookaheadDelete(Lookahead *lookahead) {
+    for (int i = 0; i < lookahead->numberWorkers; i++) {
+        free(lookahead->workers[i].flow);
+        free(lookahead->workers[i].parentArc);
+        free(lookahead->workers[i].queue);
+        free(lookahead->workers[i].seen);
+    }
+    free(lookahead->workers);
+    free(lookahead->reverse);
+    free(lookahead->locked);
+    free(lookahead->listed);
+    free(lookahead->paths);
+    free(lookahead);
+}
+
+/** -------------------------------------------------------------------
+ * Play each candidate edge, count the edge-disjoint paths left between
+ * the terminals (vertex 0 and vertex numberVertices-1), and pick the
+ * best edge for the player to move. Ties go to the candidate with the
+ * higher score, then to the one latest in the list.
+ * @param lookahead the lookahead; it must be big enough for the board
+ * @param board the normal and locked edges
+ * @param locked the locked edges
+ * @param playerToMove Either CUT_PLAYER or SHORT_PLAYER
+ * @param candidates the normal edges to try
+ * @param scores a score of each candidate, to break ties
+ * @param numberCandidates the number of candidates
+ * @param pool the threads that try them
+ * @param edge output: the best candidate
+ * @param statistics output, may be NULL
+ * @return TRUE if an edge was picked. Return FALSE if there were no
+ *         candidates.
+ */
+int lookaheadMove(Lookahead *lookahead, Adjacency *board, Adjacency *locked, int playerToMove,
+                  Edge *candidates, double *scores, int numberCandidates, ThreadPool *pool,
+                  Edge *edge, LookaheadStatistics *statistics) {
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    LONGLONG start = ticks();
+
+    prepare(lookahead, board, locked, pool->numberThreads);
+    lookahead->playerToMove = playerToMove;
+    lookahead->candidates = candidates;
+    lookahead->numberCandidates = numberCandidates;
+    threadPoolFor(pool, numberCandidates, lookaheadTask, lookahead);
+
+    // The same candidate wins however the tasks were shared out
+    int best = -1;
+    for (int k = numberCandidates - 1; k >= 0; k--) {
+        int paths = lookahead->paths[k];
+        if (best == -1 ||
+            (playerToMove == CUT_PLAYER && paths < lookahead->paths[best]) ||
+            (playerToMove == SHORT_PLAYER && paths > lookahead->paths[best]) ||
+            (paths == lookahead->paths[best] && scores[k] > scores[best])) {
+            best = k;
+        }
+    }
+    if (best != -1) {
+        *edge = candidates[best];
+    }
+
+    if (statistics != NULL) {
+        statistics->candidates = numberCandidates;
+        statistics->searches = 0;
+        for (int i = 0; i < lookahead->numberWorkers; i++) {
+            statistics->searches += lookahead->workers[i].searches;
+        }
+        statistics->milliseconds = (ticks() - start) * 1000.0 / frequency.QuadPart;
+    }
+    return best != -1;
+}
+
+/** -------------------------------------------------------------------
+ * Add to a list of candidates every normal edge that carries flow in a
+ * maximum flow between the terminals (up to LOOKAHEAD_MOST_PATHS
+ * paths) and is not in the list yet. The edges added get a score of 0.
+ * @param lookahead the lookahead; it must be big enough for the board
+ * @param board the normal and locked edges
+ * @param locked the locked edges
+ * @param candidates the list; it must have room for every edge
+ * @param scores the score of each candidate
+ * @param numberCandidates the number of candidates in the list
+ * @return the number of candidates in the list now
+ */
+int lookaheadAddFlowEdges(Lookahead *lookahead, Adjacency *board, Adjacency *locked,
+                          Edge *candidates, double *scores, int numberCandidates) {
+    prepare(lookahead, board, locked, 1);
+    memset(lookahead->listed, 0, (size_t) board->numberArcs);
+    for (int i = 0; i < numberCandidates; i++) {
+        int arc = findArc(board, candidates[i].fromVertex, candidates[i].toVertex);
+        lookahead->listed[arc] = TRUE;
+        lookahead->listed[lookahead->reverse[arc]] = TRUE;
+    }
+
+    // The flow of the board as it is, with no edge played
+    LookaheadWorker *worker = &lookahead->workers[0];
+    lookahead->playerToMove = CUT_PLAYER;
+    countPaths(lookahead, worker, -1);
+    for (int u = 0; u < board->numberVertices; u++) {
+        for (int k = board->offsets[u]; k < board->offsets[u+1]; k++) {
+            if (worker->flow[k] > 0 && !lookahead->locked[k] && !lookahead->listed[k]) {
+                candidates[numberCandidates].fromVertex = u;
+                candidates[numberCandidates].toVertex = board->neighbors[k];
+                scores[numberCandidates] = 0.0;
+                numberCandidates++;
+                lookahead->listed[k] = TRUE;
+                lookahead->listed[lookahead->reverse[k]] = TRUE;
+            }
+        }
+    }
+    return numberCandidates;
+}
+
+/** -------------------------------------------------------------------
+ * Get the lookahead ready for a board: give each worker its memory,
+ * and pair up the arcs and mark the locked ones.
+ * @param lookahead the lookahead; it must be big enough for the board
+ * @param board the normal and locked edges
+ * @param locked the locked edges
+ * @param numberWorkers the workers that will run
+ */
+void prepare(Lookahead *lookahead, Adjacency *board, Adjacency *locked, int numberWorkers) {
+    int n = board->numberVertices;
+    if (n > lookahead->capacity || board->numberArcs > lookahead->arcCapacity) {
+        printf("ERROR in lookaheadMove. The board has too many vertices or edges.\n");
+        exit(1);
+    }
+
+    // Each worker of the pool gets its own memory the first time
+    if (lookahead->numberWorkers < numberWorkers) {
+        lookahead->workers = realloc(lookahead->workers, numberWorkers * sizeof(LookaheadWorker));
+        for (int i = lookahead->numberWorkers; i < numberWorkers; i++) {
+            LookaheadWorker *worker = &lookahead->workers[i];
+            worker->flow = malloc((lookahead->arcCapacity + 1) * sizeof(int));
+            worker->parentArc = malloc(lookahead->capacity * sizeof(int));
+            worker->queue = malloc(lookahead->capacity * sizeof(int));
+            worker->seen = calloc((size_t) lookahead->capacity, sizeof(unsigned int));
+            worker->generation = 0;
+        }
+        lookahead->numberWorkers = numberWorkers;
+    }
+    for (int i = 0; i < lookahead->numberWorkers; i++) {
+        lookahead->workers[i].searches = 0;
+    }
+
+    // Pair each arc with the one back along the same edge, and mark the
+    // arcs of the locked edges
+    memset(lookahead->locked, 0, (size_t) board->numberArcs);
+    for (int u = 0; u < n; u++) {
+        for (int k = board->offsets[u]; k < board->offsets[u+1]; k++) {
+            lookahead->reverse[k] = findArc(board, board->neighbors[k], u);
+        }
+        for (int k = locked->offsets[u]; k < locked->offsets[u+1]; k++) {
+            lookahead->locked[findArc(board, u, locked->neighbors[k])] = TRUE;
+        }
+    }
+
+    lookahead->board = board;
+}
+
+/** -------------------------------------------------------------------
+ * Score one candidate on the memory of the worker running it.
+ * @param context the lookahead
+ * @param taskIndex the index of the candidate
+ * @param workerIndex the index of the worker
+ */
+void lookaheadTask(void *context, int taskIndex, int workerIndex) {
+    Lookahead *lookahead = context;
+    Edge *candidate = &lookahead->candidates[taskIndex];
+    int arc = findArc(lookahead->board, candidate->fromVertex, candidate->toVertex);
+    lookahead->paths[taskIndex] = countPaths(lookahead, &lookahead->workers[workerIndex], arc);
+}
+
+/** -------------------------------------------------------------------
+ * Count the edge-disjoint paths between the terminals once an edge is
+ * played, up to LOOKAHEAD_MOST_PATHS. Each search finds a shortest path
+ * in the residual board and sends one unit of flow along it; the arcs
+ * of locked edges, and of the edge if Short locks it, have unlimited
+ * room.
+ * @param lookahead the lookahead
+ * @param worker the memory of the worker
+ * @param arc an arc of the edge played, or -1 to play none
+ * @return the number of paths, or LOOKAHEAD_MOST_PATHS+1 if the move
+ *         joins the terminals by locked edges
+ */
+int countPaths(Lookahead *lookahead, LookaheadWorker *worker, int arc) {
+    Adjacency *board = lookahead->board;
+    int end = board->numberVertices - 1;
+    int back = (arc >= 0) ? lookahead->reverse[arc] : -1;
+    int locks = (lookahead->playerToMove == SHORT_PLAYER);
+    memset(worker->flow, 0, board->numberArcs * sizeof(int));
+
+    int paths = 0;
+    while (paths < LOOKAHEAD_MOST_PATHS) {
+        unsigned int generation = ++worker->generation;
+        worker->searches++;
+        int head = 0;
+        int tail = 0;
+        worker->seen[0] = generation;
+        worker->queue[tail++] = 0;
+        while (head < tail && worker->seen[end] != generation) {
+            int x = worker->queue[head++];
+            for (int k = board->offsets[x]; k < board->offsets[x+1]; k++) {
+                int y = board->neighbors[k];
+                int played = (k == arc || k == back);
+                int open = lookahead->locked[k] || (played ? locks : worker->flow[k] < 1);
+                if (open && worker->seen[y] != generation) {
+                    worker->seen[y] = generation;
+                    worker->parentArc[y] = k;
+                    worker->queue[tail++] = y;
+                }
+            }
+        }
+        if (worker->seen[end] != generation) {
+            break;
+        }
+
+        // Send the unit back from the end; a path with no normal edge
+        // on it means Short has won
+        int limited = FALSE;
+        for (int y = end; y != 0; ) {
+            int k = worker->parentArc[y];
+            if (!lookahead->locked[k] && k != arc && k != back) {
+                worker->flow[k]++;
+                worker->flow[lookahead->reverse[k]]--;
+                limited = TRUE;
+            }
+            y = board->neighbors[lookahead->reverse[k]];
+        }
+        if (!limited) {
+            return LOOKAHEAD_MOST_PATHS + 1;
+        }
+        paths++;
+    }
+    return paths;
+}
+
+/** -------------------------------------------------------------------
+ * Find the arc from one vertex to another.
+ * @param board the board
+ * @param fromVertex the vertex the arc leaves
+ * @param toVertex the vertex it goes to
+ * @return the index of the arc, or -1 if there is no such edge
+ */
+int findArc(Adjacency *board, int fromVertex, int toVertex) {
+    for (int k = board->offsets[fromVertex]; k < board->offsets[fromVertex+1]; k++) {
+        if (board->neighbors[k] == toVertex) {
+            return k;
+        }
+    }
+    return -1;
+}
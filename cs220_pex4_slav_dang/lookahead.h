@@ -0,0 +1,131 @@
+/** lookahead.h
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The definition of a one-move lookahead that plays
+ *          each candidate edge and counts the edge-disjoint
+ *          paths left, with the candidates shared out among
+ *          the threads of a pool.
+ * ===========================================================
+ */
+
+#ifndef LOOKAHEAD_H
+#define LOOKAHEAD_H
+
+#include <windows.h>
+#include "Graph.h"
+#include "gameLogic.h"
+#include "threadPool.h"
+
+// The most edge-disjoint paths counted; boards with more are all
+// scored the same
+#define LOOKAHEAD_MOST_PATHS  16
+
+// The number of edge-disjoint paths between the terminals is the
+// number of normal edges Cut must still remove to win (locked edges
+// cannot be cut, so any number of paths may share one). Cut wants to
+// leave as few as possible, and Short as many.
+//
+// Only an edge that carries flow in a maximum flow between the
+// terminals can change the number of paths: cutting an edge with no
+// flow leaves the flow as it is, and locking one cannot add a path,
+// since a path through it would already have been found. These edges
+// are the candidates, along with the edges on a shortest path.
+//
+// Each candidate edge is scored on its own: it is locked or cut, and
+// the paths are counted by augmenting along shortest paths in the
+// residual board (Ford-Fulkerson with breadth-first search) until
+// there are no more. The candidates are independent, so they are
+// handed out to the workers of a thread pool, each with its own flow
+// and search memory. Every score is exact and the best one is picked
+// afterwards in the order of the candidates, so the move does not
+// depend on the number of threads.
+
+// The scratch memory of one worker.
+typedef struct lookaheadWorker {
+    int * flow;                 // The flow along each arc: 1, 0 or -1
+    int * parentArc;            // The arc a search reached each vertex by
+    int * queue;
+    unsigned int * seen;        // == generation once a search reaches it
+    unsigned int generation;
+    long long searches;         // The searches the worker ran
+} LookaheadWorker;
+
+typedef struct lookahead {
+    int capacity;               // The number of vertices the buffers hold
+    int arcCapacity;            // The number of arcs the buffers hold
+    int numberWorkers;          // The workers that have memory so far
+    LookaheadWorker * workers;
+
+    // The board of the current move
+    Adjacency * board;
+    int * reverse;              // The arc back along the same edge
+    char * locked;              // TRUE for the arcs of locked edges
+    char * listed;              // TRUE for the arcs of the candidates
+    int playerToMove;
+    Edge * candidates;
+    int numberCandidates;
+    int * paths;                // The paths left after each candidate
+} Lookahead;
+
+// What one move took.
+typedef struct lookaheadStatistics {
+    int candidates;
+    long long searches;         // Breadth-first searches, over all workers
+    double milliseconds;
+} LookaheadStatistics;
+
+/** -------------------------------------------------------------------
+ * Create a lookahead.
+ * @param numberVertices the most vertices a board can have
+ * @param numberArcs the most arcs (twice the edges) a board can have
+ * @return a pointer to a lookahead struct
+ */
+Lookahead * lookaheadCreate(int numberVertices, int numberArcs);
+
+/** -------------------------------------------------------------------
+ * Delete a lookahead
+ * @param lookahead the lookahead to delete
+ */
+void lookaheadDelete(Lookahead *lookahead);
+
+/** -------------------------------------------------------------------
+ * Add to a list of candidates every normal edge that carries flow in a
+ * maximum flow between the terminals (up to LOOKAHEAD_MOST_PATHS
+ * paths) and is not in the list yet. The edges added get a score of 0.
+ * @param lookahead the lookahead; it must be big enough for the board
+ * @param board the normal and locked edges
+ * @param locked the locked edges
+ * @param candidates the list; it must have room for every edge
+ * @param scores the score of each candidate
+ * @param numberCandidates the number of candidates in the list
+ * @return the number of candidates in the list now
+ */
+int lookaheadAddFlowEdges(Lookahead *lookahead, Adjacency *board, Adjacency *locked,
+                          Edge *candidates, double *scores, int numberCandidates);
+
+/** -------------------------------------------------------------------
+ * Play each candidate edge, count the edge-disjoint paths left between
+ * the terminals (vertex 0 and vertex numberVertices-1), and pick the
+ * best edge for the player to move. Ties go to the candidate with the
+ * higher score, then to the one latest in the list.
+ * @param lookahead the lookahead; it must be big enough for the board
+ * @param board the normal and locked edges
+ * @param locked the locked edges
+ * @param playerToMove Either CUT_PLAYER or SHORT_PLAYER
+ * @param candidates the normal edges to try
+ * @param scores a score of each candidate, to break ties
+ * @param numberCandidates the number of candidates
+ * @param pool the threads that try them
+ * @param edge output: the best candidate
+ * @param statistics output, may be NULL
+ * @return TRUE if an edge was picked. Return FALSE if there were no
+ *         candidates.
+ */
+int lookaheadMove(Lookahead *lookahead, Adjacency *board, Adjacency *locked, int playerToMove,
+                  Edge *candidates, double *scores, int numberCandidates, ThreadPool *pool,
+                  Edge *edge, LookaheadStatistics *statistics);
+
+#endif // LOOKAHEAD_H
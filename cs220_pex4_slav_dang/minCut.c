@@ -0,0 +1,511 @@
+/** minCut.c
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The implementation of a maximum flow between the two
+ *          terminals, kept up to date between turns, that
+ *          gives Cut a minimum cut to play in.
+ * ===========================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "minCut.h"
+#include "treePacking.h"
+
+// The direction of a walk along the flow
+#define FORWARD   0
+#define BACKWARD  1
+
+// Local functions
+static int capacity(Graph *graph, int u, int v);
+static void maximize(MinCut *cut, Graph *graph);
+static int buildLevels(MinCut *cut, Graph *graph);
+static int pushPath(MinCut *cut, Graph *graph);
+static void removeFlow(MinCut *cut, Graph *graph, int a, int b);
+static int residualPath(MinCut *cut, Graph *graph, int from, int to);
+static void cancelUnit(MinCut *cut, Graph *graph, int start, int direction);
+static void addFlow(MinCut *cut, int u, int v, int amount);
+static int cutStillWins(Graph *graph, int fromVertex, int toVertex);
+
+/** -------------------------------------------------------------------
+ * Create a min cut finder. The flow is found on the first call to
+ * minCutMove().
+ * @param numberVertices the number of vertices of the board
+ * @return a pointer to a min cut struct
+ */
+MinCut * minCutCreate(int numberVertices) {
+    MinCut *cut = calloc(1, sizeof(MinCut));
+    cut->numberVertices = numberVertices;
+    cut->flow = malloc(numberVertices * sizeof(int *));
+    for (int v = 0; v < numberVertices; v++) {
+        cut->flow[v] = calloc((size_t) numberVertices, sizeof(int));
+    }
+    cut->level = malloc(numberVertices * sizeof(int));
+    cut->arc = malloc(numberVertices * sizeof(int));
+    cut->parent = malloc(numberVertices * sizeof(int));
+    cut->queue = malloc(numberVertices * sizeof(int));
+    cut->stack = malloc(numberVertices * sizeof(int));
+    cut->sourceSide = calloc((size_t) numberVertices, sizeof(int));
+    cut->sinkSide = calloc((size_t) numberVertices, sizeof(int));
+    return cut;
+}
+
+/** -------------------------------------------------------------------
+ * Delete a min cut finder
+ * @param cut the min cut finder to delete
+ */
+void minCutDelete(MinCut *cut) {
+    for (int v = 0; v < cut->numberVertices; v++) {
+        free(cut->flow[v]);
+    }
+    free(cut->flow);
+    free(cut->level);
+    free(cut->arc);
+    free(cut->parent);
+    free(cut->queue);
+    free(cut->stack);
+    free(cut->sourceSide);
+    free(cut->sinkSide);
+    free(cut);
+}
+
+/** -------------------------------------------------------------------
+ * Update the flow after a move. Call it after the edge state has been
+ * changed on the board.
+ * @param cut the min cut finder
+ * @param graph the board
+ * @param fromVertex one end of the edge
+ * @param toVertex the other end of the edge
+ * @param state the new state of the edge
+ */
+void minCutObserve(MinCut *cut, Graph *graph, int fromVertex, int toVertex, int state) {
+    if (!cut->valid || cut->graph != graph) {
+        return;
+    }
+
+    if (state == NO_EDGE) {
+        removeFlow(cut, graph, fromVertex, toVertex);
+    } else if (state == LOCKED_EDGE) {
+        cut->augment = TRUE; // The edge can carry more flow now
+    } else {
+        cut->valid = FALSE;
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Find Cut's move in a minimum cut. Edges that are in every minimum
+ * cut (no augmenting path can go around them once they are gone) are
+ * picked first.
+ * @param cut the min cut finder
+ * @param graph the board
+ * @param edge output: the edge to cut
+ * @return TRUE if an edge was found. Return FALSE if the game is over.
+ */
+int minCutMove(MinCut *cut, Graph *graph, Edge *edge) {
+    int n = graph->numberVertices;
+    if (n > cut->numberVertices) {
+        return FALSE; // The finder was created for a smaller board
+    }
+
+    // Start from no flow on a new board, or if the flow was lost
+    if (!cut->valid || cut->graph != graph) {
+        for (int v = 0; v < n; v++) {
+            memset(cut->flow[v], 0, n * sizeof(int));
+        }
+        cut->graph = graph;
+        cut->flowValue = 0;
+        cut->fullSolves++;
+        cut->valid = TRUE;
+        cut->augment = TRUE;
+    }
+    if (cut->augment) {
+        maximize(cut, graph);
+        cut->augment = FALSE;
+    }
+    if (cut->flowValue == 0 || cut->flowValue >= n * n) {
+        return FALSE; // The terminals are apart, or joined by locked edges
+    }
+
+    // The vertices that can still be reached from the start, and the
+    // vertices that can still reach the end, in the residual graph
+    int generation = ++cut->generation;
+    int head = 0;
+    int tail = 0;
+    cut->queue[tail++] = n - 1;
+    cut->sinkSide[n-1] = generation;
+    while (head < tail) {
+        int y = cut->queue[head++];
+        for (int j = 0; j < graph->degree[y]; j++) {
+            int x = graph->neighbors[y][j];
+            if (cut->sinkSide[x] != generation && capacity(graph, x, y) > cut->flow[x][y]) {
+                cut->sinkSide[x] = generation;
+                cut->queue[tail++] = x;
+            }
+        }
+    }
+
+    head = 0;
+    tail = 0;
+    cut->queue[tail++] = 0;
+    cut->sourceSide[0] = generation;
+    while (head < tail) {
+        int x = cut->queue[head++];
+        for (int j = 0; j < graph->degree[x]; j++) {
+            int y = graph->neighbors[x][j];
+            if (cut->sourceSide[y] != generation && capacity(graph, x, y) > cut->flow[x][y]) {
+                cut->sourceSide[y] = generation;
+                cut->queue[tail++] = y;
+            }
+        }
+    }
+
+    // The edges that leave the source side form a minimum cut. If the
+    // far end can reach the end vertex, the edge is in every one.
+    int found = FALSE;
+    for (int i = 0; i < tail; i++) {
+        int x = cut->queue[i];
+        for (int j = 0; j < graph->degree[x]; j++) {
+            int y = graph->neighbors[x][j];
+            if (cut->sourceSide[y] != generation && graph->edges[x][y] == NORMAL_EDGE) {
+                if (!found || cut->sinkSide[y] == generation) {
+                    edge->fromVertex = x;
+                    edge->toVertex = y;
+                    found = TRUE;
+                }
+                if (cut->sinkSide[y] == generation) {
+                    return TRUE;
+                }
+            }
+        }
+    }
+    return found;
+}
+
+/** -------------------------------------------------------------------
+ * Find a winning move for Cut, if Cut can win. Every edge tried is
+ * checked with the Lehman solver, so this is exact. The edge of
+ * minCutMove() is tried first, then every other live edge; one of them
+ * wins whenever Cut can win, since cutting a live edge is never worse
+ * than cutting a dead one. The board is changed while an edge is
+ * tried, but is the same again on return.
+ * @param cut the min cut finder
+ * @param contraction the contracted board, to tell which edges are live
+ * @param graph the board; Cut is to move
+ * @param edge output: the edge to cut
+ * @return TRUE if Cut can win. Return FALSE if Cut loses with perfect
+ *         play, or the game is over.
+ */
+int minCutWinningMove(MinCut *cut, Contraction *contraction, Graph *graph, Edge *edge) {
+    TreePacking *packing = lehmanSolve(graph, CUT_PLAYER);
+    int winner = packing->winner;
+    treePackingDelete(packing);
+    if (winner != CUT_WINS) {
+        return FALSE;
+    }
+    if (minCutMove(cut, graph, edge) && cutStillWins(graph, edge->fromVertex, edge->toVertex)) {
+        return TRUE;
+    }
+
+    // Trying an edge takes it out of the neighbor lists and puts it back
+    // at the end, so the live edges are all listed before any is tried
+    int numberEdges = graphNumberEdges(graph);
+    Edge *candidates = malloc((numberEdges + 1) * sizeof(Edge));
+    if (candidates == NULL) {
+        printf("ERROR in minCutWinningMove. Out of memory.\n");
+        exit(1);
+    }
+    int numberCandidates = 0;
+    for (int u = 0; u < graph->numberVertices; u++) {
+        for (int j = 0; j < graph->degree[u]; j++) {
+            int v = graph->neighbors[u][j];
+            if (u < v && graph->edges[u][v] == NORMAL_EDGE &&
+                contractionIsLive(contraction, graph, u, v)) {
+                candidates[numberCandidates].fromVertex = u;
+                candidates[numberCandidates].toVertex = v;
+                numberCandidates++;
+            }
+        }
+    }
+
+    int found = FALSE;
+    for (int i = 0; i < numberCandidates && !found; i++) {
+        if (cutStillWins(graph, candidates[i].fromVertex, candidates[i].toVertex)) {
+            *edge = candidates[i];
+            found = TRUE;
+        }
+    }
+    free(candidates);
+    return found; // FALSE only if the game is over
+}
+
+/** -------------------------------------------------------------------
+ * Tell if Cut still wins after cutting an edge, with Short to move.
+ * The edge is put back before returning, and the flow is not told
+ * about it.
+ * @param graph the board
+ * @param fromVertex one end of a normal edge
+ * @param toVertex the other end of the edge
+ * @return TRUE if Cut wins after cutting the edge
+ */
+int cutStillWins(Graph *graph, int fromVertex, int toVertex) {
+    graphSetEdge(graph, fromVertex, toVertex, NO_EDGE);
+    graphSetEdge(graph, toVertex, fromVertex, NO_EDGE);
+    TreePacking *packing = lehmanSolve(graph, SHORT_PLAYER);
+    int winner = packing->winner;
+    treePackingDelete(packing);
+    graphSetEdge(graph, fromVertex, toVertex, NORMAL_EDGE);
+    graphSetEdge(graph, toVertex, fromVertex, NORMAL_EDGE);
+    return winner == CUT_WINS;
+}
+
+/** -------------------------------------------------------------------
+ * Get the capacity of an edge.
+ * @param graph the board
+ * @param u one end of the edge
+ * @param v the other end of the edge
+ * @return 1 for a normal edge, more than any cut for a locked edge
+ */
+int capacity(Graph *graph, int u, int v) {
+    int state = graph->edges[u][v];
+    if (state == LOCKED_EDGE) {
+        return graph->numberVertices * graph->numberVertices;
+    }
+    return state == NORMAL_EDGE ? 1 : 0;
+}
+
+/** -------------------------------------------------------------------
+ * Dinic's algorithm: add flow along shortest augmenting paths, one
+ * level graph at a time, until the end vertex cannot be reached. It
+ * starts from whatever flow is already there.
+ * @param cut the min cut finder
+ * @param graph the board
+ */
+void maximize(MinCut *cut, Graph *graph) {
+    int n = graph->numberVertices;
+    while (cut->flowValue < n * n && buildLevels(cut, graph)) {
+        for (int v = 0; v < n; v++) {
+            cut->arc[v] = 0;
+        }
+        int amount;
+        while (cut->flowValue < n * n && (amount = pushPath(cut, graph)) > 0) {
+            cut->flowValue += amount;
+        }
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Find the distance of each vertex from the start in the residual
+ * graph.
+ * @param cut the min cut finder
+ * @param graph the board
+ * @return TRUE if the end vertex can be reached
+ */
+int buildLevels(MinCut *cut, Graph *graph) {
+    int n = graph->numberVertices;
+    for (int v = 0; v < n; v++) {
+        cut->level[v] = -1;
+    }
+    int head = 0;
+    int tail = 0;
+    cut->queue[tail++] = 0;
+    cut->level[0] = 0;
+    while (head < tail) {
+        int x = cut->queue[head++];
+        for (int j = 0; j < graph->degree[x]; j++) {
+            int y = graph->neighbors[x][j];
+            if (cut->level[y] == -1 && capacity(graph, x, y) > cut->flow[x][y]) {
+                cut->level[y] = cut->level[x] + 1;
+                cut->queue[tail++] = y;
+            }
+        }
+    }
+    return cut->level[n-1] != -1;
+}
+
+/** -------------------------------------------------------------------
+ * Push flow along one path of the level graph. Each vertex remembers
+ * the next edge to try (arc), and a vertex that leads nowhere is
+ * taken out of the level graph, so each phase takes O(VE) time.
+ * @param cut the min cut finder
+ * @param graph the board
+ * @return the amount pushed, or 0 if the level graph has no more paths
+ */
+int pushPath(MinCut *cut, Graph *graph) {
+    int end = graph->numberVertices - 1;
+    int *stack = cut->stack;
+    int top = 0;
+    stack[0] = 0;
+
+    while (top >= 0) {
+        int x = stack[top];
+        if (x == end) {
+            int amount = graph->numberVertices * graph->numberVertices;
+            for (int i = 0; i < top; i++) {
+                int residual = capacity(graph, stack[i], stack[i+1]) - cut->flow[stack[i]][stack[i+1]];
+                if (residual < amount) {
+                    amount = residual;
+                }
+            }
+            for (int i = 0; i < top; i++) {
+                addFlow(cut, stack[i], stack[i+1], amount);
+            }
+            return amount;
+        }
+
+        int advanced = FALSE;
+        while (cut->arc[x] < graph->degree[x]) {
+            int y = graph->neighbors[x][cut->arc[x]];
+            if (cut->level[y] == cut->level[x] + 1 &&
+                capacity(graph, x, y) > cut->flow[x][y]) {
+                stack[++top] = y;
+                advanced = TRUE;
+                break;
+            }
+            cut->arc[x]++;
+        }
+        if (!advanced) {
+            cut->level[x] = -1; // A dead end
+            top--;
+            if (top >= 0) {
+                cut->arc[stack[top]]++;
+            }
+        }
+    }
+    return 0;
+}
+
+/** -------------------------------------------------------------------
+ * Take a cut edge out of the flow. If it carried a unit from a to b,
+ * that unit is sent around the edge when possible. Otherwise it is
+ * taken back along the flow on both sides, and the next move looks
+ * for an augmenting path again.
+ * @param cut the min cut finder
+ * @param graph the board, with the edge already cut
+ * @param a one end of the edge
+ * @param b the other end of the edge
+ */
+void removeFlow(MinCut *cut, Graph *graph, int a, int b) {
+    int amount = cut->flow[a][b];
+    cut->flow[a][b] = 0;
+    cut->flow[b][a] = 0;
+    if (amount == 0) {
+        return;
+    }
+    if (amount < 0) {
+        int swap = a;
+        a = b;
+        b = swap;
+    }
+
+    // a has a unit too many and b has a unit too few
+    if (residualPath(cut, graph, a, b)) {
+        for (int v = b; v != a; v = cut->parent[v]) {
+            addFlow(cut, cut->parent[v], v, 1);
+        }
+        return;
+    }
+
+    int end = graph->numberVertices - 1;
+    if (a != 0 && a != end) {
+        cancelUnit(cut, graph, a, BACKWARD);
+    }
+    if (b != 0 && b != end) {
+        cancelUnit(cut, graph, b, FORWARD);
+    }
+    cut->flowValue = 0;
+    for (int j = 0; j < graph->degree[0]; j++) {
+        cut->flowValue += cut->flow[0][graph->neighbors[0][j]];
+    }
+    cut->augment = TRUE;
+}
+
+/** -------------------------------------------------------------------
+ * Search for a path with room for one more unit of flow.
+ * @param cut the min cut finder
+ * @param graph the board
+ * @param from the first vertex of the path
+ * @param to the last vertex of the path
+ * @return TRUE if there is a path; parent[] leads back along it
+ */
+int residualPath(MinCut *cut, Graph *graph, int from, int to) {
+    int generation = ++cut->generation;
+    int head = 0;
+    int tail = 0;
+    cut->queue[tail++] = from;
+    cut->sourceSide[from] = generation;
+    while (head < tail) {
+        int x = cut->queue[head++];
+        for (int j = 0; j < graph->degree[x]; j++) {
+            int y = graph->neighbors[x][j];
+            if (cut->sourceSide[y] != generation && capacity(graph, x, y) > cut->flow[x][y]) {
+                cut->sourceSide[y] = generation;
+                cut->parent[y] = x;
+                if (y == to) {
+                    return TRUE;
+                }
+                cut->queue[tail++] = y;
+            }
+        }
+    }
+    return FALSE;
+}
+
+/** -------------------------------------------------------------------
+ * Take one unit of flow off a path between a vertex and a terminal.
+ * The flow into a vertex with too much flow must come from a
+ * terminal, and the flow out of a vertex with too little must reach
+ * one, so the path always exists.
+ * @param cut the min cut finder
+ * @param graph the board
+ * @param start the vertex that is out of balance
+ * @param direction BACKWARD to walk against the flow (too much flow),
+ *                  FORWARD to walk with it (too little flow)
+ */
+void cancelUnit(MinCut *cut, Graph *graph, int start, int direction) {
+    int end = graph->numberVertices - 1;
+    int generation = ++cut->generation;
+    int head = 0;
+    int tail = 0;
+    int terminal = -1;
+    cut->queue[tail++] = start;
+    cut->sinkSide[start] = generation;
+    while (head < tail && terminal == -1) {
+        int x = cut->queue[head++];
+        for (int j = 0; j < graph->degree[x] && terminal == -1; j++) {
+            int y = graph->neighbors[x][j];
+            int along = (direction == FORWARD) ? cut->flow[x][y] : cut->flow[y][x];
+            if (cut->sinkSide[y] != generation && along > 0) {
+                cut->sinkSide[y] = generation;
+                cut->parent[y] = x;
+                if (y == 0 || y == end) {
+                    terminal = y;
+                }
+                cut->queue[tail++] = y;
+            }
+        }
+    }
+
+    for (int v = terminal; v != start && v != -1; v = cut->parent[v]) {
+        if (direction == FORWARD) {
+            addFlow(cut, cut->parent[v], v, -1);
+        } else {
+            addFlow(cut, v, cut->parent[v], -1);
+        }
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Add flow along an edge, keeping flow[u][v] == -flow[v][u].
+ * @param cut the min cut finder
+ * @param u the tail of the edge
+ * @param v the head of the edge
+ * @param amount the flow to add (can be negative)
+ */
+void addFlow(MinCut *cut, int u, int v, int amount) {
+    cut->flow[u][v] += amount;
+    cut->flow[v][u] -= amount;
+}
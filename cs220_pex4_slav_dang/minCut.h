@@ -0,0 +1,104 @@
+/** minCut.h
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The definition of a maximum flow between the two
+ *          terminals, kept up to date between turns, that
+ *          gives Cut a minimum cut to play in.
+ * ===========================================================
+ */
+
+#ifndef MIN_CUT_H
+#define MIN_CUT_H
+
+#include "Graph.h"
+#include "gameLogic.h"
+#include "contraction.h"
+
+// Every normal edge can carry one unit of flow in either direction. A
+// locked edge can never be cut, so it gets a capacity larger than any
+// cut (this is the same as contracting it). By the max-flow min-cut
+// theorem the flow from the starting to the ending vertex equals the
+// fewest edges Cut must still remove.
+//
+// The flow is found with Dinic's algorithm once, and then only
+// repaired: cutting an edge with flow on it reroutes or cancels that
+// one unit, and locking an edge lets Dinic's algorithm continue from
+// the flow it already has.
+typedef struct minCut {
+    Graph * graph;          // The board the flow belongs to
+    int numberVertices;
+    int valid;              // FALSE until the first maximum flow, or
+                            //   after a change the flow cannot follow
+    int augment;            // TRUE if an edge was locked since the
+                            //   flow was last maximum
+    int ** flow;            // flow[u][v] == -flow[v][u]
+    int flowValue;          // The flow out of the starting vertex
+    int fullSolves;         // The number of times Dinic's algorithm
+                            //   started from no flow
+
+    int generation;         // Scratch space of the searches
+    int * level;
+    int * arc;
+    int * parent;
+    int * queue;
+    int * stack;
+    int * sourceSide;       // == generation if reachable from the start
+    int * sinkSide;         // == generation if the end is reachable
+} MinCut;
+
+/** -------------------------------------------------------------------
+ * Create a min cut finder. The flow is found on the first call to
+ * minCutMove().
+ * @param numberVertices the number of vertices of the board
+ * @return a pointer to a min cut struct
+ */
+MinCut * minCutCreate(int numberVertices);
+
+/** -------------------------------------------------------------------
+ * Delete a min cut finder
+ * @param cut the min cut finder to delete
+ */
+void minCutDelete(MinCut *cut);
+
+/** -------------------------------------------------------------------
+ * Update the flow after a move. Call it after the edge state has been
+ * changed on the board.
+ * @param cut the min cut finder
+ * @param graph the board
+ * @param fromVertex one end of the edge
+ * @param toVertex the other end of the edge
+ * @param state the new state of the edge
+ */
+void minCutObserve(MinCut *cut, Graph *graph, int fromVertex, int toVertex, int state);
+
+/** -------------------------------------------------------------------
+ * Find Cut's move in a minimum cut. Edges that are in every minimum
+ * cut (no augmenting path can go around them once they are gone) are
+ * picked first.
+ * @param cut the min cut finder
+ * @param graph the board
+ * @param edge output: the edge to cut
+ * @return TRUE if an edge was found. Return FALSE if the game is over.
+ */
+int minCutMove(MinCut *cut, Graph *graph, Edge *edge);
+
+/** -------------------------------------------------------------------
+ * Find a winning move for Cut, if Cut can win. Every edge tried is
+ * checked with the Lehman solver, so this is exact. The edge of
+ * minCutMove() is tried first, then every other live edge; one of them
+ * wins whenever Cut can win, since cutting a live edge is never worse
+ * than cutting a dead one. The board is changed while an edge is
+ * tried, but is the same again on return.
+ * @param cut the min cut finder
+ * @param contraction the contracted board, to tell which edges are live
+ * @param graph the board; Cut is to move
+ * @param edge output: the edge to cut
+ * @return TRUE if Cut can win. Return FALSE if Cut loses with perfect
+ *         play, or the game is over.
+ */
+int minCutWinningMove(MinCut *cut, Contraction *contraction, Graph *graph, Edge *edge);
+
+#endif // MIN_CUT_H
@@ -0,0 +1,636 @@
+/** monteCarlo.c
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The implementation of a multithreaded Monte Carlo tree
+ *          search for boards that are too large to solve exactly.
+ * ===========================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include "monteCarlo.h"
+
+// The states of a node's children
+#define NOT_EXPANDED  0
+#define EXPANDING     1    // A worker is adding them
+#define EXPANDED      2
+#define LEAF          3    // The game is over, or the pool is full
+
+// A node gets children after this many playouts
+#define EXPAND_VISITS       4
+
+// At most this many of the most critical edges are searched
+#define MAX_CHILDREN       48
+
+// The weight of the exploration term of UCT
+#define EXPLORATION      0.25
+
+// The number of playouts at which UCT and RAVE count the same
+#define RAVE_EQUIVALENCE 1000.0
+
+// The value of a child that has never been played
+#define FIRST_PLAY_VALUE  1.1
+
+// The scratch memory of one worker.
+typedef struct monteCarloWorker {
+    char * state;               // The board during a playout
+    signed char * taker;        // The player who took each edge, or -1
+    int * freeEdges;            // The normal edges left for the playout
+    int * path;                 // The nodes from the root to the leaf
+    int * parent;               // Union-find of the vertices
+    int * distStart;            // Distances for the expansions
+    int * distEnd;
+    int * deque;
+    unsigned long long random;
+    long long playouts;
+    unsigned long long shortTook[PLAYOUT_MAX_EDGES];    // The games of a batch in
+                                                        //   which Short took each edge
+} MonteCarloWorker;
+
+// What the tasks of one move share.
+typedef struct monteCarloSearch {
+    MonteCarloTree * tree;
+    MonteCarloWorker * workers;
+} MonteCarloSearch;
+
+// Local functions
+static void copyBoard(MonteCarloTree *tree, Graph *graph, Contraction *contraction);
+static void workerCreate(MonteCarloTree *tree, MonteCarloWorker *worker, int seed);
+static void workerDelete(MonteCarloWorker *worker);
+static void searchTask(void *context, int taskIndex, int workerIndex);
+static void simulate(MonteCarloTree *tree, MonteCarloWorker *worker);
+static int selectChild(MonteCarloTree *tree, int node);
+static void expand(MonteCarloTree *tree, MonteCarloWorker *worker, int node);
+static void distancesFrom(MonteCarloTree *tree, MonteCarloWorker *worker, int source, int *dist);
+static int playout(MonteCarloTree *tree, MonteCarloWorker *worker, int player);
+static void update(MonteCarloTree *tree, MonteCarloWorker *worker, int depth, int shortWins);
+static unsigned long long batchPlayout(MonteCarloTree *tree, MonteCarloWorker *worker, int player);
+static void updateBatch(MonteCarloTree *tree, MonteCarloWorker *worker, int depth,
+                        unsigned long long shortWins);
+static unsigned long long nextRandom(MonteCarloWorker *worker);
+
+/** -------------------------------------------------------------------
+ * Create a search tree.
+ * @param capacity the number of nodes in the pool
+ * @return a pointer to a Monte Carlo tree struct
+ */
+MonteCarloTree * monteCarloCreate(int capacity) {
+    MonteCarloTree *tree = calloc(1, sizeof(MonteCarloTree));
+    tree->capacity = capacity;
+    tree->nodes = malloc(capacity * sizeof(MonteCarloNode));
+    if (tree->nodes == NULL) {
+        printf("monteCarloCreate: no memory for %d nodes\n", capacity);
+        exit(1);
+    }
+    return tree;
+}
+
+/** -------------------------------------------------------------------
+ * Delete a search tree
+ * @param tree the tree to delete
+ */
+void monteCarloDelete(MonteCarloTree *tree) {
+    free(tree->nodes);
+    free(tree);
+}
+
+/** -------------------------------------------------------------------
+ * Pick a move with a Monte Carlo tree search (UCT with RAVE). Every
+ * worker of the pool grows the same tree until the time is up; a
+ * worker adds a virtual loss to the nodes it passes through, so the
+ * others spread out to different lines of play.
+ * @param tree the search tree
+ * @param graph the board
+ * @param contraction the board with its locked edges contracted
+ * @param playerToMove Either CUT_PLAYER or SHORT_PLAYER
+ * @param pool the threads that run the search
+ * @param milliseconds how long to search
+ * @param edge output: the edge to play
+ * @param statistics output, may be NULL
+ * @return TRUE if a move was found. Return FALSE if the game is over.
+ */
+int monteCarloMove(MonteCarloTree *tree, Graph *graph, Contraction *contraction,
+                   int playerToMove, ThreadPool *pool, int milliseconds, Edge *edge,
+                   MonteCarloStatistics *statistics) {
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    LONGLONG start = ticks();
+    tree->deadline = start + (LONGLONG) milliseconds * frequency.QuadPart / 1000;
+
+    copyBoard(tree, graph, contraction);
+    tree->playerToMove = playerToMove;
+    tree->used = 1;
+    MonteCarloNode *root = &tree->nodes[0];
+    root->edge = -1;
+    root->numberChildren = 0;
+    root->expansion = NOT_EXPANDED;
+    root->visits = root->wins = root->raveVisits = root->raveWins = 0;
+
+    MonteCarloSearch search;
+    search.tree = tree;
+    search.workers = malloc(pool->numberThreads * sizeof(MonteCarloWorker));
+    for (int i = 0; i < pool->numberThreads; i++) {
+        workerCreate(tree, &search.workers[i], i);
+    }
+
+    // The root's children are the moves; a forced move needs no search
+    memcpy(search.workers[0].state, tree->state, (size_t) tree->numberEdges);
+    expand(tree, &search.workers[0], 0);
+    if (root->expansion == EXPANDED && root->numberChildren > 1) {
+        threadPoolFor(pool, pool->numberThreads, searchTask, &search);
+    }
+
+    // Play the child that was searched the most
+    int best = -1;
+    if (root->expansion == EXPANDED) {
+        best = root->firstChild;
+        for (int c = root->firstChild; c < root->firstChild + root->numberChildren; c++) {
+            if (tree->nodes[c].visits > tree->nodes[best].visits) {
+                best = c;
+            }
+        }
+        *edge = tree->moves[tree->nodes[best].edge];
+    }
+
+    if (statistics != NULL) {
+        statistics->playouts = 0;
+        for (int i = 0; i < pool->numberThreads; i++) {
+            statistics->playouts += search.workers[i].playouts;
+        }
+        statistics->treeNodes = tree->used;
+        statistics->seconds = (double) (ticks() - start) / frequency.QuadPart;
+        statistics->winRate = (best != -1 && tree->nodes[best].visits > 0)
+                              ? (double) tree->nodes[best].wins / tree->nodes[best].visits : 0.0;
+    }
+
+    for (int i = 0; i < pool->numberThreads; i++) {
+        workerDelete(&search.workers[i]);
+    }
+    free(search.workers);
+    free(tree->edges);
+    free(tree->moves);
+    free(tree->state);
+    free(tree->offsets);
+    free(tree->incident);
+    return best != -1;
+}
+
+/** -------------------------------------------------------------------
+ * Copy the live edges of the contracted board into the tree. A dead
+ * edge can never matter to who wins, so it is left out of the moves
+ * and the playouts. If the game is over there are no live edges, so
+ * there are no moves.
+ * @param tree the search tree
+ * @param graph the board
+ * @param contraction the board with its locked edges contracted
+ */
+void copyBoard(MonteCarloTree *tree, Graph *graph, Contraction *contraction) {
+    int m = graphNumberEdges(graph);
+    tree->moves = malloc(m * sizeof(Edge));
+    contractionLive(contraction, graph);
+    int numberEdges;
+    int n = contractionNumber(contraction, graph, tree->moves, &numberEdges);
+    tree->numberEdges = 0;
+    for (int e = 0; e < numberEdges; e++) {
+        if (contractionIsLive(contraction, graph, tree->moves[e].fromVertex, tree->moves[e].toVertex)) {
+            tree->moves[tree->numberEdges++] = tree->moves[e];
+        }
+    }
+    tree->numberVertices = n;
+    tree->edges = malloc(m * sizeof(Edge));
+    tree->state = malloc((size_t) m);
+    tree->offsets = calloc((size_t) n + 1, sizeof(int));
+    tree->incident = malloc(2 * m * sizeof(int));
+
+    for (int e = 0; e < tree->numberEdges; e++) {
+        int u = contraction->node[tree->moves[e].fromVertex];
+        int v = contraction->node[tree->moves[e].toVertex];
+        tree->edges[e].fromVertex = u;
+        tree->edges[e].toVertex = v;
+        tree->state[e] = NORMAL_EDGE;
+        tree->offsets[u+1]++;
+        tree->offsets[v+1]++;
+    }
+
+    // The edges at each vertex
+    for (int v = 0; v < n; v++) {
+        tree->offsets[v+1] += tree->offsets[v];
+    }
+    int *next = malloc(n * sizeof(int)); // The next free slot of each vertex
+    memcpy(next, tree->offsets, n * sizeof(int));
+    for (int e = 0; e < tree->numberEdges; e++) {
+        tree->incident[next[tree->edges[e].fromVertex]++] = e;
+        tree->incident[next[tree->edges[e].toVertex]++] = e;
+    }
+    free(next);
+
+    tree->batched = playoutFits(n, tree->numberEdges);
+    if (tree->batched) {
+        playoutSetBoard(&tree->board, n, tree->numberEdges, tree->edges);
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Give a worker its scratch memory for the board of the tree.
+ * @param tree the search tree
+ * @param worker the worker
+ * @param seed makes the random numbers of each worker different
+ */
+void workerCreate(MonteCarloTree *tree, MonteCarloWorker *worker, int seed) {
+    int n = tree->numberVertices;
+    int m = tree->numberEdges;
+    worker->state = malloc((size_t) m + 1);
+    worker->taker = malloc((size_t) m + 1);
+    worker->freeEdges = malloc((m + 1) * sizeof(int));
+    worker->path = malloc((m + 1) * sizeof(int));
+    worker->parent = malloc(n * sizeof(int));
+    worker->distStart = malloc(n * sizeof(int));
+    worker->distEnd = malloc(n * sizeof(int));
+    worker->deque = malloc((n + 2 * m + 1) * sizeof(int));
+    worker->random = ((unsigned long long) rand() << 32) ^ (unsigned long long) rand() ^
+                     ((unsigned long long) seed + 1) * 0x9E3779B97F4A7C15ULL;
+    if (worker->random == 0) {
+        worker->random = 1; // xorshift never leaves 0
+    }
+    worker->playouts = 0;
+}
+
+/** -------------------------------------------------------------------
+ * Free the scratch memory of a worker.
+ * @param worker the worker
+ */
+void workerDelete(MonteCarloWorker *worker) {
+    free(worker->state);
+    free(worker->taker);
+    free(worker->freeEdges);
+    free(worker->path);
+    free(worker->parent);
+    free(worker->distStart);
+    free(worker->distEnd);
+    free(worker->deque);
+}
+
+/** -------------------------------------------------------------------
+ * Run playouts until the time is up.
+ * @param context the MonteCarloSearch
+ * @param taskIndex not used
+ * @param workerIndex which worker's scratch memory to use
+ */
+void searchTask(void *context, int taskIndex, int workerIndex) {
+    MonteCarloSearch *search = context;
+    MonteCarloWorker *worker = &search->workers[workerIndex];
+    while (ticks() < search->tree->deadline) {
+        simulate(search->tree, worker);
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Play one game: follow the tree from the root to a leaf, add the
+ * leaf's children if it has been played often enough, play the rest
+ * of the game at random and count the result in every node passed.
+ * A small board plays the rest of the game PLAYOUT_LANES times.
+ * @param tree the search tree
+ * @param worker the worker
+ */
+void simulate(MonteCarloTree *tree, MonteCarloWorker *worker) {
+    MonteCarloNode *nodes = tree->nodes;
+    memcpy(worker->state, tree->state, (size_t) tree->numberEdges);
+    memset(worker->taker, -1, (size_t) tree->numberEdges);
+
+    int node = 0;
+    int depth = 0;
+    int player = tree->playerToMove;
+    worker->path[0] = 0;
+    InterlockedIncrement(&nodes[0].visits);
+    while (nodes[node].expansion == EXPANDED) {
+        node = selectChild(tree, node);
+
+        // The visit counts as a loss until the result is known, which
+        // steers the other workers away from this line of play
+        InterlockedIncrement(&nodes[node].visits);
+        int e = nodes[node].edge;
+        worker->state[e] = (player == SHORT_PLAYER) ? LOCKED_EDGE : NO_EDGE;
+        worker->taker[e] = (signed char) player;
+        worker->path[++depth] = node;
+        player = 1 - player;
+    }
+    if (nodes[node].expansion == NOT_EXPANDED && nodes[node].visits >= EXPAND_VISITS) {
+        expand(tree, worker, node);
+    }
+
+    if (tree->batched) {
+        unsigned long long shortWins = batchPlayout(tree, worker, player);
+        updateBatch(tree, worker, depth, shortWins);
+        worker->playouts += PLAYOUT_LANES;
+        return;
+    }
+    int shortWins = playout(tree, worker, player);
+    update(tree, worker, depth, shortWins);
+    worker->playouts++;
+}
+
+/** -------------------------------------------------------------------
+ * Pick the child to follow. The value of a child mixes how often it won
+ * (UCT) with how often its edge won when it was played anywhere later
+ * in a game (RAVE). RAVE learns fast but is biased, so it counts less
+ * as the child is played more.
+ * @param tree the search tree
+ * @param node the node; it must have children
+ * @return the child's index in the pool
+ */
+int selectChild(MonteCarloTree *tree, int node) {
+    MonteCarloNode *parent = &tree->nodes[node];
+    double logVisits = log((double) parent->visits + 1.0);
+    int best = parent->firstChild;
+    double bestValue = -1.0;
+
+    for (int c = parent->firstChild; c < parent->firstChild + parent->numberChildren; c++) {
+        MonteCarloNode *child = &tree->nodes[c];
+        double visits = child->visits;
+        double raveVisits = child->raveVisits;
+        double value = FIRST_PLAY_VALUE;
+        if (visits + raveVisits > 0.0) {
+            double beta = raveVisits / (visits + raveVisits + visits * raveVisits / RAVE_EQUIVALENCE);
+            double uct = (visits > 0.0) ? child->wins / visits : 0.0;
+            double rave = (raveVisits > 0.0) ? child->raveWins / raveVisits : 0.0;
+            value = (1.0 - beta) * uct + beta * rave + EXPLORATION * sqrt(logVisits / (visits + 1.0));
+        }
+        if (value > bestValue) {
+            bestValue = value;
+            best = c;
+        }
+    }
+    return best;
+}
+
+/** -------------------------------------------------------------------
+ * Give a node its children: the moves on the shortest paths between
+ * the terminals, most critical first. An edge that is on no path
+ * between the terminals is never worth playing. Only one worker
+ * expands a node; the others play out from it until it is done.
+ * @param tree the search tree
+ * @param worker the worker; its state is the board at the node
+ * @param node the node
+ */
+void expand(MonteCarloTree *tree, MonteCarloWorker *worker, int node) {
+    MonteCarloNode *parent = &tree->nodes[node];
+    if (InterlockedCompareExchange(&parent->expansion, EXPANDING, NOT_EXPANDED) != NOT_EXPANDED) {
+        return;
+    }
+
+    int end = tree->numberVertices - 1;
+    int *distStart = worker->distStart;
+    int *distEnd = worker->distEnd;
+    distancesFrom(tree, worker, 0, distStart);
+    distancesFrom(tree, worker, end, distEnd);
+    if (distStart[end] == 0 || distStart[end] == INT_MAX) {
+        InterlockedExchange(&parent->expansion, LEAF); // The game is over
+        return;
+    }
+
+    // Keep the MAX_CHILDREN edges on the shortest paths
+    int moves[MAX_CHILDREN];
+    int lengths[MAX_CHILDREN];
+    int count = 0;
+    for (int e = 0; e < tree->numberEdges; e++) {
+        int u = tree->edges[e].fromVertex;
+        int v = tree->edges[e].toVertex;
+        if (worker->state[e] != NORMAL_EDGE || distStart[u] == INT_MAX || distStart[v] == INT_MAX) {
+            continue;
+        }
+        int forward = distStart[u] + distEnd[v];
+        int backward = distStart[v] + distEnd[u];
+        int length = 1 + ((forward < backward) ? forward : backward);
+        if (count == MAX_CHILDREN && length >= lengths[count-1]) {
+            continue;
+        }
+
+        // Insertion sort
+        int i = (count < MAX_CHILDREN) ? count++ : count - 1;
+        while (i > 0 && lengths[i-1] > length) {
+            lengths[i] = lengths[i-1];
+            moves[i] = moves[i-1];
+            i--;
+        }
+        lengths[i] = length;
+        moves[i] = e;
+    }
+
+    int first = InterlockedExchangeAdd(&tree->used, count);
+    if (count == 0 || first + count > tree->capacity) {
+        InterlockedExchange(&parent->expansion, LEAF);
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        MonteCarloNode *child = &tree->nodes[first + i];
+        child->edge = moves[i];
+        child->numberChildren = 0;
+        child->expansion = NOT_EXPANDED;
+        child->visits = child->wins = child->raveVisits = child->raveWins = 0;
+    }
+    parent->firstChild = first;
+    parent->numberChildren = count;
+    InterlockedExchange(&parent->expansion, EXPANDED); // Publishes the children
+}
+
+/** -------------------------------------------------------------------
+ * Find the distance of every vertex from a terminal with a 0-1
+ * breadth-first search: a locked edge costs 0 and a normal edge 1.
+ * @param tree the search tree
+ * @param worker the worker; its state is the board searched
+ * @param source the terminal
+ * @param dist output: the distances, INT_MAX if a vertex is not reached
+ */
+void distancesFrom(MonteCarloTree *tree, MonteCarloWorker *worker, int source, int *dist) {
+    int size = tree->numberVertices + 2 * tree->numberEdges + 1;
+    int *deque = worker->deque;
+    for (int v = 0; v < tree->numberVertices; v++) {
+        dist[v] = INT_MAX;
+    }
+
+    int head = 0;
+    int tail = 0;
+    dist[source] = 0;
+    deque[tail++] = source;
+    while (head != tail) {
+        int x = deque[head];
+        head = (head + 1) % size;
+        for (int k = tree->offsets[x]; k < tree->offsets[x+1]; k++) {
+            int e = tree->incident[k];
+            int state = worker->state[e];
+            if (state == NO_EDGE) {
+                continue;
+            }
+            int y = tree->edges[e].fromVertex == x ? tree->edges[e].toVertex
+                                                   : tree->edges[e].fromVertex;
+            int cost = (state == LOCKED_EDGE) ? 0 : 1;
+            if (dist[x] + cost < dist[y]) {
+                dist[y] = dist[x] + cost;
+                if (cost == 0) {
+                    head = (head + size - 1) % size;
+                    deque[head] = y;
+                } else {
+                    deque[tail] = y;
+                    tail = (tail + 1) % size;
+                }
+            }
+        }
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Play the rest of the game at random: the players take turns taking
+ * the normal edges left, in a random order. Short has won if the
+ * locked edges connect the terminals once every edge is taken.
+ * @param tree the search tree
+ * @param worker the worker; its state is the board at the leaf
+ * @param player the player to move at the leaf
+ * @return TRUE if Short wins
+ */
+int playout(MonteCarloTree *tree, MonteCarloWorker *worker, int player) {
+    int count = 0;
+    for (int e = 0; e < tree->numberEdges; e++) {
+        if (worker->state[e] == NORMAL_EDGE) {
+            worker->freeEdges[count++] = e;
+        }
+    }
+
+    // Shuffle the edges as they are taken
+    for (int i = 0; i < count; i++) {
+        int j = i + (int) (nextRandom(worker) % (unsigned long long) (count - i));
+        int e = worker->freeEdges[j];
+        worker->freeEdges[j] = worker->freeEdges[i];
+        worker->freeEdges[i] = e;
+        worker->taker[e] = (signed char) player;
+        worker->state[e] = (player == SHORT_PLAYER) ? LOCKED_EDGE : NO_EDGE;
+        player = 1 - player;
+    }
+
+    // Are the terminals connected by locked edges?
+    int *parent = worker->parent;
+    for (int v = 0; v < tree->numberVertices; v++) {
+        parent[v] = v;
+    }
+    for (int e = 0; e < tree->numberEdges; e++) {
+        if (worker->state[e] == LOCKED_EDGE) {
+            int a = findGroup(parent, tree->edges[e].fromVertex);
+            int b = findGroup(parent, tree->edges[e].toVertex);
+            parent[a] = b;
+        }
+    }
+    return findGroup(parent, 0) == findGroup(parent, tree->numberVertices - 1);
+}
+
+/** -------------------------------------------------------------------
+ * Count the result of a playout in the nodes it passed through. The
+ * visits were already counted on the way down. A node's RAVE counters
+ * are updated if the player who could move there took its edge at any
+ * point of the game.
+ * @param tree the search tree
+ * @param worker the worker; its path and takers are from the playout
+ * @param depth the number of moves from the root to the leaf
+ * @param shortWins TRUE if Short won the playout
+ */
+void update(MonteCarloTree *tree, MonteCarloWorker *worker, int depth, int shortWins) {
+    int player = tree->playerToMove;
+    for (int i = 0; i <= depth; i++) {
+        MonteCarloNode *node = &tree->nodes[worker->path[i]];
+        int won = (player == SHORT_PLAYER) == shortWins;
+        if (i < depth && won) {
+            InterlockedIncrement(&tree->nodes[worker->path[i+1]].wins);
+        }
+        if (node->expansion == EXPANDED) {
+            for (int c = node->firstChild; c < node->firstChild + node->numberChildren; c++) {
+                MonteCarloNode *child = &tree->nodes[c];
+                if (worker->taker[child->edge] == player) {
+                    InterlockedIncrement(&child->raveVisits);
+                    if (won) {
+                        InterlockedIncrement(&child->raveWins);
+                    }
+                }
+            }
+        }
+        player = 1 - player;
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Play the rest of the game at random PLAYOUT_LANES times at once.
+ * @param tree the search tree; it must be batched
+ * @param worker the worker; its state is the board at the leaf. Its
+ *               shortTook is set to the games in which Short took
+ *               each edge.
+ * @param player the player to move at the leaf
+ * @return a bit for each game Short won
+ */
+unsigned long long batchPlayout(MonteCarloTree *tree, MonteCarloWorker *worker, int player) {
+    unsigned long long freeEdges = 0;
+    unsigned long long lockedEdges = 0;
+    for (int e = 0; e < tree->numberEdges; e++) {
+        if (worker->state[e] == NORMAL_EDGE) {
+            freeEdges |= 1ULL << e;
+        } else if (worker->state[e] == LOCKED_EDGE) {
+            lockedEdges |= 1ULL << e;
+        }
+    }
+    return playoutRun(&tree->board, freeEdges, lockedEdges, player, &worker->random,
+                      worker->shortTook);
+}
+
+/** -------------------------------------------------------------------
+ * Count the results of a batch of playouts in the nodes it passed
+ * through, the same way update() counts one. Every edge is taken in
+ * every game, by Short in the games of its shortTook and by Cut in
+ * the others.
+ * @param tree the search tree
+ * @param worker the worker; its path and shortTook are from the batch
+ * @param depth the number of moves from the root to the leaf
+ * @param shortWins a bit for each game Short won
+ */
+void updateBatch(MonteCarloTree *tree, MonteCarloWorker *worker, int depth,
+                 unsigned long long shortWins) {
+    int player = tree->playerToMove;
+    for (int i = 0; i <= depth; i++) {
+        MonteCarloNode *node = &tree->nodes[worker->path[i]];
+        unsigned long long won = (player == SHORT_PLAYER) ? shortWins : ~shortWins;
+
+        // One of the visits was counted on the way down
+        InterlockedExchangeAdd(&node->visits, PLAYOUT_LANES - 1);
+        if (i < depth) {
+            InterlockedExchangeAdd(&tree->nodes[worker->path[i+1]].wins, playoutCount(won));
+        }
+        if (node->expansion == EXPANDED) {
+            for (int c = node->firstChild; c < node->firstChild + node->numberChildren; c++) {
+                MonteCarloNode *child = &tree->nodes[c];
+                unsigned long long took = worker->shortTook[child->edge];
+                if (player == CUT_PLAYER) {
+                    took = ~took;
+                }
+                InterlockedExchangeAdd(&child->raveVisits, playoutCount(took));
+                InterlockedExchangeAdd(&child->raveWins, playoutCount(took & won));
+            }
+        }
+        player = 1 - player;
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Get the next random number of a worker (xorshift64*). rand() is
+ * not safe to call from many threads.
+ * @param worker the worker
+ * @return a random 64-bit number
+ */
+unsigned long long nextRandom(MonteCarloWorker *worker) {
+    unsigned long long x = worker->random;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    worker->random = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
@@ -0,0 +1,110 @@
+/** monteCarlo.h
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The definition of a multithreaded Monte Carlo tree
+ *          search for boards that are too large to solve exactly.
+ * ===========================================================
+ */
+
+#ifndef MONTE_CARLO_H
+#define MONTE_CARLO_H
+
+#include <windows.h>
+#include "Graph.h"
+#include "gameLogic.h"
+#include "threadPool.h"
+#include "contraction.h"
+#include "playout.h"
+
+// The number of nodes in the pool of a search tree
+#define MONTE_CARLO_TREE_NODES  (1 << 19)
+
+// The time the Monte Carlo AI takes to pick a move, in milliseconds
+#define MONTE_CARLO_MOVE_TIME   1000
+
+// One node of the search tree: the position after a move. Every worker
+// updates the counters at once, so they are only changed with the
+// Interlocked functions.
+typedef struct monteCarloNode {
+    int edge;                   // The move into this node, -1 at the root
+    int firstChild;             // The children are nodes[firstChild..
+    int numberChildren;         //   firstChild+numberChildren-1]
+    volatile LONG expansion;    // NOT_EXPANDED, EXPANDING, EXPANDED or LEAF
+    volatile LONG visits;       // Playouts through this node, including
+                                //   the ones still running (virtual loss)
+    volatile LONG wins;         // Playouts won by the player who moved here
+    volatile LONG raveVisits;   // Playouts in which that player took the
+    volatile LONG raveWins;     //   edge later on (all moves as first)
+} MonteCarloNode;
+
+// A search tree. The nodes come from a fixed pool; a worker takes the
+// children of a node with one InterlockedExchangeAdd, so the tree grows
+// without a lock. A new tree is grown for every move.
+typedef struct monteCarloTree {
+    int capacity;               // The number of nodes in the pool
+    MonteCarloNode * nodes;     // nodes[0] is the root
+    volatile LONG used;         // The number of nodes handed out
+
+    // The contracted board of the current move: each group of vertices
+    // joined by locked edges is one vertex, and only the live edges
+    // between the groups are left
+    int numberVertices;
+    int numberEdges;
+    int playerToMove;           // CUT_PLAYER or SHORT_PLAYER
+    Edge * edges;               // Between the vertices of the tree
+    Edge * moves;               // The same edges on the board
+    char * state;               // NORMAL_EDGE or LOCKED_EDGE
+    int * offsets;              // The edges at vertex v are
+    int * incident;             //   incident[offsets[v]..offsets[v+1]-1]
+    int batched;                // TRUE if the board is small enough to
+    PlayoutBoard board;         //   play out PLAYOUT_LANES games at once
+    LONGLONG deadline;          // When the workers stop, in
+                                //   QueryPerformanceCounter() ticks
+} MonteCarloTree;
+
+// Counters of one move.
+typedef struct monteCarloStatistics {
+    long long playouts;         // Games played out to the end
+    int treeNodes;              // Nodes taken from the pool
+    double seconds;             // Time spent searching
+    double winRate;             // How often the move played won
+} MonteCarloStatistics;
+
+/** -------------------------------------------------------------------
+ * Create a search tree.
+ * @param capacity the number of nodes in the pool
+ * @return a pointer to a Monte Carlo tree struct
+ */
+MonteCarloTree * monteCarloCreate(int capacity);
+
+/** -------------------------------------------------------------------
+ * Delete a search tree
+ * @param tree the tree to delete
+ */
+void monteCarloDelete(MonteCarloTree *tree);
+
+/** -------------------------------------------------------------------
+ * Pick a move with a Monte Carlo tree search (UCT with RAVE). Every
+ * worker of the pool grows the same tree until the time is up; a
+ * worker adds a virtual loss to the nodes it passes through, so the
+ * others spread out to different lines of play. On a contracted board
+ * of at most PLAYOUT_MAX_VERTICES vertices and PLAYOUT_MAX_EDGES edges
+ * every leaf is played out PLAYOUT_LANES times at once.
+ * @param tree the search tree
+ * @param graph the board
+ * @param contraction the board with its locked edges contracted
+ * @param playerToMove Either CUT_PLAYER or SHORT_PLAYER
+ * @param pool the threads that run the search
+ * @param milliseconds how long to search
+ * @param edge output: the edge to play
+ * @param statistics output, may be NULL
+ * @return TRUE if a move was found. Return FALSE if the game is over.
+ */
+int monteCarloMove(MonteCarloTree *tree, Graph *graph, Contraction *contraction,
+                   int playerToMove, ThreadPool *pool, int milliseconds, Edge *edge,
+                   MonteCarloStatistics *statistics);
+
+#endif // MONTE_CARLO_H
@@ -0,0 +1,207 @@
+/** playout.c
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The implementation of random playouts that play 64
+ *          games at once on a small board, one game in each bit
+ *          of a 64-bit word.
+ * ===========================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "playout.h"
+
+// Local functions
+static void transpose(unsigned long long *rows);
+static int spread(PlayoutBoard *board, int k, unsigned long long *took, unsigned long long *reached);
+
+/** -------------------------------------------------------------------
+ * Check if a board is small enough for the playouts.
+ * @param numberVertices the number of vertices
+ * @param numberEdges the number of edges
+ * @return TRUE if it fits, FALSE if not
+ */
+int playoutFits(int numberVertices, int numberEdges) {
+    return numberVertices >= 2 && numberVertices <= PLAYOUT_MAX_VERTICES &&
+           numberEdges <= PLAYOUT_MAX_EDGES;
+}
+
+/** -------------------------------------------------------------------
+ * Set up the board of the playouts.
+ * @param board output: the board
+ * @param numberVertices the number of vertices; 0 is the start and
+ *                       numberVertices-1 the end
+ * @param numberEdges the number of edges
+ * @param edges the edges
+ */
+void playoutSetBoard(PlayoutBoard *board, int numberVertices, int numberEdges, Edge *edges) {
+    if (!playoutFits(numberVertices, numberEdges)) {
+        printf("ERROR in playoutSetBoard. %d vertices and %d edges do not fit.\n",
+               numberVertices, numberEdges);
+        exit(1);
+    }
+    board->numberVertices = numberVertices;
+    board->numberEdges = numberEdges;
+    for (int e = 0; e < numberEdges; e++) {
+        board->from[e] = (unsigned char) edges[e].fromVertex;
+        board->to[e] = (unsigned char) edges[e].toVertex;
+    }
+
+    // Number the vertices by their distance from the start, so that
+    // one sweep of the edges in order reaches as far as it can
+    int distance[PLAYOUT_MAX_VERTICES];
+    for (int v = 0; v < numberVertices; v++) {
+        distance[v] = PLAYOUT_MAX_VERTICES;
+    }
+    distance[0] = 0;
+    for (int changed = TRUE; changed; ) {
+        changed = FALSE;
+        for (int e = 0; e < numberEdges; e++) {
+            int a = board->from[e];
+            int b = board->to[e];
+            if (distance[a] + 1 < distance[b]) {
+                distance[b] = distance[a] + 1;
+                changed = TRUE;
+            } else if (distance[b] + 1 < distance[a]) {
+                distance[a] = distance[b] + 1;
+                changed = TRUE;
+            }
+        }
+    }
+    int count = 0;
+    for (int d = 0; d <= PLAYOUT_MAX_VERTICES; d++) {
+        for (int e = 0; e < numberEdges; e++) {
+            int a = board->from[e];
+            int b = board->to[e];
+            if ((distance[a] < distance[b] ? distance[a] : distance[b]) == d) {
+                board->order[count++] = (unsigned char) e;
+            }
+        }
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Play PLAYOUT_LANES random games to the end.
+ * @param board the board
+ * @param freeEdges a bit for each edge still to be taken
+ * @param lockedEdges a bit for each edge Short has locked. The edges
+ *                    in neither set have been cut.
+ * @param playerToMove Either CUT_PLAYER or SHORT_PLAYER
+ * @param random the state of a xorshift64* generator; never 0
+ * @param shortTook output, may be NULL: for each edge, a bit for each
+ *                  game in which Short has it at the end
+ * @return a bit for each game Short won
+ */
+unsigned long long playoutRun(PlayoutBoard *board, unsigned long long freeEdges,
+                              unsigned long long lockedEdges, int playerToMove,
+                              unsigned long long *random, unsigned long long *shortTook) {
+    int freeList[PLAYOUT_MAX_EDGES];
+    int m = 0;
+    for (int e = 0; e < board->numberEdges; e++) {
+        if ((freeEdges >> e) & 1) {
+            freeList[m++] = e;
+        }
+    }
+    int shortCount = (playerToMove == SHORT_PLAYER) ? (m + 1) / 2 : m / 2;
+
+    // Deal Short's half of the free edges in every game (Floyd's
+    // algorithm: each step adds t, or j if t is already taken)
+    unsigned long long games[PLAYOUT_LANES];
+    unsigned long long x = *random;
+    for (int lane = 0; lane < PLAYOUT_LANES; lane++) {
+        unsigned long long taken = 0;
+        for (int j = m - shortCount; j < m; j++) {
+            x ^= x >> 12;
+            x ^= x << 25;
+            x ^= x >> 27;
+            unsigned long long t = (((x * 0x2545F4914F6CDD1DULL) >> 32) * (unsigned long long) (j + 1)) >> 32;
+            unsigned long long bit = 1ULL << t;
+            taken |= (taken & bit) ? (1ULL << j) : bit;
+        }
+        games[lane] = taken;
+    }
+    *random = x;
+
+    // games[i] becomes the games in which Short took free edge i
+    transpose(games);
+    unsigned long long took[PLAYOUT_MAX_EDGES];
+    for (int e = 0; e < board->numberEdges; e++) {
+        took[e] = ((lockedEdges >> e) & 1) ? ~0ULL : 0;
+    }
+    for (int i = 0; i < m; i++) {
+        took[freeList[i]] = games[i];
+    }
+    if (shortTook != NULL) {
+        memcpy(shortTook, took, board->numberEdges * sizeof(unsigned long long));
+    }
+
+    // Spread out from the start along Short's edges, forward and back
+    // through the edges, until no game reaches any further
+    unsigned long long reached[PLAYOUT_MAX_VERTICES];
+    memset(reached, 0, board->numberVertices * sizeof(unsigned long long));
+    reached[0] = ~0ULL;
+    int changed = TRUE;
+    while (changed) {
+        changed = FALSE;
+        for (int k = 0; k < board->numberEdges; k++) {
+            changed |= spread(board, k, took, reached);
+        }
+        for (int k = board->numberEdges - 1; k >= 0; k--) {
+            changed |= spread(board, k, took, reached);
+        }
+    }
+    return reached[board->numberVertices - 1];
+}
+
+/** -------------------------------------------------------------------
+ * Count the games in a set of lanes.
+ * @param lanes a bit for each game
+ * @return the number of bits set
+ */
+int playoutCount(unsigned long long lanes) {
+    lanes = lanes - ((lanes >> 1) & 0x5555555555555555ULL);
+    lanes = (lanes & 0x3333333333333333ULL) + ((lanes >> 2) & 0x3333333333333333ULL);
+    lanes = (lanes + (lanes >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int) ((lanes * 0x0101010101010101ULL) >> 56);
+}
+
+/** -------------------------------------------------------------------
+ * Transpose a 64 x 64 matrix of bits in place: bit c of row r swaps
+ * with bit r of row c. Blocks of 32, then 16, ... then 1 bits are
+ * swapped across the diagonal.
+ * @param rows the 64 rows
+ */
+void transpose(unsigned long long *rows) {
+    unsigned long long mask = 0x00000000FFFFFFFFULL;
+    for (int width = 32; width != 0; width >>= 1, mask ^= mask << width) {
+        for (int k = 0; k < 64; k = (k + width + 1) & ~width) {
+            unsigned long long t = ((rows[k] >> width) ^ rows[k + width]) & mask;
+            rows[k] ^= t << width;
+            rows[k + width] ^= t;
+        }
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Spread the games that reach one end of an edge to the other end, in
+ * the games where Short has the edge.
+ * @param board the board
+ * @param k the place of the edge in the order
+ * @param took the games in which Short has each edge
+ * @param reached the games in which the start reaches each vertex
+ * @return TRUE if a game reached a new vertex
+ */
+int spread(PlayoutBoard *board, int k, unsigned long long *took, unsigned long long *reached) {
+    int e = board->order[k];
+    int a = board->from[e];
+    int b = board->to[e];
+    unsigned long long both = (reached[a] | reached[b]) & took[e];
+    unsigned long long added = both & ~(reached[a] & reached[b]);
+    reached[a] |= both;
+    reached[b] |= both;
+    return added != 0;
+}
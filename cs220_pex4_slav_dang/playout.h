@@ -0,0 +1,93 @@
+/** playout.h
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The definition of random playouts that play 64 games
+ *          at once on a small board, one game in each bit of a
+ *          64-bit word.
+ * ===========================================================
+ */
+
+#ifndef PLAYOUT_H
+#define PLAYOUT_H
+
+#include "Graph.h"
+#include "gameLogic.h"
+
+// The games played at once, one in each bit (lane) of a word
+#define PLAYOUT_LANES         64
+
+// The most vertices and edges of a board
+#define PLAYOUT_MAX_VERTICES  64
+#define PLAYOUT_MAX_EDGES     64
+
+// A random playout takes the normal edges left in a random order, the
+// players taking turns, and Short has won if the locked edges then
+// connect the terminals. So Short ends up with a random half of the
+// edges (the bigger half if Short moves first), and the order they
+// were taken in does not matter.
+//
+// Each batch deals out the edges of 64 games. A game's edges are a
+// 64-bit set with one bit for each edge, and Short's half is drawn
+// with Floyd's algorithm (one random number for each edge Short
+// takes). The 64 sets are then transposed, so that edge e gets one
+// word with a bit for each game in which Short took it. Reachability
+// is then worked out for all 64 games at once: each vertex has a word
+// of the games in which the start reaches it, and sweeping the edges
+// spreads reached[u] & took[e] to the other end of e until nothing
+// changes. Every step is an AND or an OR of whole words.
+
+// A board: the start is vertex 0 and the end numberVertices-1.
+typedef struct playoutBoard {
+    int numberVertices;
+    int numberEdges;
+    unsigned char from[PLAYOUT_MAX_EDGES];
+    unsigned char to[PLAYOUT_MAX_EDGES];
+    unsigned char order[PLAYOUT_MAX_EDGES];   // The edges, nearest the
+                                              //   start first
+} PlayoutBoard;
+
+/** -------------------------------------------------------------------
+ * Check if a board is small enough for the playouts.
+ * @param numberVertices the number of vertices
+ * @param numberEdges the number of edges
+ * @return TRUE if it fits, FALSE if not
+ */
+int playoutFits(int numberVertices, int numberEdges);
+
+/** -------------------------------------------------------------------
+ * Set up the board of the playouts.
+ * @param board output: the board
+ * @param numberVertices the number of vertices; 0 is the start and
+ *                       numberVertices-1 the end
+ * @param numberEdges the number of edges
+ * @param edges the edges
+ */
+void playoutSetBoard(PlayoutBoard *board, int numberVertices, int numberEdges, Edge *edges);
+
+/** -------------------------------------------------------------------
+ * Play PLAYOUT_LANES random games to the end.
+ * @param board the board
+ * @param freeEdges a bit for each edge still to be taken
+ * @param lockedEdges a bit for each edge Short has locked. The edges
+ *                    in neither set have been cut.
+ * @param playerToMove Either CUT_PLAYER or SHORT_PLAYER
+ * @param random the state of a xorshift64* generator; never 0
+ * @param shortTook output, may be NULL: for each edge, a bit for each
+ *                  game in which Short has it at the end
+ * @return a bit for each game Short won
+ */
+unsigned long long playoutRun(PlayoutBoard *board, unsigned long long freeEdges,
+                              unsigned long long lockedEdges, int playerToMove,
+                              unsigned long long *random, unsigned long long *shortTook);
+
+/** -------------------------------------------------------------------
+ * Count the games in a set of lanes.
+ * @param lanes a bit for each game
+ * @return the number of bits set
+ */
+int playoutCount(unsigned long long lanes);
+
+#endif // PLAYOUT_H
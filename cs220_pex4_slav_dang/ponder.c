@@ -0,0 +1,178 @@
+/** ponder.c
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The implementation of a background search that
+ *          works out the search AI's replies while a human
+ *          player thinks about their move.
+ * ===========================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "ponder.h"
+
+// Local functions
+static DWORD WINAPI ponderMain(LPVOID parameter);
+
+/** -------------------------------------------------------------------
+ * Create a background search that is not running.
+ * @return a pointer to a ponder struct
+ */
+Ponder * ponderCreate() {
+    Ponder *ponder = calloc(1, sizeof(Ponder));
+    return ponder;
+}
+
+/** -------------------------------------------------------------------
+ * Stop the background search and delete it.
+ * @param ponder the search to delete
+ */
+void ponderDelete(Ponder *ponder) {
+    ponderStop(ponder);
+    if (ponder->position != NULL) {
+        positionDelete(ponder->position);
+    }
+    free(ponder);
+}
+
+/** -------------------------------------------------------------------
+ * Start working out replies to the human's most critical moves, the
+ * most critical first, each for as long as the search AI would search
+ * it. The replies of the last turn are forgotten.
+ * @param ponder the background search; it must not be running
+ * @param graph the board; the human is to move
+ * @param humanPlayer Either CUT_PLAYER or SHORT_PLAYER
+ * @param table the search AI's transposition table
+ * @param milliseconds how long the search AI searches a move
+ * @return TRUE if the search was started. Return FALSE if the board is
+ *         too large to search or the game is over.
+ */
+int ponderStart(Ponder *ponder, Graph *graph, int humanPlayer, TranspositionTable *table,
+                int milliseconds) {
+    ponder->numberReplies = 0;
+    if (ponder->position != NULL) {
+        positionDelete(ponder->position);
+    }
+
+    // The thread reads only this copy, never the graph
+    ponder->position = positionCreate(graph, humanPlayer);
+    if (ponder->position == NULL) {
+        return FALSE;
+    }
+    int moves[POSITION_MAX_EDGES];
+    if (alphaBetaMoves(ponder->position, moves) == 0) {
+        return FALSE;
+    }
+
+    ponder->table = table;
+    ponder->milliseconds = milliseconds;
+    ponder->stop = FALSE;
+    ponder->thread = CreateThread(NULL, 0, ponderMain, ponder, 0, NULL);
+    if (ponder->thread == NULL) {
+        printf("ERROR in ponderStart. Could not start the thread.\n");
+        exit(1);
+    }
+    return TRUE;
+}
+
+/** -------------------------------------------------------------------
+ * Stop the background search and wait for its thread to end. The
+ * replies it worked out are kept.
+ * @param ponder the background search; it may not be running
+ */
+void ponderStop(Ponder *ponder) {
+    if (ponder->thread != NULL) {
+        InterlockedExchange(&ponder->stop, TRUE);
+        WaitForSingleObject(ponder->thread, INFINITE);
+        CloseHandle(ponder->thread);
+        ponder->thread = NULL;
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Find the reply worked out for the position the human's move led to.
+ * A reply is only good enough if it is proven, or it was searched at
+ * least as long as the search AI would search it now.
+ * @param ponder the background search; it must be stopped
+ * @param position the board after the human's move
+ * @param milliseconds how long the search AI searches a move
+ * @param bestMove output: the index of the edge to play
+ * @param statistics output: the counters of the reply's search
+ * @return TRUE if a good enough reply was found
+ */
+int ponderReply(Ponder *ponder, Position *position, int milliseconds, int *bestMove,
+                AlphaBetaStatistics *statistics) {
+    for (int i = 0; i < ponder->numberReplies; i++) {
+        PonderReply *reply = &ponder->replies[i];
+        if (reply->key != position->hash ||
+            (reply->winner == GAME_UNDERWAY && reply->milliseconds < milliseconds)) {
+            continue;
+        }
+        *bestMove = positionFindEdge(position, reply->reply.fromVertex, reply->reply.toVertex);
+        *statistics = reply->statistics;
+        return *bestMove != -1;
+    }
+    return FALSE;
+}
+
+/** -------------------------------------------------------------------
+ * Search the reply to each of the human's most critical moves for as
+ * long as the search AI would, then go over them again for twice as
+ * long, and so on until the human moves. A reply is kept from the
+ * longest search that finished, or from a search cut short if it got
+ * deeper.
+ * @param parameter the Ponder
+ * @return 0
+ */
+DWORD WINAPI ponderMain(LPVOID parameter) {
+    Ponder *ponder = (Ponder *) parameter;
+    Position *position = ponder->position;
+    int moves[POSITION_MAX_EDGES];
+    int numberMoves = alphaBetaMoves(position, moves);
+    if (numberMoves > PONDER_REPLIES) {
+        numberMoves = PONDER_REPLIES;
+    }
+
+    // Every move gets an empty reply first, so the replies line up
+    for (int i = 0; i < numberMoves; i++) {
+        positionMake(position, moves[i]);
+        ponder->replies[i].key = position->hash;
+        ponder->replies[i].winner = GAME_UNDERWAY;
+        ponder->replies[i].milliseconds = 0;
+        ponder->replies[i].statistics.depth = -1;
+        positionUnmake(position, moves[i]);
+    }
+    ponder->numberReplies = numberMoves;
+
+    int solved = 0;
+    for (int slice = ponder->milliseconds; !ponder->stop && solved < numberMoves; slice *= 2) {
+        solved = 0;
+        for (int i = 0; i < numberMoves && !ponder->stop; i++) {
+            PonderReply *reply = &ponder->replies[i];
+            if (reply->winner != GAME_UNDERWAY) {
+                solved++;
+                continue;
+            }
+
+            int move;
+            AlphaBetaStatistics statistics;
+            positionMake(position, moves[i]);
+            int winner = alphaBetaDeepen(position, ponder->table, slice, &ponder->stop, &move,
+                                         &statistics);
+            if (move != -1 && (!ponder->stop || statistics.depth > reply->statistics.depth)) {
+                reply->reply = position->edges[move];
+                reply->winner = winner;
+                reply->statistics = statistics;
+                if (!ponder->stop) {
+                    reply->milliseconds = slice;
+                }
+                solved += (winner != GAME_UNDERWAY);
+            }
+            positionUnmake(position, moves[i]);
+        }
+    }
+    return 0;
+}
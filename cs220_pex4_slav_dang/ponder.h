@@ -0,0 +1,97 @@
+/** ponder.h
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The definition of a background search that works
+ *          out the search AI's replies while a human player
+ *          thinks about their move.
+ * ===========================================================
+ */
+
+#ifndef PONDER_H
+#define PONDER_H
+
+#include <windows.h>
+#include "Graph.h"
+#include "gameLogic.h"
+#include "position.h"
+#include "alphaBeta.h"
+
+// The number of the human's most critical moves that get a reply
+#define PONDER_REPLIES   8
+
+// The search AI's reply to one of the human's moves.
+typedef struct ponderReply {
+    unsigned long long key;     // The hash of the position after the move
+    Edge reply;                 // The edge to play
+    int winner;                 // SHORT_WINS or CUT_WINS if it is proven,
+                                //   GAME_UNDERWAY if not
+    int milliseconds;           // How long the reply was searched
+    AlphaBetaStatistics statistics;
+} PonderReply;
+
+// A search that runs on its own thread between the time the human's
+// turn starts and the time they move. It owns a copy of the board, so
+// the human can move while it runs. It shares the transposition table
+// with the search AI, so it must be stopped before the AI searches.
+typedef struct ponder {
+    HANDLE thread;              // NULL when it is not running
+    volatile LONG stop;         // Set to stop the thread
+    Position * position;        // The board when the human's turn started
+    TranspositionTable * table;
+    int milliseconds;           // How long the search AI searches a move
+    int numberReplies;
+    PonderReply replies[PONDER_REPLIES];
+} Ponder;
+
+/** -------------------------------------------------------------------
+ * Create a background search that is not running.
+ * @return a pointer to a ponder struct
+ */
+Ponder * ponderCreate();
+
+/** -------------------------------------------------------------------
+ * Stop the background search and delete it.
+ * @param ponder the search to delete
+ */
+void ponderDelete(Ponder *ponder);
+
+/** -------------------------------------------------------------------
+ * Start working out replies to the human's most critical moves, the
+ * most critical first, each for as long as the search AI would search
+ * it. The replies of the last turn are forgotten.
+ * @param ponder the background search; it must not be running
+ * @param graph the board; the human is to move
+ * @param humanPlayer Either CUT_PLAYER or SHORT_PLAYER
+ * @param table the search AI's transposition table
+ * @param milliseconds how long the search AI searches a move
+ * @return TRUE if the search was started. Return FALSE if the board is
+ *         too large to search or the game is over.
+ */
+int ponderStart(Ponder *ponder, Graph *graph, int humanPlayer, TranspositionTable *table,
+                int milliseconds);
+
+/** -------------------------------------------------------------------
+ * Stop the background search and wait for its thread to end. The
+ * replies it worked out are kept.
+ * @param ponder the background search; it may not be running
+ */
+void ponderStop(Ponder *ponder);
+
+/** -------------------------------------------------------------------
+ * Find the reply worked out for the position the human's move led to.
+ * A reply is only good enough if it is proven, or it was searched at
+ * least as long as the search AI would search it now.
+ * @param ponder the background search; it must be stopped
+ * @param position the board after the human's move
+ * @param milliseconds how long the search AI searches a move
+ * @param bestMove output: the index of the edge to play
+ * @param statistics output: the counters of the reply's search
+ * @return TRUE if a good enough reply was found
+ */
+int ponderReply(Ponder *ponder, Position *position, int milliseconds, int *bestMove,
+                AlphaBetaStatistics *statistics);
+
+#endif // PONDER_H
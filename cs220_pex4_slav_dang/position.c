@@ -0,0 +1,454 @@
+/** position.c
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The implementation of a compact game position that
+ *          the game-tree searches play moves on.
+ * ===========================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include "position.h"
+
+// The kinds of Zobrist keys
+#define NORMAL_KEY  0
+#define LOCKED_KEY  1
+#define SIDE_KEY    2
+
+// Local functions
+static unsigned long long zobristKey(int numberVertices, int u, int v, int kind);
+static void distancesFrom(Position *position, int source, int *dist);
+static void bitboardDistancesFrom(Position *position, int source, int *dist);
+static void setRows(Position *position, int e, int state);
+static int lowestBit(unsigned long long bits);
+
+/** -------------------------------------------------------------------
+ * Copy a board into a position. The cut edges are left out.
+ * @param graph the board
+ * @param playerToMove Either CUT_PLAYER or SHORT_PLAYER
+ * @return the position, or NULL if the board has more than
+ *         POSITION_MAX_EDGES edges
+ */
+Position * positionCreate(Graph *graph, int playerToMove) {
+    int n = graph->numberVertices;
+    if (graphNumberEdges(graph) > POSITION_MAX_EDGES) {
+        return NULL;
+    }
+
+    Position *position = calloc(1, sizeof(Position));
+    position->numberVertices = n;
+    position->playerToMove = playerToMove;
+    position->offsets = calloc((size_t) n + 1, sizeof(int));
+    position->incident = malloc(2 * POSITION_MAX_EDGES * sizeof(int));
+    position->distStart = malloc(n * sizeof(int));
+    position->distEnd = malloc(n * sizeof(int));
+    position->deque = malloc((n + 2 * POSITION_MAX_EDGES + 1) * sizeof(int));
+    position->discovered = malloc(n * sizeof(int));
+    position->low = malloc(n * sizeof(int));
+    position->parentEdge = malloc(n * sizeof(int));
+    position->next = malloc(n * sizeof(int));
+    position->holdsEnd = malloc((size_t) n);
+    position->live = malloc(POSITION_MAX_EDGES);
+
+    for (int u = 0; u < n; u++) {
+        for (int j = 0; j < graph->degree[u]; j++) {
+            int v = graph->neighbors[u][j];
+            if (u < v) {
+                int e = position->numberEdges++;
+                position->edges[e].fromVertex = u;
+                position->edges[e].toVertex = v;
+                position->state[e] = graphGetEdge(graph, u, v);
+                position->normalKey[e] = zobristKey(n, u, v, NORMAL_KEY);
+                position->lockedKey[e] = zobristKey(n, u, v, LOCKED_KEY);
+                position->hash ^= (position->state[e] == LOCKED_EDGE) ? position->lockedKey[e]
+                                                                      : position->normalKey[e];
+                position->offsets[u+1]++;
+                position->offsets[v+1]++;
+            }
+        }
+    }
+    if (playerToMove == SHORT_PLAYER) {
+        position->hash ^= zobristKey(n, 0, 0, SIDE_KEY);
+    }
+
+    // The edges as bits, on a board small enough for them
+    position->bitboard = (n <= POSITION_BITBOARD_VERTICES);
+    if (position->bitboard) {
+        for (int e = 0; e < position->numberEdges; e++) {
+            setRows(position, e, position->state[e]);
+        }
+    }
+
+    // The edges at each vertex
+    for (int v = 0; v < n; v++) {
+        position->offsets[v+1] += position->offsets[v];
+    }
+    int *next = position->distStart; // The next free slot of each vertex
+    for (int v = 0; v < n; v++) {
+        next[v] = position->offsets[v];
+    }
+    for (int e = 0; e < position->numberEdges; e++) {
+        position->incident[next[position->edges[e].fromVertex]++] = e;
+        position->incident[next[position->edges[e].toVertex]++] = e;
+    }
+    return position;
+}
+
+/** -------------------------------------------------------------------
+ * Delete a position
+ * @param position the position to delete
+ */
+void positionDelete(Position *position) {
+    free(position->offsets);
+    free(position->incident);
+    free(position->distStart);
+    free(position->distEnd);
+    free(position->deque);
+    free(position->discovered);
+    free(position->low);
+    free(position->parentEdge);
+    free(position->next);
+    free(position->holdsEnd);
+    free(position->live);
+    free(position);
+}
+
+/** -------------------------------------------------------------------
+ * Play a normal edge for the player to move: Short locks it and Cut
+ * cuts it. The other player is to move next.
+ * @param position the position
+ * @param e the index of the edge
+ */
+void positionMake(Position *position, int e) {
+    position->hash ^= position->normalKey[e];
+    if (position->playerToMove == SHORT_PLAYER) {
+        position->state[e] = LOCKED_EDGE;
+        position->hash ^= position->lockedKey[e];
+    } else {
+        position->state[e] = NO_EDGE;
+    }
+    if (position->bitboard) {
+        setRows(position, e, position->state[e]);
+    }
+    position->playerToMove = 1 - position->playerToMove;
+    position->hash ^= zobristKey(position->numberVertices, 0, 0, SIDE_KEY);
+}
+
+/** -------------------------------------------------------------------
+ * Take back a move made with positionMake().
+ * @param position the position
+ * @param e the index of the edge
+ */
+void positionUnmake(Position *position, int e) {
+    position->hash ^= zobristKey(position->numberVertices, 0, 0, SIDE_KEY);
+    position->playerToMove = 1 - position->playerToMove;
+    if (position->state[e] == LOCKED_EDGE) {
+        position->hash ^= position->lockedKey[e];
+    }
+    position->state[e] = NORMAL_EDGE;
+    position->hash ^= position->normalKey[e];
+    if (position->bitboard) {
+        setRows(position, e, NORMAL_EDGE);
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Find the distance of every vertex from both terminals, where a
+ * locked edge costs 0 and a normal edge costs 1. Short has won if the
+ * distance between the terminals is 0, and Cut has won if there is
+ * none.
+ * @param position the position
+ * @return GAME_UNDERWAY, SHORT_WINS or CUT_WINS
+ */
+int positionDistances(Position *position) {
+    int end = position->numberVertices - 1;
+    void (*search)(Position *, int, int *) = position->bitboard ? bitboardDistancesFrom : distancesFrom;
+    search(position, 0, position->distStart);
+    if (position->distStart[end] == INT_MAX) {
+        return CUT_WINS;
+    }
+    if (position->distStart[end] == 0) {
+        return SHORT_WINS;
+    }
+    search(position, end, position->distEnd);
+    return GAME_UNDERWAY;
+}
+
+/** -------------------------------------------------------------------
+ * Get the length of the shortest path between the terminals that goes
+ * through a normal edge. The shortest paths are where the game is
+ * decided, so the shorter it is, the more critical the edge.
+ * positionDistances() must be called first.
+ * @param position the position
+ * @param e the index of the edge
+ * @return the number of normal edges on the path, or INT_MAX if no path
+ *         goes through the edge
+ */
+int positionPathLength(Position *position, int e) {
+    int u = position->edges[e].fromVertex;
+    int v = position->edges[e].toVertex;
+    int best = INT_MAX;
+    if (position->distStart[u] != INT_MAX && position->distEnd[v] != INT_MAX) {
+        best = position->distStart[u] + position->distEnd[v] + 1;
+    }
+    if (position->distStart[v] != INT_MAX && position->distEnd[u] != INT_MAX &&
+        position->distStart[v] + position->distEnd[u] + 1 < best) {
+        best = position->distStart[v] + position->distEnd[u] + 1;
+    }
+    return best;
+}
+
+/** -------------------------------------------------------------------
+ * Split the board into blocks (biconnected components) and find the
+ * blocks that every path between the terminals goes through. Their
+ * edges are live: an edge in any other block is on no simple path
+ * between the terminals, so playing it is the same as passing. A live
+ * block with a single normal edge is a bridge that separates the
+ * terminals, and Cut wins by cutting it.
+ *
+ * A depth-first search from the start (Tarjan's algorithm) keeps the
+ * edges it meets on a stack. When nothing below a child reaches back
+ * above its parent, the edges above the child's tree edge form a
+ * block, and the block is live if the end vertex is below the child.
+ * @param position the position; the terminals must be connected
+ * @param bridges output: the edge indexes (up to POSITION_MAX_EDGES)
+ * @return the number of bridges; live[] is filled too
+ */
+int positionBlocks(Position *position, int *bridges) {
+    int end = position->numberVertices - 1;
+    int *discovered = position->discovered;
+    int *low = position->low;
+    int *parentEdge = position->parentEdge;
+    int *next = position->next;
+    int *stack = position->deque;
+    int edgeStack[POSITION_MAX_EDGES];
+    int edgeTop = 0;
+    for (int v = 0; v < position->numberVertices; v++) {
+        discovered[v] = -1;
+    }
+    for (int e = 0; e < position->numberEdges; e++) {
+        position->live[e] = FALSE;
+    }
+
+    int count = 0;
+    int time = 0;
+    int top = 0;
+    stack[0] = 0;
+    discovered[0] = low[0] = time++;
+    parentEdge[0] = -1;
+    next[0] = position->offsets[0];
+    position->holdsEnd[0] = FALSE;
+    while (top >= 0) {
+        int x = stack[top];
+        if (next[x] < position->offsets[x+1]) {
+            int e = position->incident[next[x]++];
+            if (position->state[e] == NO_EDGE || e == parentEdge[x]) {
+                continue;
+            }
+            int y = position->edges[e].fromVertex == x ? position->edges[e].toVertex
+                                                      : position->edges[e].fromVertex;
+            if (discovered[y] == -1) {
+                discovered[y] = low[y] = time++;
+                parentEdge[y] = e;
+                next[y] = position->offsets[y];
+                position->holdsEnd[y] = (y == end);
+                stack[++top] = y;
+                edgeStack[edgeTop++] = e;
+            } else if (discovered[y] < discovered[x]) {
+                edgeStack[edgeTop++] = e; // An edge back to an ancestor
+                if (discovered[y] < low[x]) {
+                    low[x] = discovered[y];
+                }
+            }
+        } else {
+            // x is finished; report to its parent
+            top--;
+            if (top >= 0) {
+                int p = stack[top];
+                int e = parentEdge[x];
+                if (low[x] < low[p]) {
+                    low[p] = low[x];
+                }
+                if (low[x] >= discovered[p]) {
+                    // The edges down to e form a block
+                    int size = 0;
+                    int f;
+                    do {
+                        f = edgeStack[--edgeTop];
+                        position->live[f] = position->holdsEnd[x];
+                        size++;
+                    } while (f != e);
+                    if (size == 1 && position->holdsEnd[x] && position->state[e] == NORMAL_EDGE) {
+                        bridges[count++] = e;
+                    }
+                }
+                if (position->holdsEnd[x]) {
+                    position->holdsEnd[p] = TRUE;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+/** -------------------------------------------------------------------
+ * Find the index of an edge.
+ * @param position the position
+ * @param fromVertex one end of the edge
+ * @param toVertex the other end of the edge
+ * @return the index of the edge, or -1 if it is not in the position
+ */
+int positionFindEdge(Position *position, int fromVertex, int toVertex) {
+    for (int k = position->offsets[fromVertex]; k < position->offsets[fromVertex+1]; k++) {
+        int e = position->incident[k];
+        if (position->edges[e].fromVertex == toVertex || position->edges[e].toVertex == toVertex) {
+            return e;
+        }
+    }
+    return -1;
+}
+
+/** -------------------------------------------------------------------
+ * Breadth-first search with 0/1 edge costs: a vertex reached through a
+ * locked edge goes to the front of the deque, through a normal edge to
+ * the back.
+ * @param position the position
+ * @param source the vertex to start from
+ * @param dist output: the distance of each vertex, INT_MAX if unreachable
+ */
+void distancesFrom(Position *position, int source, int *dist) {
+    int size = position->numberVertices + 2 * POSITION_MAX_EDGES + 1;
+    int *deque = position->deque;
+    for (int v = 0; v < position->numberVertices; v++) {
+        dist[v] = INT_MAX;
+    }
+
+    int head = 0;
+    int tail = 0;
+    dist[source] = 0;
+    deque[tail++] = source;
+    while (head != tail) {
+        int x = deque[head];
+        head = (head + 1) % size;
+        for (int k = position->offsets[x]; k < position->offsets[x+1]; k++) {
+            int e = position->incident[k];
+            int state = position->state[e];
+            if (state == NO_EDGE) {
+                continue;
+            }
+            int y = position->edges[e].fromVertex == x ? position->edges[e].toVertex
+                                                      : position->edges[e].fromVertex;
+            int cost = (state == LOCKED_EDGE) ? 0 : 1;
+            if (dist[x] + cost < dist[y]) {
+                dist[y] = dist[x] + cost;
+                if (cost == 0) {
+                    head = (head + size - 1) % size;
+                    deque[head] = y;
+                } else {
+                    deque[tail] = y;
+                    tail = (tail + 1) % size;
+                }
+            }
+        }
+    }
+}
+
+/** -------------------------------------------------------------------
+ * The same search as distancesFrom() on the rows of bits, one layer of
+ * vertices at a time: the vertices at distance d are the ones the
+ * locked edges join to the normal neighbors of distance d-1.
+ * @param position the position; it must keep the rows
+ * @param source the vertex to start from
+ * @param dist output: the distance of each vertex, INT_MAX if unreachable
+ */
+void bitboardDistancesFrom(Position *position, int source, int *dist) {
+    for (int v = 0; v < position->numberVertices; v++) {
+        dist[v] = INT_MAX;
+    }
+
+    unsigned long long reached = 0;
+    unsigned long long layer = 1ULL << source;
+    for (int d = 0; layer != 0; d++) {
+        // Spread the layer along the locked edges, which cost nothing
+        unsigned long long added = layer;
+        while (added != 0) {
+            unsigned long long joined = 0;
+            for (unsigned long long bits = added; bits != 0; bits &= bits - 1) {
+                joined |= position->lockedRows[lowestBit(bits)];
+            }
+            added = joined & ~(reached | layer);
+            layer |= added;
+        }
+        reached |= layer;
+
+        unsigned long long next = 0;
+        for (unsigned long long bits = layer; bits != 0; bits &= bits - 1) {
+            int v = lowestBit(bits);
+            dist[v] = d;
+            next |= position->normalRows[v];
+        }
+        layer = next & ~reached;
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Set the bits of an edge in the rows of both of its ends.
+ * @param position the position; it must keep the rows
+ * @param e the index of the edge
+ * @param state the new state of the edge
+ */
+void setRows(Position *position, int e, int state) {
+    int u = position->edges[e].fromVertex;
+    int v = position->edges[e].toVertex;
+    unsigned long long uBit = 1ULL << u;
+    unsigned long long vBit = 1ULL << v;
+    position->normalRows[u] &= ~vBit;
+    position->normalRows[v] &= ~uBit;
+    position->lockedRows[u] &= ~vBit;
+    position->lockedRows[v] &= ~uBit;
+    if (state == NORMAL_EDGE) {
+        position->normalRows[u] |= vBit;
+        position->normalRows[v] |= uBit;
+    } else if (state == LOCKED_EDGE) {
+        position->lockedRows[u] |= vBit;
+        position->lockedRows[v] |= uBit;
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Find the lowest bit that is set (de Bruijn multiplication).
+ * @param bits a word; it must not be 0
+ * @return the index of the lowest bit set, 0 to 63
+ */
+int lowestBit(unsigned long long bits) {
+    static const int index[64] = {
+         0,  1, 48,  2, 57, 49, 28,  3, 61, 58, 50, 42, 38, 29, 17,  4,
+        62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12,  5,
+        63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+        46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19,  9, 13,  8,  7,  6
+    };
+    return index[((bits & (0 - bits)) * 0x03F79D71B4CB0A89ULL) >> 58];
+}
+
+/** -------------------------------------------------------------------
+ * Make a Zobrist key from the ends of an edge (splitmix64), so the keys
+ * are the same every time a board is copied.
+ * @param numberVertices the number of vertices of the board
+ * @param u one end of the edge (the smaller index)
+ * @param v the other end of the edge
+ * @param kind NORMAL_KEY, LOCKED_KEY or SIDE_KEY
+ * @return the key
+ */
+unsigned long long zobristKey(int numberVertices, int u, int v, int kind) {
+    unsigned long long z = ((unsigned long long) numberVertices << 40) ^
+                           ((unsigned long long) u << 22) ^ ((unsigned long long) v << 2) ^
+                           (unsigned long long) kind;
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
@@ -0,0 +1,133 @@
+/** position.h
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The definition of a compact game position that the
+ *          game-tree searches play moves on.
+ * ===========================================================
+ */
+
+#ifndef POSITION_H
+#define POSITION_H
+
+#include "Graph.h"
+#include "gameLogic.h"
+
+// The largest number of edges (normal or locked) a position can hold
+#define POSITION_MAX_EDGES  64
+
+// A board with at most this many vertices also keeps each row of its
+// adjacency matrix as the bits of one word
+#define POSITION_BITBOARD_VERTICES  64
+
+// A copy of the board made for searching. Moves are made and unmade
+// in place, so a search never copies the adjacency matrix. The hash is
+// a Zobrist key of the normal edges, the locked edges and the player to
+// move. The key of an edge depends only on its two vertices, so the
+// same position has the same hash on every turn of a game.
+typedef struct position {
+    int numberVertices;
+    int numberEdges;
+    int playerToMove;                    // CUT_PLAYER or SHORT_PLAYER
+    Edge edges[POSITION_MAX_EDGES];      // The ends of each edge
+    int state[POSITION_MAX_EDGES];       // NORMAL_EDGE, LOCKED_EDGE or NO_EDGE
+    unsigned long long normalKey[POSITION_MAX_EDGES];
+    unsigned long long lockedKey[POSITION_MAX_EDGES];
+    unsigned long long hash;
+
+    // On a board of at most POSITION_BITBOARD_VERTICES vertices, bit w
+    // of normalRows[v] (lockedRows[v]) is set if a normal (locked) edge
+    // joins v and w. The distances are then found a whole layer of
+    // vertices at a time with a few ANDs and ORs.
+    int bitboard;                        // TRUE if the rows are kept
+    unsigned long long normalRows[POSITION_BITBOARD_VERTICES];
+    unsigned long long lockedRows[POSITION_BITBOARD_VERTICES];
+
+    int * offsets;                       // The edges at vertex v are
+    int * incident;                      //   incident[offsets[v]..offsets[v+1]-1]
+    int * distStart;                     // Filled by positionDistances()
+    int * distEnd;
+    int * deque;
+    char * live;                         // Filled by positionBlocks()
+    int * discovered;                    // Scratch space of positionBlocks()
+    int * low;
+    int * parentEdge;
+    int * next;
+    char * holdsEnd;
+} Position;
+
+/** -------------------------------------------------------------------
+ * Copy a board into a position. The cut edges are left out.
+ * @param graph the board
+ * @param playerToMove Either CUT_PLAYER or SHORT_PLAYER
+ * @return the position, or NULL if the board has more than
+ *         POSITION_MAX_EDGES edges
+ */
+Position * positionCreate(Graph *graph, int playerToMove);
+
+/** -------------------------------------------------------------------
+ * Delete a position
+ * @param position the position to delete
+ */
+void positionDelete(Position *position);
+
+/** -------------------------------------------------------------------
+ * Play a normal edge for the player to move: Short locks it and Cut
+ * cuts it. The other player is to move next.
+ * @param position the position
+ * @param e the index of the edge
+ */
+void positionMake(Position *position, int e);
+
+/** -------------------------------------------------------------------
+ * Take back a move made with positionMake().
+ * @param position the position
+ * @param e the index of the edge
+ */
+void positionUnmake(Position *position, int e);
+
+/** -------------------------------------------------------------------
+ * Find the distance of every vertex from both terminals, where a
+ * locked edge costs 0 and a normal edge costs 1. Short has won if the
+ * distance between the terminals is 0, and Cut has won if there is
+ * none.
+ * @param position the position
+ * @return GAME_UNDERWAY, SHORT_WINS or CUT_WINS
+ */
+int positionDistances(Position *position);
+
+/** -------------------------------------------------------------------
+ * Get the length of the shortest path between the terminals that goes
+ * through a normal edge. The shortest paths are where the game is
+ * decided, so the shorter it is, the more critical the edge.
+ * positionDistances() must be called first.
+ * @param position the position
+ * @param e the index of the edge
+ * @return the number of normal edges on the path, or INT_MAX if no path
+ *         goes through the edge
+ */
+int positionPathLength(Position *position, int e);
+
+/** -------------------------------------------------------------------
+ * Find the live edges: the edges of the blocks (biconnected components)
+ * that every path between the terminals goes through. Any other edge
+ * is on no simple path between the terminals. Also find the bridges
+ * that separate the terminals; Cut wins by cutting any of them.
+ * @param position the position; the terminals must be connected
+ * @param bridges output: the edge indexes (up to POSITION_MAX_EDGES)
+ * @return the number of bridges; live[] is filled too
+ */
+int positionBlocks(Position *position, int *bridges);
+
+/** -------------------------------------------------------------------
+ * Find the index of an edge.
+ * @param position the position
+ * @param fromVertex one end of the edge
+ * @param toVertex the other end of the edge
+ * @return the index of the edge, or -1 if it is not in the position
+ */
+int positionFindEdge(Position *position, int fromVertex, int toVertex);
+
+#endif // POSITION_H
@@ -0,0 +1,428 @@
+/** proofNumber.c
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The implementation of a depth-first proof-number
+ *          search (df-pn) that proves who wins a board, with a
+ *          table that fits in a fixed amount of memory.
+ * ===========================================================
+ */
+
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "proofNumber.h"
+#include "alphaBeta.h"
+#include "canonical.h"
+#include "threadPool.h"
+
+// A proof or disproof number that can never be reached: the position
+// is lost (or won) for sure. Sums of numbers stop just below it.
+#define PROOF_INFINITY  1000000000u
+
+// The positions in each bucket of the table
+#define PROOF_BUCKET_ENTRIES  4
+
+// A position gets a little more than it needs before the search goes
+// back up to look at its siblings (the 1 + epsilon trick), so it does
+// not bounce between two positions of the same cost
+#define PROOF_EPSILON_SHARE   4
+
+// The search checks the clock every this many nodes
+#define CLOCK_NODES     256
+
+// The canonical keys already worked out in a search are kept by the
+// Zobrist hash of their position in 2^KEY_CACHE_BITS slots
+#define KEY_CACHE_BITS   16
+
+// A child of the position being searched: its replies, listed once
+// when the search comes into the position, and its canonical key.
+// Working out a key is most of the cost of a position, and most
+// children are never searched, so a key is only worked out when the
+// search picks the child, unless the key cache already has it.
+typedef struct proofChild {
+    unsigned long long key;    // 0 until it is known
+    int numberMoves;
+    int moves[POSITION_MAX_EDGES];
+} ProofChild;
+
+// A canonical key worked out earlier in the search. A move order that
+// leads to the same position gives the same Zobrist hash, which is
+// much cheaper to get than the canonical key.
+typedef struct keyCacheEntry {
+    unsigned long long hash;   // The Zobrist hash of the position
+    unsigned long long key;    // Its canonical key, 0 if empty
+} KeyCacheEntry;
+
+// The children of the position being searched at one depth.
+typedef struct proofFrame {
+    ProofChild children[POSITION_MAX_EDGES];
+} ProofFrame;
+
+// What one search shares between its nodes.
+typedef struct proofSearch {
+    ProofTable * table;
+    ProofStatistics * statistics;
+    LONGLONG deadline;         // When to stop, in QueryPerformanceCounter()
+                               //   ticks; 0 for no limit
+    int aborted;               // TRUE once the time is up
+    ProofFrame * frames[POSITION_MAX_EDGES + 1]; // By depth, made when
+                                                 //   first needed
+    KeyCacheEntry * keyCache;  // 2^KEY_CACHE_BITS slots
+} ProofSearch;
+
+// Local functions
+static void prove(Position *position, ProofSearch *search, int depth, ProofChild *node,
+                  unsigned int proofLimit, unsigned int disproofLimit, ProofEntry *result,
+                  int *bestMove);
+static ProofFrame * frameAt(ProofSearch *search, int depth);
+static KeyCacheEntry * keyCacheSlot(ProofSearch *search, Position *position);
+static ProofEntry * lookup(ProofTable *table, unsigned long long key);
+static void store(ProofTable *table, ProofEntry *result);
+static unsigned int add(unsigned int a, unsigned int b);
+
+/** -------------------------------------------------------------------
+ * Create an empty proof table.
+ * @param megabytes the memory of the table
+ * @return a pointer to a proof table struct
+ */
+ProofTable * proofTableCreate(int megabytes) {
+    ProofTable *table = calloc(1, sizeof(ProofTable));
+    size_t bucketBytes = PROOF_BUCKET_ENTRIES * sizeof(ProofEntry);
+    table->numberBuckets = 1;
+    while (2 * table->numberBuckets * bucketBytes <= (size_t) megabytes << 20) {
+        table->numberBuckets *= 2;
+    }
+    table->bytes = table->numberBuckets * bucketBytes;
+    table->entries = calloc((size_t) table->numberBuckets * PROOF_BUCKET_ENTRIES,
+                            sizeof(ProofEntry));
+    if (table->entries == NULL) {
+        printf("ERROR in proofTableCreate. No memory for %d MB.\n", megabytes);
+        exit(1);
+    }
+    return table;
+}
+
+/** -------------------------------------------------------------------
+ * Delete a proof table
+ * @param table the table to delete
+ */
+void proofTableDelete(ProofTable *table) {
+    free(table->entries);
+    free(table);
+}
+
+/** -------------------------------------------------------------------
+ * Forget every entry of a proof table.
+ * @param table the table
+ */
+void proofTableClear(ProofTable *table) {
+    for (int i = 0; i < table->numberBuckets * PROOF_BUCKET_ENTRIES; i++) {
+        table->entries[i].key = 0;
+    }
+    table->used = 0;
+    table->replaced = 0;
+}
+
+/** -------------------------------------------------------------------
+ * Prove who wins a position with a depth-first proof-number search.
+ * @param position the position; it is the same when the search returns
+ * @param table the proof table; it can be kept between turns
+ * @param milliseconds how long to search, or 0 for no limit
+ * @param bestMove output: the index of the edge to play, or -1 if the
+ *                 game is over or the player to move has no move
+ *                 worth playing. It wins if the player to move wins;
+ *                 if they lose, it is the move that takes the largest
+ *                 proof to beat.
+ * @param statistics output, may be NULL
+ * @return SHORT_WINS or CUT_WINS with perfect play, or GAME_UNDERWAY
+ *         if the time ran out first
+ */
+int proofSolve(Position *position, ProofTable *table, int milliseconds, int *bestMove,
+               ProofStatistics *statistics) {
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    ProofStatistics counters = {0, 0, 0.0, 0, 0, 0};
+    ProofSearch search = {table, &counters, 0, FALSE, {NULL}, NULL};
+    search.keyCache = calloc((size_t) 1 << KEY_CACHE_BITS, sizeof(KeyCacheEntry));
+    if (search.keyCache == NULL) {
+        printf("ERROR in proofSolve. No memory for the key cache.\n");
+        exit(1);
+    }
+    LONGLONG start = ticks();
+    if (milliseconds > 0) {
+        search.deadline = start + (LONGLONG) milliseconds * frequency.QuadPart / 1000;
+    }
+    long long replaced = table->replaced;
+
+    int moverWins = (position->playerToMove == SHORT_PLAYER) ? SHORT_WINS : CUT_WINS;
+    int winner = positionDistances(position);
+    *bestMove = -1;
+    if (winner == GAME_UNDERWAY) {
+        // The root is searched until it is proven or disproven
+        ProofChild rootNode;
+        rootNode.key = canonicalKey(position);
+        rootNode.numberMoves = alphaBetaMoves(position, rootNode.moves);
+        ProofEntry root;
+        prove(position, &search, 0, &rootNode, PROOF_INFINITY, PROOF_INFINITY, &root, bestMove);
+        if (root.proof == 0) {
+            winner = moverWins;
+        } else if (root.disproof == 0) {
+            winner = SHORT_WINS + CUT_WINS - moverWins;
+        }
+        if (winner != GAME_UNDERWAY) {
+            counters.proofSize = root.proofSize;
+        }
+    }
+
+    if (statistics != NULL) {
+        counters.milliseconds = (ticks() - start) * 1000.0 / frequency.QuadPart;
+        counters.bytes = table->bytes;
+        counters.used = table->used;
+        counters.replaced = table->replaced - replaced;
+        *statistics = counters;
+    }
+    for (int depth = 0; depth <= POSITION_MAX_EDGES; depth++) {
+        free(search.frames[depth]);
+    }
+    free(search.keyCache);
+    return winner;
+}
+
+/** -------------------------------------------------------------------
+ * Search a position until its proof number reaches proofLimit or its
+ * disproof number reaches disproofLimit (the MID step of df-pn). The
+ * player to move wins if a move leaves the opponent lost, so the proof
+ * number is the smallest disproof number of the moves; they lose if
+ * every move leaves the opponent won, so the disproof number is the sum
+ * of their proof numbers. Each time round, the move with the smallest
+ * disproof number is searched, until it is no longer the smallest or
+ * the limits of the position are reached.
+ * A move no position below it has been searched from yet is worth 1 to
+ * prove, and the number of replies to disprove.
+ * The positions are kept in the table by the canonical key of their
+ * contracted board (see canonical.h), so the moves that lead to copies
+ * of one board share its entry.
+ * The key of a move is worked out only when the move is first picked,
+ * unless the key cache has it, and is kept while the search stays in
+ * the position. If the table then knows the move's position, its
+ * numbers are taken and a move is picked again.
+ * @param position the position; the game must not be over
+ * @param search the table, counters and clock of the search
+ * @param depth the moves made since the root
+ * @param node the key and moves of the position, worked out by its
+ *             parent
+ * @param proofLimit the proof number to stop at
+ * @param disproofLimit the disproof number to stop at
+ * @param result output: the position and its numbers, as stored in the
+ *               table
+ * @param bestMove output: the index of the edge to play, or -1 if there
+ *                 is no move worth playing
+ */
+void prove(Position *position, ProofSearch *search, int depth, ProofChild *node,
+           unsigned int proofLimit, unsigned int disproofLimit, ProofEntry *result,
+           int *bestMove) {
+    ProofStatistics *statistics = search->statistics;
+    long long firstNode = statistics->nodes++;
+    if (search->deadline != 0 && statistics->nodes % CLOCK_NODES == 0 &&
+        ticks() >= search->deadline) {
+        search->aborted = TRUE;
+    }
+
+    // A move that ends the game always wins it for the player who made
+    // it, so a move that leaves the opponent no move is a win
+    int *moves = node->moves;
+    int numberMoves = node->numberMoves;
+    ProofFrame *frame = frameAt(search, depth);
+    unsigned int proof[POSITION_MAX_EDGES];
+    unsigned int disproof[POSITION_MAX_EDGES];
+    unsigned int size[POSITION_MAX_EDGES];
+    for (int i = 0; i < numberMoves; i++) {
+        ProofChild *child = &frame->children[i];
+        positionMake(position, moves[i]);
+        child->numberMoves = alphaBetaMoves(position, child->moves);
+        KeyCacheEntry *slot = keyCacheSlot(search, position);
+        child->key = (child->numberMoves > 0 && slot->hash == position->hash) ? slot->key : 0;
+        positionUnmake(position, moves[i]);
+
+        ProofEntry *entry = (child->key != 0) ? lookup(search->table, child->key) : NULL;
+        if (entry != NULL) {
+            proof[i] = entry->proof;
+            disproof[i] = entry->disproof;
+            size[i] = entry->proofSize;
+        } else {
+            proof[i] = (child->numberMoves == 0) ? PROOF_INFINITY : 1;
+            disproof[i] = (unsigned int) child->numberMoves;
+            size[i] = 1;
+        }
+    }
+
+    result->key = node->key;
+    int best = -1;
+    for (;;) {
+        unsigned int smallest = PROOF_INFINITY;
+        unsigned int second = PROOF_INFINITY;
+        unsigned int sum = 0;
+        best = -1;
+        for (int i = 0; i < numberMoves; i++) {
+            sum = add(sum, proof[i]);
+            if (disproof[i] < smallest) {
+                second = smallest;
+                smallest = disproof[i];
+                best = i;
+            } else if (disproof[i] < second) {
+                second = disproof[i];
+            }
+        }
+        result->proof = smallest;
+        result->disproof = (smallest == 0) ? PROOF_INFINITY : sum;
+        if (result->proof >= proofLimit || result->disproof >= disproofLimit ||
+            search->aborted) {
+            break;
+        }
+
+        // The first time a move is picked, its position may be in the
+        // table from another line or an earlier search
+        ProofChild *child = &frame->children[best];
+        if (child->key == 0) {
+            positionMake(position, moves[best]);
+            KeyCacheEntry *slot = keyCacheSlot(search, position);
+            child->key = canonicalKey(position);
+            slot->hash = position->hash;
+            slot->key = child->key;
+            positionUnmake(position, moves[best]);
+            ProofEntry *entry = lookup(search->table, child->key);
+            if (entry != NULL) {
+                proof[best] = entry->proof;
+                disproof[best] = entry->disproof;
+                size[best] = entry->proofSize;
+                continue;
+            }
+        }
+
+        // The move may use what is left of the disproof limit, and can
+        // be searched until it costs more than the next best move
+        unsigned int moveProofLimit = add(disproofLimit - result->disproof, proof[best]);
+        unsigned int moveDisproofLimit = add(second, second / PROOF_EPSILON_SHARE + 1);
+        if (moveDisproofLimit > proofLimit) {
+            moveDisproofLimit = proofLimit;
+        }
+        ProofEntry move;
+        int reply;
+        positionMake(position, moves[best]);
+        prove(position, search, depth + 1, child, moveProofLimit, moveDisproofLimit, &move,
+              &reply);
+        positionUnmake(position, moves[best]);
+        proof[best] = move.proof;
+        disproof[best] = move.disproof;
+        size[best] = move.proofSize;
+    }
+
+    // A win needs the proof of one move, a loss the proofs of them all
+    result->proofSize = 0;
+    if (result->proof == 0) {
+        result->proofSize = add(1, size[best]);
+    } else if (result->disproof == 0) {
+        result->proofSize = 1;
+        for (int i = 0; i < numberMoves; i++) {
+            result->proofSize = add(result->proofSize, size[i]);
+            if (best == -1 || size[i] > size[best]) {
+                best = i;
+            }
+        }
+    }
+    long long work = statistics->nodes - firstNode;
+    result->work = (work < PROOF_INFINITY) ? (unsigned int) work : PROOF_INFINITY;
+    store(search->table, result);
+    *bestMove = (best == -1) ? -1 : moves[best];
+}
+
+/** -------------------------------------------------------------------
+ * Get the moves kept for the children of the position searched at a
+ * depth, making room for them the first time the depth is reached.
+ * @param search the search
+ * @param depth the moves made since the root
+ * @return the frame of the depth
+ */
+ProofFrame * frameAt(ProofSearch *search, int depth) {
+    if (search->frames[depth] == NULL) {
+        search->frames[depth] = malloc(sizeof(ProofFrame));
+        if (search->frames[depth] == NULL) {
+            printf("ERROR in frameAt. No memory for depth %d.\n", depth);
+            exit(1);
+        }
+    }
+    return search->frames[depth];
+}
+
+/** -------------------------------------------------------------------
+ * Get the slot of the key cache a position goes in.
+ * @param search the search
+ * @param position the position
+ * @return the slot; it holds the position's key if its hash matches
+ */
+KeyCacheEntry * keyCacheSlot(ProofSearch *search, Position *position) {
+    unsigned long long hash = position->hash;
+    return &search->keyCache[(hash ^ (hash >> 32)) & ((1u << KEY_CACHE_BITS) - 1)];
+}
+
+/** -------------------------------------------------------------------
+ * Find a position in the table.
+ * @param table the table
+ * @param key the hash of the position
+ * @return its entry, or NULL if it is not in the table
+ */
+ProofEntry * lookup(ProofTable *table, unsigned long long key) {
+    ProofEntry *bucket = &table->entries[(key & (table->numberBuckets - 1)) *
+                                         PROOF_BUCKET_ENTRIES];
+    for (int i = 0; i < PROOF_BUCKET_ENTRIES; i++) {
+        if (bucket[i].key == key) {
+            return &bucket[i];
+        }
+    }
+    return NULL;
+}
+
+/** -------------------------------------------------------------------
+ * Put a position in the table. It goes in its old entry or an empty
+ * one; if the bucket is full, it pushes out the position that took
+ * the least work to search.
+ * @param table the table
+ * @param result the position and its numbers
+ */
+void store(ProofTable *table, ProofEntry *result) {
+    ProofEntry *bucket = &table->entries[(result->key & (table->numberBuckets - 1)) *
+                                         PROOF_BUCKET_ENTRIES];
+    ProofEntry *victim = &bucket[0];
+    for (int i = 0; i < PROOF_BUCKET_ENTRIES; i++) {
+        if (bucket[i].key == result->key || bucket[i].key == 0) {
+            victim = &bucket[i];
+            break;
+        }
+        if (bucket[i].work < victim->work) {
+            victim = &bucket[i];
+        }
+    }
+    if (victim->key == 0) {
+        table->used++;
+    } else if (victim->key != result->key) {
+        table->replaced++;
+    }
+    *victim = *result;
+}
+
+/** -------------------------------------------------------------------
+ * Add two proof numbers. A sum never reaches PROOF_INFINITY unless one
+ * of the numbers is PROOF_INFINITY.
+ * @param a a proof number
+ * @param b another
+ * @return their sum
+ */
+unsigned int add(unsigned int a, unsigned int b) {
+    if (a >= PROOF_INFINITY || b >= PROOF_INFINITY) {
+        return PROOF_INFINITY;
+    }
+    return (a + b >= PROOF_INFINITY) ? PROOF_INFINITY - 1 : a + b;
+}
@@ -0,0 +1,108 @@
+/** proofNumber.h
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The definition of a depth-first proof-number search
+ *          (df-pn) that proves who wins a board, with a table
+ *          that fits in a fixed amount of memory.
+ * ===========================================================
+ */
+
+#ifndef PROOF_NUMBER_H
+#define PROOF_NUMBER_H
+
+#include "position.h"
+
+// The memory of the game's proof table
+#define PROOF_TABLE_MEGABYTES  32
+
+// The AIs that try to prove a win (see setEndgameProof) do so once this
+// few live edges are left, for at most 1/PROOF_ENDGAME_SHARE of their
+// move time
+#define PROOF_ENDGAME_EDGES    40
+#define PROOF_ENDGAME_SHARE     2
+
+// Alpha-beta search proves a position by searching every line to the
+// same depth. A proof-number search instead counts, for each position,
+// how many positions below it must still be shown to be wins for the
+// player to move to prove it (the proof number) or to disprove it (the
+// disproof number), and always works on the position that needs the
+// fewest. It goes down the narrowest lines first, and proves boards
+// alpha-beta cannot.
+//
+// Every position the search has worked on is kept in the table with
+// its two numbers. The table never grows: a bucket holds a few
+// positions, and a new position pushes out the one that took the
+// least work to search, which is the cheapest to search again.
+
+// One position in the table. A proof number of 0 means the player to
+// move wins, and a disproof number of 0 means they lose.
+typedef struct proofEntry {
+    unsigned long long key;    // The canonical key of the position (see
+                               //   canonical.h), 0 if empty
+    unsigned int proof;
+    unsigned int disproof;
+    unsigned int work;         // The positions searched below it
+    unsigned int proofSize;    // The nodes of its proof tree, once proven
+} ProofEntry;
+
+// A hash table of searched positions that fits in a set memory.
+typedef struct proofTable {
+    size_t bytes;              // The memory of the entries
+    int numberBuckets;         // A power of 2
+    ProofEntry * entries;      // The buckets, one after the other
+    int used;                  // The entries that hold a position
+    long long replaced;        // The positions pushed out so far
+} ProofTable;
+
+// Counters of one search.
+typedef struct proofStatistics {
+    long long nodes;           // Positions searched
+    long long proofSize;       // Nodes of the proof tree the search found
+                               //   (a position reached by two lines is two
+                               //   nodes); 0 if none was found
+    double milliseconds;       // How long the search took
+    size_t bytes;              // The memory of the table
+    int used;                  // Its entries that hold a position
+    long long replaced;        // The positions this search pushed out
+} ProofStatistics;
+
+/** -------------------------------------------------------------------
+ * Create an empty proof table.
+ * @param megabytes the memory of the table
+ * @return a pointer to a proof table struct
+ */
+ProofTable * proofTableCreate(int megabytes);
+
+/** -------------------------------------------------------------------
+ * Delete a proof table
+ * @param table the table to delete
+ */
+void proofTableDelete(ProofTable *table);
+
+/** -------------------------------------------------------------------
+ * Forget every entry of a proof table.
+ * @param table the table
+ */
+void proofTableClear(ProofTable *table);
+
+/** -------------------------------------------------------------------
+ * Prove who wins a position with a depth-first proof-number search.
+ * @param position the position; it is the same when the search returns
+ * @param table the proof table; it can be kept between turns
+ * @param milliseconds how long to search, or 0 for no limit
+ * @param bestMove output: the index of the edge to play, or -1 if the
+ *                 game is over or the player to move has no move
+ *                 worth playing. It wins if the player to move wins;
+ *                 if they lose, it is the move that takes the largest
+ *                 proof to beat.
+ * @param statistics output, may be NULL
+ * @return SHORT_WINS or CUT_WINS with perfect play, or GAME_UNDERWAY
+ *         if the time ran out first
+ */
+int proofSolve(Position *position, ProofTable *table, int milliseconds, int *bestMove,
+               ProofStatistics *statistics);
+
+#endif // PROOF_NUMBER_H
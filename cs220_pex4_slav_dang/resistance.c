@@ -0,0 +1,508 @@
+/** resistance.c
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The implementation of an electrical model of the board
+ *          that scores edges by the current they carry.
+ * ===========================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "resistance.h"
+
+// The node of a vertex that is not an unknown of the system
+#define OUTSIDE_NODE  -1    // Not connected to the terminals
+#define SOURCE_NODE   -2    // Joined to the starting vertex
+#define SINK_NODE     -3    // Joined to the ending vertex
+#define REACHED_NODE  -4    // Connected, but not numbered yet
+
+// Local functions
+static int numberNodes(ResistanceSolver *solver, Adjacency *board, Adjacency *locked);
+static void buildSystem(ResistanceSolver *solver, Adjacency *board, int reached);
+static void factor(ResistanceSolver *solver);
+static void conjugateGradient(ResistanceSolver *solver);
+static void multiply(ResistanceSolver *solver, double *in, double *out);
+static void forwardSolve(ResistanceSolver *solver, double *in, double *out);
+static void backwardSolve(ResistanceSolver *solver, double *in, double *out);
+
+/** -------------------------------------------------------------------
+ * Create a resistance solver.
+ * @param numberVertices the most vertices a board can have
+ * @param numberArcs the most arcs (twice the edges) a board can have
+ * @return a pointer to a resistance solver struct
+ */
+ResistanceSolver * resistanceCreate(int numberVertices, int numberArcs) {
+    ResistanceSolver *solver = calloc(1, sizeof(ResistanceSolver));
+    solver->capacity = numberVertices;
+    solver->arcCapacity = numberArcs;
+    solver->group = malloc(numberVertices * sizeof(int));
+    solver->unknown = malloc(numberVertices * sizeof(int));
+    solver->queue = malloc(numberVertices * sizeof(int));
+    solver->next = malloc(numberVertices * sizeof(int));
+    solver->offsets = malloc((numberVertices + 1) * sizeof(int));
+    solver->middle = malloc(numberVertices * sizeof(int));
+    solver->columns = malloc((numberArcs + 1) * sizeof(int));
+    solver->diagonal = malloc(numberVertices * sizeof(double));
+    solver->rhs = malloc(numberVertices * sizeof(double));
+    solver->x = malloc(numberVertices * sizeof(double));
+    solver->r = malloc(numberVertices * sizeof(double));
+    solver->p = malloc(numberVertices * sizeof(double));
+    solver->q = malloc(numberVertices * sizeof(double));
+    solver->t = malloc(numberVertices * sizeof(double));
+    solver->pivot = malloc(numberVertices * sizeof(double));
+    solver->inversePivot = malloc(numberVertices * sizeof(double));
+    solver->potential = malloc(numberVertices * sizeof(double));
+
+    if (solver->columns == NULL || solver->potential == NULL) {
+        printf("ERROR in resistanceCreate. Not enough memory for %d vertices.\n", numberVertices);
+        exit(1);
+    }
+    return solver;
+}
+
+/** -------------------------------------------------------------------
+ * Delete a resistance solver
+ * @param solver the solver to delete
+ */
+void resistanceDelete(ResistanceSolver *solver) {
+    free(solver->group);
+    free(solver->unknown);
+    free(solver->queue);
+    free(solver->next);
+    free(solver->offsets);
+    free(solver->middle);
+    free(solver->columns);
+    free(solver->diagonal);
+    free(solver->rhs);
+    free(solver->x);
+    free(solver->r);
+    free(solver->p);
+    free(solver->q);
+    free(solver->t);
+    free(solver->pivot);
+    free(solver->inversePivot);
+    free(solver->potential);
+    free(solver);
+}
+
+/** -------------------------------------------------------------------
+ * Find the voltage of every vertex, with the starting vertex (0) at 1
+ * volt and the ending vertex (numberVertices-1) at 0 volts. The solver
+ * starts from the voltages of the last solve of a board this size.
+ * @param solver the solver; it must be big enough for the board
+ * @param board the normal and locked edges
+ * @param locked the locked edges
+ * @return TRUE if the game is underway. Return FALSE if the terminals
+ *         are not connected, or are already joined by locked edges.
+ */
+int resistanceSolve(ResistanceSolver *solver, Adjacency *board, Adjacency *locked) {
+    int n = board->numberVertices;
+    if (n > solver->capacity || board->numberArcs > solver->arcCapacity) {
+        printf("ERROR in resistanceSolve. The board has %d vertices and %d arcs, the solver"
+               " holds %d and %d.\n", n, board->numberArcs, solver->capacity, solver->arcCapacity);
+        exit(1);
+    }
+    solver->iterations = 0;
+    solver->effectiveResistance = 0.0;
+
+    int reached = numberNodes(solver, board, locked);
+    if (reached == 0) {
+        for (int v = 0; v < n; v++) {
+            solver->potential[v] = -1.0;
+        }
+        solver->guessVertices = 0;
+        return FALSE;
+    }
+    buildSystem(solver, board, reached);
+
+    // Start from the last voltages of this board, which one move only
+    // changes a little. A node's guess is the average of its vertices.
+    double *count = solver->t;
+    for (int a = 0; a < solver->numberUnknowns; a++) {
+        solver->x[a] = 0.0;
+        count[a] = 0.0;
+    }
+    if (solver->guessVertices == n) {
+        for (int i = 0; i < reached; i++) {
+            int a = solver->unknown[solver->queue[i]];
+            if (a >= 0) {
+                solver->x[a] += solver->potential[solver->queue[i]];
+                count[a] += 1.0;
+            }
+        }
+        for (int a = 0; a < solver->numberUnknowns; a++) {
+            solver->x[a] /= count[a];
+        }
+    }
+    conjugateGradient(solver);
+
+    for (int v = 0; v < n; v++) {
+        solver->potential[v] = -1.0;
+    }
+
+    for (int i = 0; i < reached; i++) {
+        int v = solver->queue[i];
+        int a = solver->unknown[v];
+        solver->potential[v] = (a == SOURCE_NODE) ? 1.0 : (a == SINK_NODE) ? 0.0 : solver->x[a];
+    }
+
+    // The current that leaves the start; the voltage is 1, so the
+    // effective resistance is 1/current
+    double current = 0.0;
+    for (int i = 0; i < reached; i++) {
+        int v = solver->queue[i];
+        if (solver->unknown[v] == SOURCE_NODE) {
+            for (int k = board->offsets[v]; k < board->offsets[v+1]; k++) {
+                current += 1.0 - solver->potential[board->neighbors[k]];
+            }
+        }
+    }
+    solver->effectiveResistance = (current > 0.0) ? 1.0 / current : INFINITY;
+    solver->guessVertices = n;
+    return TRUE;
+}
+
+/** -------------------------------------------------------------------
+ * Forget the last voltages, so the next solve starts from nothing.
+ * Call it before solving a different board.
+ * @param solver the solver
+ */
+void resistanceForget(ResistanceSolver *solver) {
+    solver->guessVertices = 0;
+}
+
+/** -------------------------------------------------------------------
+ * Get the current through a normal edge. The more current an edge
+ * carries, the more the resistance between the terminals changes when
+ * it is locked or cut. resistanceSolve() must be called first.
+ * @param solver the solver
+ * @param fromVertex one end of the edge
+ * @param toVertex the other end of the edge
+ * @return the current, in amps
+ */
+double resistanceCurrent(ResistanceSolver *solver, int fromVertex, int toVertex) {
+    double a = solver->potential[fromVertex];
+    double b = solver->potential[toVertex];
+    if (a < 0.0 || b < 0.0) {
+        return 0.0;
+    }
+    return fabs(a - b);
+}
+
+/** -------------------------------------------------------------------
+ * Merge the vertices joined by locked edges and number the nodes that
+ * are connected to the terminals. solver->queue lists the connected
+ * vertices when it returns.
+ * @param solver the solver
+ * @param board the normal and locked edges
+ * @param locked the locked edges
+ * @return the number of connected vertices, or 0 if the game is over
+ */
+int numberNodes(ResistanceSolver *solver, Adjacency *board, Adjacency *locked) {
+    int n = board->numberVertices;
+    int *group = solver->group;
+    int *unknown = solver->unknown;
+    int *queue = solver->queue;
+    for (int v = 0; v < n; v++) {
+        group[v] = v;
+        unknown[v] = OUTSIDE_NODE;
+    }
+    for (int v = 0; v < n; v++) {
+        for (int k = locked->offsets[v]; k < locked->offsets[v+1]; k++) {
+            group[findGroup(group, v)] = findGroup(group, locked->neighbors[k]);
+        }
+    }
+    int source = findGroup(group, 0);
+    int sink = findGroup(group, n - 1);
+    if (source == sink) {
+        return 0; // Short has won
+    }
+
+    // The vertices connected to the start
+    int tail = 0;
+    unknown[0] = REACHED_NODE;
+    queue[tail++] = 0;
+    for (int head = 0; head < tail; head++) {
+        int v = queue[head];
+        for (int k = board->offsets[v]; k < board->offsets[v+1]; k++) {
+            int w = board->neighbors[k];
+            if (unknown[w] == OUTSIDE_NODE) {
+                unknown[w] = REACHED_NODE;
+                queue[tail++] = w;
+            }
+        }
+    }
+    if (unknown[n-1] == OUTSIDE_NODE) {
+        return 0; // Cut has won
+    }
+
+    // Number the groups first, then give every vertex its group's node
+    solver->numberUnknowns = 0;
+    for (int i = 0; i < tail; i++) {
+        int v = queue[i];
+        if (group[v] == v) {
+            unknown[v] = (v == source) ? SOURCE_NODE : (v == sink) ? SINK_NODE
+                                                                   : solver->numberUnknowns++;
+        }
+    }
+    for (int i = 0; i < tail; i++) {
+        int v = queue[i];
+        unknown[v] = unknown[findGroup(group, v)];
+    }
+    return tail;
+}
+
+/** -------------------------------------------------------------------
+ * Build the weighted Laplacian of the nodes (the conductance matrix).
+ * An edge inside a group carries no current and is left out; an edge
+ * to the start moves to the right hand side, and an edge to the end
+ * (at 0 volts) only adds to the diagonal.
+ * @param solver the solver; the nodes are numbered
+ * @param board the normal and locked edges
+ * @param reached the number of connected vertices in solver->queue
+ */
+void buildSystem(ResistanceSolver *solver, Adjacency *board, int reached) {
+    int m = solver->numberUnknowns;
+    int *unknown = solver->unknown;
+    int *offsets = solver->offsets;
+    int *middle = solver->middle;
+    for (int a = 0; a <= m; a++) {
+        offsets[a] = 0;
+    }
+    for (int a = 0; a < m; a++) {
+        middle[a] = 0;
+        solver->diagonal[a] = 0.0;
+        solver->rhs[a] = 0.0;
+    }
+
+    // Count the entries of each row, and the ones below the diagonal
+    for (int i = 0; i < reached; i++) {
+        int v = solver->queue[i];
+        int a = unknown[v];
+        if (a < 0) {
+            continue;
+        }
+        for (int k = board->offsets[v]; k < board->offsets[v+1]; k++) {
+            int b = unknown[board->neighbors[k]];
+            if (b != a) {
+                solver->diagonal[a] += 1.0;
+                if (b == SOURCE_NODE) {
+                    solver->rhs[a] += 1.0;
+                } else if (b >= 0) {
+                    offsets[a+1]++;
+                    middle[a] += (b < a);
+                }
+            }
+        }
+    }
+    for (int a = 0; a < m; a++) {
+        offsets[a+1] += offsets[a];
+    }
+
+    // Fill them in, the lower triangle first in each row
+    int *next = solver->next;
+    for (int a = 0; a < m; a++) {
+        next[a] = offsets[a];
+        middle[a] += offsets[a];
+    }
+    for (int i = 0; i < reached; i++) {
+        int v = solver->queue[i];
+        int a = unknown[v];
+        if (a < 0) {
+            continue;
+        }
+        for (int k = board->offsets[v]; k < board->offsets[v+1]; k++) {
+            int b = unknown[board->neighbors[k]];
+            if (b >= 0 && b < a) {
+                solver->columns[next[a]++] = b;
+            } else if (b > a) {
+                solver->columns[middle[a]++] = b;
+            }
+        }
+    }
+    for (int a = 0; a < m; a++) {
+        middle[a] = next[a];
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Find the pivots of the preconditioner, an incomplete Cholesky
+ * factorization that keeps the off-diagonal entries of the matrix and
+ * only changes its diagonal: M = (P + L) P^-1 (P + L^T), where L is the
+ * lower triangle of the matrix. The fill-in that is dropped is mostly
+ * added back to the diagonal (modified incomplete Cholesky), which
+ * keeps the row sums of M close to those of the matrix.
+ * @param solver the solver; the system is built
+ */
+void factor(ResistanceSolver *solver) {
+    int *offsets = solver->offsets;
+    int *middle = solver->middle;
+    double *inverse = solver->inversePivot;
+    for (int a = 0; a < solver->numberUnknowns; a++) {
+        double d = solver->diagonal[a];
+        for (int k = offsets[a]; k < middle[a]; k++) {
+            int b = solver->columns[k];
+            int later = offsets[b+1] - middle[b]; // Entries to the right of b's pivot
+            d -= (1.0 + RESISTANCE_MODIFICATION * (later - 1)) * inverse[b];
+        }
+
+        // A pivot that is too small would make the preconditioner blow up
+        double smallest = RESISTANCE_MIN_PIVOT * solver->diagonal[a];
+        solver->pivot[a] = (d > smallest) ? d : smallest;
+        inverse[a] = 1.0 / solver->pivot[a];
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Solve the system with the preconditioned conjugate gradient method.
+ * solver->x holds the first guess and the solution.
+ *
+ * The preconditioner is M = (P + L) P^-1 (P + L^T). Eisenstat's trick
+ * runs the method on B = (P + L)^-1 A (P + L^T)^-1 instead, with P as
+ * the preconditioner, which takes the same steps. Since A is
+ * (P + L) + (P + L^T) + (D - 2P), where D is its diagonal,
+ * B p = t + (P + L)^-1 (p + (D - 2P) t) with t = (P + L^T)^-1 p, so
+ * each step is one backward and one forward sweep over the matrix
+ * instead of a product and two sweeps. The residual of B is
+ * r' = (P + L)^-1 r, and the solver stops once r'^T P r' = r^T M^-1 r
+ * is small enough.
+ * @param solver the solver; the system is built
+ */
+void conjugateGradient(ResistanceSolver *solver) {
+    int m = solver->numberUnknowns;
+    int *offsets = solver->offsets;
+    int *middle = solver->middle;
+    int *columns = solver->columns;
+    double *diagonal = solver->diagonal;
+    double *pivot = solver->pivot;
+    double *inverse = solver->inversePivot;
+    double *x = solver->x;
+    double *r = solver->r;
+    double *p = solver->p;
+    double *q = solver->q;
+    double *t = solver->t;
+
+    factor(solver);
+    forwardSolve(solver, solver->rhs, q);
+    double limit = 0.0;
+    for (int a = 0; a < m; a++) {
+        limit += q[a] * pivot[a] * q[a];
+    }
+    limit *= RESISTANCE_TOLERANCE * RESISTANCE_TOLERANCE;
+
+    // r' = (P + L)^-1 (rhs - A x), then x' = (P + L^T) x
+    multiply(solver, x, q);
+    for (int a = 0; a < m; a++) {
+        q[a] = solver->rhs[a] - q[a];
+    }
+    forwardSolve(solver, q, r);
+    double rz = 0.0;
+    for (int a = 0; a < m; a++) {
+        double sum = pivot[a] * x[a];
+        for (int k = middle[a]; k < offsets[a+1]; k++) {
+            sum -= x[columns[k]];
+        }
+        x[a] = sum;
+        rz += r[a] * pivot[a] * r[a];
+    }
+
+    double beta = 0.0;
+    while (solver->iterations < RESISTANCE_MAX_ITERATIONS && rz > limit) {
+        solver->iterations++;
+
+        // The new direction p = P r' + beta p, and t = (P + L^T)^-1 p
+        for (int a = m - 1; a >= 0; a--) {
+            p[a] = pivot[a] * r[a] + beta * p[a];
+            double sum = p[a];
+            for (int k = middle[a]; k < offsets[a+1]; k++) {
+                sum += t[columns[k]];
+            }
+            t[a] = sum * inverse[a];
+        }
+
+        // q = B p
+        double pq = 0.0;
+        for (int a = 0; a < m; a++) {
+            double sum = p[a] + (diagonal[a] - 2.0 * pivot[a]) * t[a];
+            for (int k = offsets[a]; k < middle[a]; k++) {
+                sum += q[columns[k]] - t[columns[k]];
+            }
+            q[a] = sum * inverse[a] + t[a];
+            pq += p[a] * q[a];
+        }
+
+        double alpha = rz / pq;
+        double previous = rz;
+        rz = 0.0;
+        for (int a = 0; a < m; a++) {
+            x[a] += alpha * p[a];
+            r[a] -= alpha * q[a];
+            rz += r[a] * pivot[a] * r[a];
+        }
+        beta = rz / previous;
+    }
+
+    // x = (P + L^T)^-1 x'
+    backwardSolve(solver, x, x);
+}
+
+/** -------------------------------------------------------------------
+ * Solve (P + L) out = in, where L is the lower triangle of the matrix.
+ * @param solver the solver; the pivots are found
+ * @param in the right hand side
+ * @param out output: the solution
+ */
+void forwardSolve(ResistanceSolver *solver, double *in, double *out) {
+    int *offsets = solver->offsets;
+    int *middle = solver->middle;
+    int *columns = solver->columns;
+    double *inverse = solver->inversePivot;
+    for (int a = 0; a < solver->numberUnknowns; a++) {
+        double sum = in[a];
+        for (int k = offsets[a]; k < middle[a]; k++) {
+            sum += out[columns[k]];
+        }
+        out[a] = sum * inverse[a];
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Solve (P + L^T) out = in, where L^T is the upper triangle of the
+ * matrix. in and out may be the same vector.
+ * @param solver the solver; the pivots are found
+ * @param in the right hand side
+ * @param out output: the solution
+ */
+void backwardSolve(ResistanceSolver *solver, double *in, double *out) {
+    int *offsets = solver->offsets;
+    int *middle = solver->middle;
+    int *columns = solver->columns;
+    double *inverse = solver->inversePivot;
+    for (int a = solver->numberUnknowns - 1; a >= 0; a--) {
+        double sum = in[a];
+        for (int k = middle[a]; k < offsets[a+1]; k++) {
+            sum += out[columns[k]];
+        }
+        out[a] = sum * inverse[a];
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Multiply a vector by the conductance matrix.
+ * @param solver the solver; the system is built
+ * @param in the vector
+ * @param out output: the product
+ */
+void multiply(ResistanceSolver *solver, double *in, double *out) {
+    for (int a = 0; a < solver->numberUnknowns; a++) {
+        double sum = solver->diagonal[a] * in[a];
+        for (int k = solver->offsets[a]; k < solver->offsets[a+1]; k++) {
+            sum -= in[solver->columns[k]];
+        }
+        out[a] = sum;
+    }
+}
@@ -0,0 +1,114 @@
+/** resistance.h
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The definition of an electrical model of the board
+ *          that scores edges by the current they carry.
+ * ===========================================================
+ */
+
+#ifndef RESISTANCE_H
+#define RESISTANCE_H
+
+#include "Graph.h"
+#include "gameLogic.h"
+
+// The conjugate gradient stops once the residual is this small,
+// relative to the right hand side (both measured in the norm of the
+// preconditioner)
+#define RESISTANCE_TOLERANCE       1.0e-4
+#define RESISTANCE_MAX_ITERATIONS  10000
+
+// How much of the dropped fill-in the preconditioner adds back to its
+// diagonal (1 would be all of it), and its smallest pivot relative to
+// the diagonal of the matrix
+#define RESISTANCE_MODIFICATION    0.99
+#define RESISTANCE_MIN_PIVOT       0.05
+
+// The board as a resistor network: every normal edge is a 1 ohm
+// resistor and a cut edge is removed. A locked edge has no resistance,
+// so the vertices it joins are merged into one node. The starting
+// vertex is held at 1 volt and the ending vertex at 0 volts, and the
+// voltages of the other nodes are found with a conjugate gradient
+// solver, preconditioned with an incomplete Cholesky factorization.
+// Only the nodes connected to the terminals are solved for.
+typedef struct resistanceSolver {
+    int capacity;              // The number of vertices the buffers hold
+    int arcCapacity;           // The number of arcs the buffers hold
+    int * group;               // Union-find of the vertices joined by
+                               //   locked edges
+    int * unknown;             // The node of each vertex in the system
+    int * queue;
+    int * next;
+
+    // The linear system of the unknown voltages, with one row per node
+    int numberUnknowns;
+    int * offsets;             // The nodes next to node a are
+    int * columns;             //   columns[offsets[a]..offsets[a+1]-1],
+    int * middle;              //   the ones numbered below a before middle[a]
+    double * diagonal;         // The number of edges at each node
+    double * rhs;              // The edges from each node to the start
+    double * x;                // The voltages
+    double * r;                // Conjugate gradient vectors
+    double * p;
+    double * q;
+    double * t;
+    double * pivot;            // The diagonal of the preconditioner
+    double * inversePivot;     // 1 / pivot
+
+    // The results of the last solve
+    double * potential;        // The voltage of each vertex, or -1.0 if
+                               //   it is not connected to the terminals
+    int guessVertices;         // The size of the board the voltages are
+                               //   for, or 0 if there are none
+    int iterations;
+    double effectiveResistance;
+} ResistanceSolver;
+
+/** -------------------------------------------------------------------
+ * Create a resistance solver.
+ * @param numberVertices the most vertices a board can have
+ * @param numberArcs the most arcs (twice the edges) a board can have
+ * @return a pointer to a resistance solver struct
+ */
+ResistanceSolver * resistanceCreate(int numberVertices, int numberArcs);
+
+/** -------------------------------------------------------------------
+ * Delete a resistance solver
+ * @param solver the solver to delete
+ */
+void resistanceDelete(ResistanceSolver *solver);
+
+/** -------------------------------------------------------------------
+ * Find the voltage of every vertex, with the starting vertex (0) at 1
+ * volt and the ending vertex (numberVertices-1) at 0 volts. The solver
+ * starts from the voltages of the last solve of a board this size.
+ * @param solver the solver; it must be big enough for the board
+ * @param board the normal and locked edges
+ * @param locked the locked edges
+ * @return TRUE if the game is underway. Return FALSE if the terminals
+ *         are not connected, or are already joined by locked edges.
+ */
+int resistanceSolve(ResistanceSolver *solver, Adjacency *board, Adjacency *locked);
+
+/** -------------------------------------------------------------------
+ * Get the current through a normal edge. The more current an edge
+ * carries, the more the resistance between the terminals changes when
+ * it is locked or cut. resistanceSolve() must be called first.
+ * @param solver the solver
+ * @param fromVertex one end of the edge
+ * @param toVertex the other end of the edge
+ * @return the current, in amps
+ */
+double resistanceCurrent(ResistanceSolver *solver, int fromVertex, int toVertex);
+
+/** -------------------------------------------------------------------
+ * Forget the last voltages, so the next solve starts from nothing.
+ * Call it before solving a different board.
+ * @param solver the solver
+ */
+void resistanceForget(ResistanceSolver *solver);
+
+#endif // RESISTANCE_H
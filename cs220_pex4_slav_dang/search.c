@@ -0,0 +1,557 @@
+/** search.c
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The implementation of the graph search engine used by
+ *          the game and the AI players.
+ * ===========================================================
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "search.h"
+#include "gameLogic.h"
+
+// Beamer's heuristic: go bottom-up once the edges leaving the frontier
+// are more than 1/BFS_ALPHA of the edges still unexplored, and go back
+// top-down once the frontier holds less than 1/BFS_BETA of the vertices.
+#define BFS_ALPHA  14
+#define BFS_BETA   24
+
+// Number of vertices handed to a single task, and the size of the
+// buffer a task fills before reserving room in the next frontier.
+#define BFS_CHUNK         1024
+#define BFS_LOCAL_BUFFER   256
+
+// Everything the tasks of one breadth-first search level share.
+typedef struct bfsState {
+    Adjacency * adjacency;
+    int * parent;
+    int * frontier;          // Current frontier as a list (top-down)
+    int frontierSize;
+    int * next;              // Next frontier as a list (top-down)
+    volatile LONG nextSize;
+    char * inFrontier;       // Current frontier as a map (bottom-up)
+    char * inNext;           // Next frontier as a map (bottom-up)
+    volatile LONGLONG nextArcs;  // Sum of the degrees of the next frontier
+} BfsState;
+
+// Local functions
+static void clearParentsTask(void *context, int taskIndex, int workerIndex);
+static void topDownTask(void *context, int taskIndex, int workerIndex);
+static void bottomUpTask(void *context, int taskIndex, int workerIndex);
+static int numberChunks(int size);
+static int countPaths(Graph *graph, SearchWorkspace *workspace, int source,
+                      unsigned int *reached, int *dist, double *count, int *queue);
+static int buildPath(int *path, int numberVertices, int *prev, int reachedEnd);
+static int findArc(Adjacency *adjacency, int from, int to);
+
+static ThreadPool * sharedPool = NULL;
+
+/** -------------------------------------------------------------------
+ * Direction-optimizing, level-synchronous parallel breadth-first
+ * search (Beamer, Asanovic and Patterson). Small frontiers are expanded
+ * top-down; once the frontier touches a large part of the graph the
+ * search switches to bottom-up steps in which every unvisited vertex
+ * looks for a parent in the frontier.
+ * @param adjacency the graph to search
+ * @param source the vertex the search starts from
+ * @param parent output: parent[v] is the vertex that discovered v,
+ *               parent[source] == source and -1 if v was not reached.
+ *               Must hold adjacency->numberVertices entries.
+ * @param pool the threads that run the search
+ * @param workspace scratch memory for at least numberVertices vertices
+ * @param statistics output, may be NULL
+ * @return the number of vertices reached, including the source
+ */
+int parallelBfs(Adjacency *adjacency, int source, int *parent, ThreadPool *pool,
+                SearchWorkspace *workspace, BfsStatistics *statistics) {
+    int n = adjacency->numberVertices;
+    if (workspace->capacity < n) {
+        printf("ERROR in parallelBfs. The workspace is too small for %d vertices.\n", n);
+        exit(1);
+    }
+
+    BfsState state;
+    state.adjacency = adjacency;
+    state.parent = parent;
+    state.frontier = workspace->queue;
+    state.next = workspace->order;
+    state.inFrontier = workspace->mark;
+    state.inNext = workspace->otherMark;
+
+    threadPoolFor(pool, numberChunks(n), clearParentsTask, &state);
+
+    parent[source] = source;
+    state.frontier[0] = source;
+    state.frontierSize = 1;
+    long long frontierArcs = adjacency->offsets[source+1] - adjacency->offsets[source];
+    long long unexploredArcs = adjacency->numberArcs - frontierArcs;
+    int reached = 1;
+    int bottomUp = FALSE;
+    BfsStatistics stats = {0, 0, 0, 0};
+
+    while (state.frontierSize > 0) {
+        // Pick the direction of this step, converting the frontier
+        // between its list and map representations when it changes.
+        if (!bottomUp && frontierArcs > unexploredArcs / BFS_ALPHA) {
+            memset(state.inFrontier, 0, (size_t) n);
+            for (int j = 0; j < state.frontierSize; j++) {
+                state.inFrontier[state.frontier[j]] = TRUE;
+            }
+            bottomUp = TRUE;
+        } else if (bottomUp && state.frontierSize < n / BFS_BETA) {
+            int size = 0;
+            for (int v = 0; v < n; v++) {
+                if (state.inFrontier[v]) {
+                    state.frontier[size++] = v;
+                }
+            }
+            bottomUp = FALSE;
+        }
+
+        state.nextSize = 0;
+        state.nextArcs = 0;
+        if (bottomUp) {
+            memset(state.inNext, 0, (size_t) n);
+            threadPoolFor(pool, numberChunks(n), bottomUpTask, &state);
+            char *swap = state.inFrontier;
+            state.inFrontier = state.inNext;
+            state.inNext = swap;
+            stats.bottomUpSteps++;
+        } else {
+            threadPoolFor(pool, numberChunks(state.frontierSize), topDownTask, &state);
+            int *swap = state.frontier;
+            state.frontier = state.next;
+            state.next = swap;
+            stats.topDownSteps++;
+        }
+
+        state.frontierSize = (int) state.nextSize;
+        frontierArcs = state.nextArcs;
+        unexploredArcs -= frontierArcs;
+        reached += state.frontierSize;
+        stats.levels++;
+    }
+
+    stats.verticesReached = reached;
+    if (statistics != NULL) {
+        *statistics = stats;
+    }
+    return reached;
+}
+
+/** -------------------------------------------------------------------
+ * Find a shortest path from the starting vertex (0) to the ending
+ * vertex (numberVertices-1) using the parallel breadth-first search.
+ * Every edge that is not NO_EDGE costs 1. The edges are copied into
+ * the workspace the first time a board is searched; after that
+ * workspaceObserve() keeps them up to date.
+ * @param graph the graph
+ * @param workspace scratch memory for the search
+ * @param path output: the vertices of the path, the ending vertex
+ *             first and the starting vertex last. Must hold
+ *             graph->numberVertices entries.
+ * @return the number of vertices on the path; 0 if no path exists
+ */
+int bfsShortestPath(Graph *graph, SearchWorkspace *workspace, int *path) {
+    if (workspace->boardGraph != graph) {
+        if (workspace->board != NULL) {
+            adjacencyDelete(workspace->board);
+        }
+        workspace->board = adjacencyFromGraph(graph, NORMAL_EDGE);
+        workspace->boardGraph = graph;
+    }
+    int *parent = workspace->prev;
+    parallelBfs(workspace->board, 0, parent, searchThreadPool(), workspace, NULL);
+
+    int end = graph->numberVertices - 1;
+    return buildPath(path, graph->numberVertices, parent, parent[end] != -1);
+}
+
+/** -------------------------------------------------------------------
+ * Count, for every edge, the number of shortest paths between two
+ * vertices that go through it (the s-t edge betweenness). It takes one
+ * breadth-first search from each end, so the time is O(V+E). Every
+ * edge that is not NO_EDGE costs 1.
+ * @param graph the graph
+ * @param workspace scratch memory for the search
+ * @param start one end of the paths
+ * @param end the other end of the paths
+ * @return the number of edges on at least one shortest path; 0 if end
+ *         can't be reached. The edges are left in workspace->edges,
+ *         oriented from start toward end and in order of their distance
+ *         from start, and workspace->scores[k] is the number of shortest
+ *         paths through workspace->edges[k].
+ */
+int edgeBetweenness(Graph *graph, SearchWorkspace *workspace, int start, int end) {
+    workspaceReserveEdges(workspace, graphNumberEdges(graph));
+    workspaceBegin(workspace);
+    unsigned int generation = workspace->generation;
+    int *distStart = workspace->dist;
+    int *distEnd = workspace->otherDist;
+    double *countStart = workspace->count;
+    double *countEnd = workspace->otherCount;
+
+    // The search from the end stamps "settled", the one from the start
+    // stamps "reached", so both sets of results stay valid.
+    countPaths(graph, workspace, end, workspace->settled, distEnd, countEnd, workspace->queue);
+    int numberReached = countPaths(graph, workspace, start, workspace->reached,
+                                   distStart, countStart, workspace->order);
+
+    // (u,v) is on a shortest path when start..u, u-v and v..end add up
+    // to the shortest distance. The paths through it are then every
+    // shortest start..u path followed by every shortest v..end path.
+    int numberFound = 0;
+    if (workspace->reached[end] == generation) {
+        int length = distStart[end];
+        for (int j = 0; j < numberReached; j++) {
+            int u = workspace->order[j];
+            for (int k = 0; k < graph->degree[u]; k++) {
+                int v = graph->neighbors[u][k];
+                if (workspace->settled[v] == generation && distStart[u] + 1 + distEnd[v] == length) {
+                    workspace->edges[numberFound].fromVertex = u;
+                    workspace->edges[numberFound].toVertex = v;
+                    workspace->scores[numberFound] = countStart[u] * countEnd[v];
+                    numberFound++;
+                }
+            }
+        }
+    }
+
+    return numberFound;
+}
+
+/** -------------------------------------------------------------------
+ * Create the scratch memory for searches of graphs with up to
+ * numberVertices vertices.
+ * @param numberVertices the number of vertices
+ * @return a pointer to a workspace struct
+ */
+SearchWorkspace * workspaceCreate(int numberVertices) {
+    SearchWorkspace *workspace = malloc(sizeof(SearchWorkspace));
+    workspace->capacity = numberVertices;
+    workspace->generation = 0;
+    workspace->reached = calloc((size_t) numberVertices, sizeof(unsigned int));
+    workspace->settled = calloc((size_t) numberVertices, sizeof(unsigned int));
+    workspace->dist = malloc(numberVertices * sizeof(int));
+    workspace->prev = malloc(numberVertices * sizeof(int));
+    workspace->count = malloc(numberVertices * sizeof(double));
+    workspace->otherDist = malloc(numberVertices * sizeof(int));
+    workspace->otherCount = malloc(numberVertices * sizeof(double));
+    workspace->queue = malloc(numberVertices * sizeof(int));
+    workspace->order = malloc(numberVertices * sizeof(int));
+    workspace->mark = malloc((size_t) numberVertices);
+    workspace->otherMark = malloc((size_t) numberVertices);
+    workspace->path = malloc(numberVertices * sizeof(int));
+    workspace->heap = heapCreate(numberVertices);
+    workspace->boardGraph = NULL;
+    workspace->board = NULL;
+    workspace->edgeCapacity = 0;
+    workspace->edges = NULL;
+    workspace->scores = NULL;
+
+    if (workspace->reached == NULL || workspace->settled == NULL ||
+        workspace->count == NULL || workspace->otherCount == NULL ||
+        workspace->mark == NULL || workspace->otherMark == NULL) {
+        printf("ERROR in workspaceCreate. Not enough memory for %d vertices.\n", numberVertices);
+        exit(1);
+    }
+    return workspace;
+}
+
+/** -------------------------------------------------------------------
+ * Delete a search workspace.
+ * @param workspace the workspace to delete
+ */
+void workspaceDelete(SearchWorkspace *workspace) {
+    free(workspace->reached);
+    free(workspace->settled);
+    free(workspace->dist);
+    free(workspace->prev);
+    free(workspace->count);
+    free(workspace->otherDist);
+    free(workspace->otherCount);
+    free(workspace->queue);
+    free(workspace->order);
+    free(workspace->mark);
+    free(workspace->otherMark);
+    free(workspace->path);
+    heapDelete(workspace->heap);
+    if (workspace->board != NULL) {
+        adjacencyDelete(workspace->board);
+    }
+    free(workspace->edges);
+    free(workspace->scores);
+    free(workspace);
+}
+
+/** -------------------------------------------------------------------
+ * Start a new search: every vertex becomes unreached in O(1) time.
+ * @param workspace the workspace
+ */
+void workspaceBegin(SearchWorkspace *workspace) {
+    workspace->generation++;
+    if (workspace->generation == 0) {
+        // The stamps wrapped around (once every 4 billion searches), so
+        // old stamps could look current. Clear them for real.
+        memset(workspace->reached, 0, workspace->capacity * sizeof(unsigned int));
+        memset(workspace->settled, 0, workspace->capacity * sizeof(unsigned int));
+        workspace->generation = 1;
+    }
+    heapClear(workspace->heap);
+}
+
+/** -------------------------------------------------------------------
+ * Update the workspace's copy of the board's edges after a move. Call
+ * it after the edge state has been changed on the board. A cut edge's
+ * arcs are turned to point back at their own vertex, which a search
+ * never follows, so the copy is not rebuilt.
+ * @param workspace the workspace
+ * @param graph the board
+ * @param fromVertex one end of the edge
+ * @param toVertex the other end of the edge
+ * @param state the new state of the edge
+ */
+void workspaceObserve(SearchWorkspace *workspace, Graph *graph, int fromVertex, int toVertex,
+                      int state) {
+    if (workspace->boardGraph != graph) {
+        return; // It is copied from scratch on the next search anyway
+    }
+    Adjacency *board = workspace->board;
+    int forward = findArc(board, fromVertex, toVertex);
+    if (state == NO_EDGE) {
+        if (forward != -1) {
+            board->neighbors[forward] = fromVertex;
+            board->neighbors[findArc(board, toVertex, fromVertex)] = toVertex;
+        }
+    } else if (forward == -1) {
+        // An edge came back, and there is no arc left for it
+        workspace->boardGraph = NULL;
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Make sure there is room for per-edge results.
+ * @param workspace the workspace
+ * @param numberEdges the number of edges that must fit
+ */
+void workspaceReserveEdges(SearchWorkspace *workspace, int numberEdges) {
+    if (numberEdges > workspace->edgeCapacity) {
+        workspace->edgeCapacity = numberEdges;
+        workspace->edges = realloc(workspace->edges, numberEdges * sizeof(Edge));
+        workspace->scores = realloc(workspace->scores, numberEdges * sizeof(double));
+        if (workspace->edges == NULL || workspace->scores == NULL) {
+            printf("ERROR in workspaceReserveEdges. Not enough memory for %d edges.\n", numberEdges);
+            exit(1);
+        }
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Get the thread pool shared by everything in the game that runs in
+ * parallel, so they all fit in one thread per processor. It is created
+ * the first time it is needed.
+ * @return the shared thread pool
+ */
+ThreadPool * searchThreadPool() {
+    if (sharedPool == NULL) {
+        sharedPool = threadPoolCreate(numberProcessors());
+    }
+    return sharedPool;
+}
+
+/** -------------------------------------------------------------------
+ * Mark one chunk of vertices as not reached.
+ * @param context the BfsState
+ * @param taskIndex which chunk of vertices
+ * @param workerIndex not used
+ */
+void clearParentsTask(void *context, int taskIndex, int workerIndex) {
+    BfsState *state = (BfsState *) context;
+    int first = taskIndex * BFS_CHUNK;
+    int last = first + BFS_CHUNK;
+    if (last > state->adjacency->numberVertices) {
+        last = state->adjacency->numberVertices;
+    }
+    for (int v = first; v < last; v++) {
+        state->parent[v] = -1;
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Expand one chunk of the frontier top-down. Each neighbor that has
+ * not been reached is claimed with a compare-and-swap on its parent,
+ * so exactly one task adds it to the next frontier.
+ * @param context the BfsState
+ * @param taskIndex which chunk of the frontier
+ * @param workerIndex not used
+ */
+void topDownTask(void *context, int taskIndex, int workerIndex) {
+    BfsState *state = (BfsState *) context;
+    int *offsets = state->adjacency->offsets;
+    int *neighbors = state->adjacency->neighbors;
+    int buffer[BFS_LOCAL_BUFFER];
+    int count = 0;
+    long long arcs = 0;
+
+    int first = taskIndex * BFS_CHUNK;
+    int last = first + BFS_CHUNK;
+    if (last > state->frontierSize) {
+        last = state->frontierSize;
+    }
+
+    for (int j = first; j < last; j++) {
+        int u = state->frontier[j];
+        for (int arc = offsets[u]; arc < offsets[u+1]; arc++) {
+            int w = neighbors[arc];
+            if (state->parent[w] == -1 &&
+                InterlockedCompareExchange((volatile LONG *) &state->parent[w], u, -1) == -1) {
+                buffer[count++] = w;
+                arcs += offsets[w+1] - offsets[w];
+                if (count == BFS_LOCAL_BUFFER) {
+                    int base = InterlockedExchangeAdd(&state->nextSize, count);
+                    memcpy(state->next + base, buffer, count * sizeof(int));
+                    count = 0;
+                }
+            }
+        }
+    }
+
+    if (count > 0) {
+        int base = InterlockedExchangeAdd(&state->nextSize, count);
+        memcpy(state->next + base, buffer, count * sizeof(int));
+    }
+    InterlockedExchangeAdd64(&state->nextArcs, arcs);
+}
+
+/** -------------------------------------------------------------------
+ * Expand one chunk of vertices bottom-up. Every vertex that has not
+ * been reached looks for any neighbor in the frontier. Only the task
+ * that owns a vertex writes its parent, so no atomics are needed.
+ * @param context the BfsState
+ * @param taskIndex which chunk of vertices
+ * @param workerIndex not used
+ */
+void bottomUpTask(void *context, int taskIndex, int workerIndex) {
+    BfsState *state = (BfsState *) context;
+    int *offsets = state->adjacency->offsets;
+    int *neighbors = state->adjacency->neighbors;
+    int count = 0;
+    long long arcs = 0;
+
+    int first = taskIndex * BFS_CHUNK;
+    int last = first + BFS_CHUNK;
+    if (last > state->adjacency->numberVertices) {
+        last = state->adjacency->numberVertices;
+    }
+
+    for (int v = first; v < last; v++) {
+        if (state->parent[v] == -1) {
+            for (int arc = offsets[v]; arc < offsets[v+1]; arc++) {
+                if (state->inFrontier[neighbors[arc]]) {
+                    state->parent[v] = neighbors[arc];
+                    state->inNext[v] = TRUE;
+                    count++;
+                    arcs += offsets[v+1] - offsets[v];
+                    break;
+                }
+            }
+        }
+    }
+
+    InterlockedExchangeAdd(&state->nextSize, count);
+    InterlockedExchangeAdd64(&state->nextArcs, arcs);
+}
+
+/** -------------------------------------------------------------------
+ * Calculate how many BFS_CHUNK sized tasks cover a range.
+ * @param size the number of items in the range
+ * @return the number of tasks
+ */
+int numberChunks(int size) {
+    return (size + BFS_CHUNK - 1) / BFS_CHUNK;
+}
+
+/** -------------------------------------------------------------------
+ * Breadth-first search that counts the shortest paths from a source
+ * to every vertex: a vertex's count is the sum of the counts of the
+ * neighbors one step closer to the source.
+ * @param graph the graph
+ * @param workspace the workspace; its generation marks reached vertices
+ * @param source the vertex the search starts from
+ * @param reached the stamps that mark the vertices this search reached
+ * @param dist output: hops from source (valid for reached vertices)
+ * @param count output: number of shortest paths from source
+ * @param queue output: the vertices in the order they were reached
+ * @return the number of vertices reached
+ */
+int countPaths(Graph *graph, SearchWorkspace *workspace, int source,
+               unsigned int *reached, int *dist, double *count, int *queue) {
+    unsigned int generation = workspace->generation;
+    int head = 0;
+    int tail = 0;
+    reached[source] = generation;
+    dist[source] = 0;
+    count[source] = 1.0;
+    queue[tail++] = source;
+    while (head < tail) {
+        int u = queue[head++];
+        for (int k = 0; k < graph->degree[u]; k++) {
+            int v = graph->neighbors[u][k];
+            if (reached[v] != generation) {
+                reached[v] = generation;
+                dist[v] = dist[u] + 1;
+                count[v] = 0.0;
+                queue[tail++] = v;
+            }
+            if (dist[v] == dist[u] + 1) {
+                count[v] += count[u];
+            }
+        }
+    }
+    return tail;
+}
+
+/** -------------------------------------------------------------------
+ * Find the arc from one vertex to another in an adjacency list.
+ * @param adjacency the adjacency list
+ * @param from the vertex the arc leaves
+ * @param to the vertex the arc goes to
+ * @return the index of the arc in adjacency->neighbors; -1 if there
+ *         is none
+ */
+int findArc(Adjacency *adjacency, int from, int to) {
+    for (int arc = adjacency->offsets[from]; arc < adjacency->offsets[from+1]; arc++) {
+        if (adjacency->neighbors[arc] == to) {
+            return arc;
+        }
+    }
+    return -1;
+}
+
+/** -------------------------------------------------------------------
+ * Fill in a path by walking back from the ending vertex to the
+ * starting vertex. The ending vertex is listed first.
+ * @param path output: room for numberVertices vertices
+ * @param numberVertices the number of vertices in the graph
+ * @param prev prev[v] is the vertex before v on the path
+ * @param reachedEnd FALSE if no path exists
+ * @return the number of vertices on the path; 0 if no path exists
+ */
+int buildPath(int *path, int numberVertices, int *prev, int reachedEnd) {
+    if (!reachedEnd) {
+        return 0;
+    }
+    int current_vertex = numberVertices - 1;
+    int i = 0;
+    while (current_vertex != 0) {
+        path[i] = current_vertex;
+        current_vertex = prev[current_vertex];
+        i++;
+    }
+    path[i] = 0;
+    return i + 1;
+}
@@ -0,0 +1,162 @@
+/** search.h
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The definition of the graph search engine used by
+ *          the game and the AI players.
+ * ===========================================================
+ */
+
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "Graph.h"
+#include "gameLogic.h"
+#include "threadPool.h"
+#include "heap.h"
+
+// Boards with at least this many vertices use the parallel
+// breadth-first search to answer shortest path queries.
+#define PARALLEL_BFS_MIN_VERTICES  4096
+
+// Scratch memory shared by all the searches of a game, so that a search
+// neither allocates nor clears O(V) memory. A vertex's entries in dist,
+// prev and count are only meaningful while its reached stamp equals the
+// current generation; workspaceBegin() starts a new generation, which
+// forgets every vertex at once.
+typedef struct searchWorkspace {
+    int capacity;              // The number of vertices the buffers hold
+    unsigned int generation;
+    unsigned int * reached;    // Stamped when a vertex is first reached
+    unsigned int * settled;    // Stamped when a vertex is finished (or
+                               // reached by a second search)
+    int * dist;
+    int * prev;
+    double * count;
+    int * otherDist;           // A second set for searches from both ends
+    double * otherCount;
+    int * queue;
+    int * order;
+    char * mark;               // Frontier maps of the parallel search
+    char * otherMark;
+    int * path;                // Room for the vertices of one path
+    Heap * heap;
+
+    Graph * boardGraph;        // The board that board was built from
+    Adjacency * board;         // Its edges for the parallel search, kept
+                               // up to date by workspaceObserve()
+
+    int edgeCapacity;          // Room for per-edge results
+    Edge * edges;
+    double * scores;
+} SearchWorkspace;
+
+// Statistics gathered during one breadth-first search.
+typedef struct bfsStatistics {
+    int levels;           // Number of frontiers expanded
+    int topDownSteps;     // Levels expanded from the frontier outward
+    int bottomUpSteps;    // Levels expanded from the unvisited vertices inward
+    int verticesReached;  // Including the source
+} BfsStatistics;
+
+/** -------------------------------------------------------------------
+ * Direction-optimizing, level-synchronous parallel breadth-first
+ * search (Beamer, Asanovic and Patterson). Small frontiers are expanded
+ * top-down; once the frontier touches a large part of the graph the
+ * search switches to bottom-up steps in which every unvisited vertex
+ * looks for a parent in the frontier.
+ * @param adjacency the graph to search
+ * @param source the vertex the search starts from
+ * @param parent output: parent[v] is the vertex that discovered v,
+ *               parent[source] == source and -1 if v was not reached.
+ *               Must hold adjacency->numberVertices entries.
+ * @param pool the threads that run the search
+ * @param workspace scratch memory for at least numberVertices vertices
+ * @param statistics output, may be NULL
+ * @return the number of vertices reached, including the source
+ */
+int parallelBfs(Adjacency *adjacency, int source, int *parent, ThreadPool *pool,
+                SearchWorkspace *workspace, BfsStatistics *statistics);
+
+/** -------------------------------------------------------------------
+ * Find a shortest path from the starting vertex (0) to the ending
+ * vertex (numberVertices-1) using the parallel breadth-first search.
+ * Every edge that is not NO_EDGE costs 1. The edges are copied into
+ * the workspace the first time a board is searched; after that
+ * workspaceObserve() keeps them up to date.
+ * @param graph the graph
+ * @param workspace scratch memory for the search
+ * @param path output: the vertices of the path, the ending vertex
+ *             first and the starting vertex last. Must hold
+ *             graph->numberVertices entries.
+ * @return the number of vertices on the path; 0 if no path exists
+ */
+int bfsShortestPath(Graph *graph, SearchWorkspace *workspace, int *path);
+
+/** -------------------------------------------------------------------
+ * Count, for every edge, the number of shortest paths between two
+ * vertices that go through it (the s-t edge betweenness). It takes one
+ * breadth-first search from each end, so the time is O(V+E). Every
+ * edge that is not NO_EDGE costs 1.
+ * @param graph the graph
+ * @param workspace scratch memory for the search
+ * @param start one end of the paths
+ * @param end the other end of the paths
+ * @return the number of edges on at least one shortest path; 0 if end
+ *         can't be reached. The edges are left in workspace->edges,
+ *         oriented from start toward end and in order of their distance
+ *         from start, and workspace->scores[k] is the number of shortest
+ *         paths through workspace->edges[k].
+ */
+int edgeBetweenness(Graph *graph, SearchWorkspace *workspace, int start, int end);
+
+/** -------------------------------------------------------------------
+ * Create the scratch memory for searches of graphs with up to
+ * numberVertices vertices.
+ * @param numberVertices the number of vertices
+ * @return a pointer to a workspace struct
+ */
+SearchWorkspace * workspaceCreate(int numberVertices);
+
+/** -------------------------------------------------------------------
+ * Delete a search workspace.
+ * @param workspace the workspace to delete
+ */
+void workspaceDelete(SearchWorkspace *workspace);
+
+/** -------------------------------------------------------------------
+ * Start a new search: every vertex becomes unreached in O(1) time.
+ * @param workspace the workspace
+ */
+void workspaceBegin(SearchWorkspace *workspace);
+
+/** -------------------------------------------------------------------
+ * Update the workspace's copy of the board's edges after a move. Call
+ * it after the edge state has been changed on the board.
+ * @param workspace the workspace
+ * @param graph the board
+ * @param fromVertex one end of the edge
+ * @param toVertex the other end of the edge
+ * @param state the new state of the edge
+ */
+void workspaceObserve(SearchWorkspace *workspace, Graph *graph, int fromVertex, int toVertex,
+                      int state);
+
+/** -------------------------------------------------------------------
+ * Make sure there is room for per-edge results.
+ * @param workspace the workspace
+ * @param numberEdges the number of edges that must fit
+ */
+void workspaceReserveEdges(SearchWorkspace *workspace, int numberEdges);
+
+/** -------------------------------------------------------------------
+ * Get the thread pool shared by everything in the game that runs in
+ * parallel, so they all fit in one thread per processor. It is created
+ * the first time it is needed.
+ * @return the shared thread pool
+ */
+ThreadPool * searchThreadPool();
+
+#endif // SEARCH_H
@@ -0,0 +1,781 @@
+/** tablebase.c
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The implementation of an endgame tablebase: a file
+ *          of every position with a few live edges, solved ahead
+ *          of time and read straight from a memory-mapped view.
+ * ===========================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tablebase.h"
+#include "canonical.h"
+
+// The winners stored with each code
+#define SHORT_WINS_SHORT_TO_MOVE  1
+#define SHORT_WINS_CUT_TO_MOVE    2
+
+// The size a set of codes starts at; it is doubled to keep it at most
+// half full
+#define FIRST_SLOTS  1024
+
+// The codes of a set of positions, in an open-addressing hash table of
+// code << 2 | winners. A slot is 0 if it is empty.
+typedef struct codeSet {
+    int numberSlots;            // A power of 2
+    int count;
+    unsigned long long * slots;
+} CodeSet;
+
+// The codes one worker found.
+typedef struct codeList {
+    int count;
+    int capacity;
+    unsigned long long * codes;
+} CodeList;
+
+// What the workers building the positions with one more live edge share.
+typedef struct buildLayer {
+    CodeSet * solved;           // Every position with fewer live edges
+    int numberEdges;            // The live edges of the new positions
+    unsigned long long * codes; // The positions taken back from, then the
+    int numberCodes;            //   new positions
+    CodeList * found;           // The positions each worker took back to
+    unsigned char * winners;    // The winners of each new position
+} BuildLayer;
+
+// Local functions
+static int play(TablebaseBoard *board, int e, int playerToMove, TablebaseBoard *child);
+static int settle(TablebaseBoard *board);
+static void markPaths(TablebaseBoard *board, int node, unsigned int visited, unsigned int path,
+                      unsigned int *live);
+static unsigned long long encode(TablebaseBoard *board);
+static void decode(unsigned long long code, TablebaseBoard *board);
+static int pairCode(int u, int v);
+static int boardFromGraph(Graph *graph, Contraction *contraction, TablebaseBoard *board,
+                          Edge *boardEdges);
+static int solve(TablebaseBoard *board, int playerToMove, CodeSet *solved);
+static void unmoveTask(void *context, int taskIndex, int workerIndex);
+static void solveTask(void *context, int taskIndex, int workerIndex);
+static void takeBack(TablebaseBoard *board, int numberEdges, CodeList *found);
+static void listAdd(CodeList *list, unsigned long long code);
+static int findWinner(const unsigned long long *slots, int numberSlots, unsigned long long code,
+                      int playerToMove);
+static void setCreate(CodeSet *set, int numberSlots);
+static int setAdd(CodeSet *set, unsigned long long code, int winners);
+static unsigned long long mix(unsigned long long code);
+
+/** -------------------------------------------------------------------
+ * Solve every position with up to maxEdges live edges and write them
+ * to a file. The positions with the same number of live edges are
+ * found and solved in parallel.
+ * @param path the file to write
+ * @param maxEdges the most live edges, at most TABLEBASE_MAX_EDGES
+ * @param pool the threads to build it with
+ * @param statistics output, may be NULL
+ * @return TRUE if the file was written
+ */
+int tablebaseBuild(const char *path, int maxEdges, ThreadPool *pool,
+                   TablebaseStatistics *statistics) {
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    LONGLONG start = ticks();
+    TablebaseStatistics counters;
+    memset(&counters, 0, sizeof(counters));
+    if (maxEdges > TABLEBASE_MAX_EDGES) {
+        maxEdges = TABLEBASE_MAX_EDGES;
+    }
+
+    CodeSet solved;
+    setCreate(&solved, FIRST_SLOTS);
+    BuildLayer layer;
+    layer.solved = &solved;
+    layer.found = calloc((size_t) pool->numberThreads, sizeof(CodeList));
+
+    // The only position with one live edge joins the terminals
+    TablebaseBoard board = {2, 1, {0}, {1}};
+    layer.numberCodes = 1;
+    layer.codes = malloc(sizeof(unsigned long long));
+    layer.codes[0] = encode(&board);
+
+    for (int edges = 1; edges <= maxEdges; edges++) {
+        layer.numberEdges = edges;
+        if (edges > 1) {
+            // Take back a move from every position with one less edge
+            for (int w = 0; w < pool->numberThreads; w++) {
+                layer.found[w].count = 0;
+            }
+            threadPoolFor(pool, layer.numberCodes, unmoveTask, &layer);
+
+            CodeSet found;
+            setCreate(&found, FIRST_SLOTS);
+            for (int w = 0; w < pool->numberThreads; w++) {
+                counters.moves += layer.found[w].count;
+                for (int i = 0; i < layer.found[w].count; i++) {
+                    setAdd(&found, layer.found[w].codes[i], 0);
+                }
+            }
+            free(layer.codes);
+            layer.codes = malloc((found.count + 1) * sizeof(unsigned long long));
+            layer.numberCodes = 0;
+            for (int s = 0; s < found.numberSlots; s++) {
+                if (found.slots[s] != 0) {
+                    layer.codes[layer.numberCodes++] = found.slots[s] >> 2;
+                }
+            }
+            free(found.slots);
+        }
+
+        // Every move of a new position leads to a solved one
+        layer.winners = malloc((size_t) layer.numberCodes + 1);
+        threadPoolFor(pool, layer.numberCodes, solveTask, &layer);
+        for (int i = 0; i < layer.numberCodes; i++) {
+            setAdd(&solved, layer.codes[i], layer.winners[i]);
+        }
+        free(layer.winners);
+        counters.positions[edges] = layer.numberCodes;
+    }
+    for (int w = 0; w < pool->numberThreads; w++) {
+        free(layer.found[w].codes);
+    }
+    free(layer.found);
+    free(layer.codes);
+
+    // The header, then the slots just as they are in memory
+    TablebaseHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TABLEBASE_MAGIC, sizeof(header.magic));
+    header.maxEdges = maxEdges;
+    header.numberPositions = solved.count;
+    header.numberSlots = solved.numberSlots;
+    FILE *file = fopen(path, "wb");
+    int written = file != NULL &&
+                  fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  fwrite(solved.slots, sizeof(unsigned long long), (size_t) solved.numberSlots,
+                         file) == (size_t) solved.numberSlots;
+    if (file != NULL && fclose(file) != 0) {
+        written = FALSE;
+    }
+    if (!written) {
+        printf("ERROR in tablebaseBuild. Could not write %s.\n", path);
+    }
+    free(solved.slots);
+
+    if (statistics != NULL) {
+        counters.milliseconds = (ticks() - start) * 1000.0 / frequency.QuadPart;
+        counters.bytes = sizeof(header) + (size_t) solved.numberSlots * sizeof(unsigned long long);
+        *statistics = counters;
+    }
+    return written;
+}
+
+/** -------------------------------------------------------------------
+ * Open a tablebase. The file is mapped into memory, not read, so this
+ * takes the same time whatever its size.
+ * @param path the file written by tablebaseBuild()
+ * @return the tablebase, or NULL if there is no such file or it is not
+ *         a tablebase
+ */
+Tablebase * tablebaseOpen(const char *path) {
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+    // A file too short to hold the header is never mapped, so no field
+    // of the header is read past its end
+    LARGE_INTEGER size;
+    HANDLE mapping = NULL;
+    const TablebaseHeader *header = NULL;
+    if (GetFileSizeEx(file, &size) && size.QuadPart >= (LONGLONG) sizeof(TablebaseHeader)) {
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    }
+    if (mapping != NULL) {
+        header = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    }
+
+    // The file must be the header and exactly the slots it promises. The
+    // magic is compared byte for byte, since a bad file need not end it.
+    if (header == NULL || memcmp(header->magic, TABLEBASE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->numberSlots <= 0 || (header->numberSlots & (header->numberSlots - 1)) != 0 ||
+        size.QuadPart != (LONGLONG) (sizeof(TablebaseHeader) +
+                                     (size_t) header->numberSlots * sizeof(unsigned long long))) {
+        if (header != NULL) {
+            UnmapViewOfFile(header);
+        }
+        if (mapping != NULL) {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        return NULL;
+    }
+
+    Tablebase *tablebase = malloc(sizeof(Tablebase));
+    tablebase->file = file;
+    tablebase->mapping = mapping;
+    tablebase->view = header;
+    tablebase->maxEdges = header->maxEdges;
+    tablebase->numberPositions = header->numberPositions;
+    tablebase->numberSlots = header->numberSlots;
+    tablebase->slots = (const unsigned long long *) (header + 1);
+    return tablebase;
+}
+
+/** -------------------------------------------------------------------
+ * Close a tablebase
+ * @param tablebase the tablebase to close
+ */
+void tablebaseClose(Tablebase *tablebase) {
+    UnmapViewOfFile(tablebase->view);
+    CloseHandle(tablebase->mapping);
+    CloseHandle(tablebase->file);
+    free(tablebase);
+}
+
+/** -------------------------------------------------------------------
+ * Look up who wins a contracted board.
+ * @param tablebase the tablebase
+ * @param board the board; every edge must be live
+ * @param playerToMove Either CUT_PLAYER or SHORT_PLAYER
+ * @return SHORT_WINS or CUT_WINS, or GAME_UNDERWAY if the board is not
+ *         in the tablebase
+ */
+int tablebaseProbe(Tablebase *tablebase, TablebaseBoard *board, int playerToMove) {
+    if (board->numberEdges == 0 || board->numberEdges > tablebase->maxEdges) {
+        return GAME_UNDERWAY;
+    }
+    return findWinner(tablebase->slots, tablebase->numberSlots, encode(board), playerToMove);
+}
+
+/** -------------------------------------------------------------------
+ * Look up who wins a game board.
+ * @param tablebase the tablebase
+ * @param graph the board
+ * @param contraction the contracted board of the graph
+ * @param playerToMove Either CUT_PLAYER or SHORT_PLAYER
+ * @return SHORT_WINS or CUT_WINS, or GAME_UNDERWAY if the game is over
+ *         or has too many live edges left
+ */
+int tablebaseWinner(Tablebase *tablebase, Graph *graph, Contraction *contraction,
+                    int playerToMove) {
+    TablebaseBoard board;
+    Edge boardEdges[TABLEBASE_MAX_EDGES];
+    if (!boardFromGraph(graph, contraction, &board, boardEdges)) {
+        return GAME_UNDERWAY;
+    }
+    return tablebaseProbe(tablebase, &board, playerToMove);
+}
+
+/** -------------------------------------------------------------------
+ * Find a winning move on a game board.
+ * @param tablebase the tablebase
+ * @param graph the board
+ * @param contraction the contracted board of the graph
+ * @param playerToMove Either CUT_PLAYER or SHORT_PLAYER
+ * @param edge output: the edge to play
+ * @return TRUE if the player to move wins. Return FALSE if they lose,
+ *         or the board has too many live edges left.
+ */
+int tablebaseMove(Tablebase *tablebase, Graph *graph, Contraction *contraction,
+                  int playerToMove, Edge *edge) {
+    TablebaseBoard board;
+    Edge boardEdges[TABLEBASE_MAX_EDGES];
+    if (!boardFromGraph(graph, contraction, &board, boardEdges) ||
+        board.numberEdges > tablebase->maxEdges) {
+        return FALSE;
+    }
+
+    int moverWins = (playerToMove == SHORT_PLAYER) ? SHORT_WINS : CUT_WINS;
+    for (int e = 0; e < board.numberEdges; e++) {
+        TablebaseBoard child;
+        int winner = play(&board, e, playerToMove, &child);
+        if (winner == GAME_UNDERWAY) {
+            winner = tablebaseProbe(tablebase, &child, 1 - playerToMove);
+        }
+        if (winner == moverWins) {
+            *edge = boardEdges[e];
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/** -------------------------------------------------------------------
+ * Play an edge of a contracted board: Short merges its two nodes, and
+ * Cut removes it. The edges that are no longer live are removed too.
+ * @param board the board
+ * @param e the index of the edge
+ * @param playerToMove Either CUT_PLAYER or SHORT_PLAYER
+ * @param child output: the board after the move
+ * @return SHORT_WINS or CUT_WINS if the move ended the game, or
+ *         GAME_UNDERWAY if not
+ */
+int play(TablebaseBoard *board, int e, int playerToMove, TablebaseBoard *child) {
+    *child = *board;
+    int u = board->from[e];
+    int v = board->to[e];
+    child->numberEdges--;
+    child->from[e] = child->from[child->numberEdges];
+    child->to[e] = child->to[child->numberEdges];
+
+    if (playerToMove == SHORT_PLAYER) {
+        int end = board->numberNodes - 1;
+        if ((u == 0 && v == end) || (u == end && v == 0)) {
+            return SHORT_WINS;
+        }
+
+        // The terminal keeps its number; the edges parallel to the
+        // locked one become loops, and settle() drops them
+        int keep = (u == 0 || u == end) ? u : (v == 0 || v == end) ? v : u;
+        int gone = (keep == u) ? v : u;
+        for (int f = 0; f < child->numberEdges; f++) {
+            if (child->from[f] == gone) {
+                child->from[f] = keep;
+            }
+            if (child->to[f] == gone) {
+                child->to[f] = keep;
+            }
+        }
+    }
+    return settle(child);
+}
+
+/** -------------------------------------------------------------------
+ * Drop the loops and the edges that are on no simple path between the
+ * terminals, and number the nodes that are left from 0, the end last.
+ * The edges that are kept stay in the same order.
+ * @param board the board
+ * @return CUT_WINS if no edge is left, or GAME_UNDERWAY
+ */
+int settle(TablebaseBoard *board) {
+    int count = 0;
+    for (int e = 0; e < board->numberEdges; e++) {
+        if (board->from[e] != board->to[e]) {
+            board->from[count] = board->from[e];
+            board->to[count] = board->to[e];
+            count++;
+        }
+    }
+    board->numberEdges = count;
+
+    unsigned int live = 0;
+    markPaths(board, 0, 1u, 0u, &live);
+    int number[TABLEBASE_MAX_NODES];
+    int end = board->numberNodes - 1;
+    for (int v = 0; v <= end; v++) {
+        number[v] = -1;
+    }
+    count = 0;
+    for (int e = 0; e < board->numberEdges; e++) {
+        if (live & (1u << e)) {
+            board->from[count] = board->from[e];
+            board->to[count] = board->to[e];
+            number[board->from[e]] = 0;
+            number[board->to[e]] = 0;
+            count++;
+        }
+    }
+    board->numberEdges = count;
+    if (count == 0) {
+        return CUT_WINS;
+    }
+
+    int next = 1;
+    number[0] = 0;
+    for (int v = 1; v < end; v++) {
+        if (number[v] == 0) {
+            number[v] = next++;
+        }
+    }
+    number[end] = next++;
+    board->numberNodes = next;
+    for (int e = 0; e < count; e++) {
+        board->from[e] = number[board->from[e]];
+        board->to[e] = number[board->to[e]];
+    }
+    return GAME_UNDERWAY;
+}
+
+/** -------------------------------------------------------------------
+ * Mark the edges of every simple path from a node to the end. The
+ * boards are small enough to try every path.
+ * @param board the board
+ * @param node the node the path has reached
+ * @param visited the nodes on the path, one bit each
+ * @param path the edges on the path, one bit each
+ * @param live output: the edges on some path get their bit set
+ */
+void markPaths(TablebaseBoard *board, int node, unsigned int visited, unsigned int path,
+               unsigned int *live) {
+    if (node == board->numberNodes - 1) {
+        *live |= path;
+        return;
+    }
+    for (int e = 0; e < board->numberEdges; e++) {
+        int next = (board->from[e] == node) ? board->to[e]
+                 : (board->to[e] == node) ? board->from[e] : -1;
+        if (next != -1 && !(visited & (1u << next))) {
+            markPaths(board, next, visited | (1u << next), path | (1u << e), live);
+        }
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Find the code of a board: its sorted list of edges once its nodes
+ * are given their canonical numbers (see canonical.h), so every copy
+ * of the board has the same code.
+ * @param board the board; it must have been settled
+ * @return the code, 6 bits per edge
+ */
+unsigned long long encode(TablebaseBoard *board) {
+    CanonicalGraph graph;
+    int label[CANONICAL_MAX_NODES];
+    graph.numberNodes = board->numberNodes;
+    graph.numberEdges = board->numberEdges;
+    memcpy(graph.from, board->from, board->numberEdges * sizeof(int));
+    memcpy(graph.to, board->to, board->numberEdges * sizeof(int));
+    canonicalLabel(&graph, label);
+
+    int digits[TABLEBASE_MAX_EDGES];
+    for (int e = 0; e < board->numberEdges; e++) {
+        int digit = pairCode(label[board->from[e]], label[board->to[e]]);
+        int j = e;
+        while (j > 0 && digits[j-1] < digit) {
+            digits[j] = digits[j-1];
+            j--;
+        }
+        digits[j] = digit;
+    }
+    unsigned long long code = 0;
+    for (int e = 0; e < board->numberEdges; e++) {
+        code = code << 6 | (unsigned long long) digits[e];
+    }
+    return code;
+}
+
+/** -------------------------------------------------------------------
+ * Rebuild a board from its code.
+ * @param code the code
+ * @param board output: the board, numbered the way the code was made
+ */
+void decode(unsigned long long code, TablebaseBoard *board) {
+    board->numberEdges = 0;
+    board->numberNodes = 0;
+    for (; code != 0; code >>= 6) {
+        int digit = (int) (code & 63) - 1;
+        int v = 1;
+        while (digit >= v) {
+            digit -= v;
+            v++;
+        }
+        board->from[board->numberEdges] = digit;
+        board->to[board->numberEdges] = v;
+        board->numberEdges++;
+        if (v + 1 > board->numberNodes) {
+            board->numberNodes = v + 1;
+        }
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Number the pairs of nodes from 1: (0,1), (0,2), (1,2), (0,3), ...
+ * @param u one node
+ * @param v the other node
+ * @return the number of the pair
+ */
+int pairCode(int u, int v) {
+    if (u > v) {
+        int swap = u;
+        u = v;
+        v = swap;
+    }
+    return v * (v - 1) / 2 + u + 1;
+}
+
+/** -------------------------------------------------------------------
+ * Make the contracted board of a game board.
+ * @param graph the board
+ * @param contraction the contracted board of the graph
+ * @param board output: the live edges between the groups
+ * @param boardEdges output: the edge of the game board of each edge
+ * @return TRUE if the game is not over and there are at most
+ *         TABLEBASE_MAX_EDGES live edges
+ */
+int boardFromGraph(Graph *graph, Contraction *contraction, TablebaseBoard *board,
+                   Edge *boardEdges) {
+    int liveEdges = contractionLive(contraction, graph);
+    if (liveEdges == 0 || liveEdges > TABLEBASE_MAX_EDGES) {
+        return FALSE;
+    }
+    Edge *edges = malloc(graphNumberEdges(graph) * sizeof(Edge));
+    int numberEdges;
+    int numberNodes = contractionNumber(contraction, graph, edges, &numberEdges);
+
+    // The groups are numbered again, just the ones with live edges
+    int *number = malloc(numberNodes * sizeof(int));
+    for (int v = 0; v < numberNodes; v++) {
+        number[v] = -1;
+    }
+    number[0] = 0;
+    int next = 1;
+    board->numberEdges = 0;
+    for (int i = 0; i < numberEdges; i++) {
+        int u = edges[i].fromVertex;
+        int v = edges[i].toVertex;
+        if (board->numberEdges == TABLEBASE_MAX_EDGES || !contractionIsLive(contraction, graph, u, v)) {
+            continue;
+        }
+        int ends[2] = {contraction->node[u], contraction->node[v]};
+        for (int j = 0; j < 2; j++) {
+            if (number[ends[j]] == -1 && ends[j] != numberNodes - 1) {
+                number[ends[j]] = next++;
+            }
+        }
+        board->from[board->numberEdges] = ends[0];
+        board->to[board->numberEdges] = ends[1];
+        boardEdges[board->numberEdges] = edges[i];
+        board->numberEdges++;
+    }
+    number[numberNodes - 1] = next++;
+    board->numberNodes = next;
+    for (int e = 0; e < board->numberEdges; e++) {
+        board->from[e] = number[board->from[e]];
+        board->to[e] = number[board->to[e]];
+    }
+    free(number);
+    free(edges);
+    return TRUE;
+}
+
+/** -------------------------------------------------------------------
+ * Work out who wins a board from the positions already solved. A move
+ * to a position that is not solved (if taking back moves missed it) is
+ * solved on the spot.
+ * @param board the board
+ * @param playerToMove Either CUT_PLAYER or SHORT_PLAYER
+ * @param solved the positions with fewer live edges
+ * @return SHORT_WINS or CUT_WINS
+ */
+int solve(TablebaseBoard *board, int playerToMove, CodeSet *solved) {
+    int moverWins = (playerToMove == SHORT_PLAYER) ? SHORT_WINS : CUT_WINS;
+    for (int e = 0; e < board->numberEdges; e++) {
+        TablebaseBoard child;
+        int winner = play(board, e, playerToMove, &child);
+        if (winner == GAME_UNDERWAY) {
+            winner = findWinner(solved->slots, solved->numberSlots, encode(&child),
+                                1 - playerToMove);
+        }
+        if (winner == GAME_UNDERWAY) {
+            winner = solve(&child, 1 - playerToMove, solved);
+        }
+        if (winner == moverWins) {
+            return moverWins;
+        }
+    }
+    return SHORT_WINS + CUT_WINS - moverWins;
+}
+
+/** -------------------------------------------------------------------
+ * Take back every move that leads to one of the positions with one less
+ * live edge.
+ * @param context the BuildLayer
+ * @param taskIndex which position
+ * @param workerIndex the list the positions found go in
+ */
+void unmoveTask(void *context, int taskIndex, int workerIndex) {
+    BuildLayer *layer = (BuildLayer *) context;
+    TablebaseBoard board;
+    decode(layer->codes[taskIndex], &board);
+    takeBack(&board, layer->numberEdges, &layer->found[workerIndex]);
+}
+
+/** -------------------------------------------------------------------
+ * Solve one of the new positions for both players.
+ * @param context the BuildLayer
+ * @param taskIndex which position
+ * @param workerIndex not used
+ */
+void solveTask(void *context, int taskIndex, int workerIndex) {
+    BuildLayer *layer = (BuildLayer *) context;
+    TablebaseBoard board;
+    decode(layer->codes[taskIndex], &board);
+    int winners = 0;
+    if (solve(&board, SHORT_PLAYER, layer->solved) == SHORT_WINS) {
+        winners |= SHORT_WINS_SHORT_TO_MOVE;
+    }
+    if (solve(&board, CUT_PLAYER, layer->solved) == SHORT_WINS) {
+        winners |= SHORT_WINS_CUT_TO_MOVE;
+    }
+    layer->winners[taskIndex] = (unsigned char) winners;
+}
+
+/** -------------------------------------------------------------------
+ * List the positions a board can be reached from by one move that
+ * leaves every edge live. Cut's move is taken back by putting an edge
+ * back between two nodes. Short's move is taken back by splitting a
+ * node in two, joined by the locked edge, in every way of sharing out
+ * its edges.
+ * @param board the board
+ * @param numberEdges the live edges of the positions wanted
+ * @param found output: their codes
+ */
+void takeBack(TablebaseBoard *board, int numberEdges, CodeList *found) {
+    int m = board->numberNodes;
+    TablebaseBoard parent;
+
+    for (int u = 0; u < m; u++) {
+        for (int v = u + 1; v < m; v++) {
+            parent = *board;
+            parent.from[parent.numberEdges] = u;
+            parent.to[parent.numberEdges] = v;
+            parent.numberEdges++;
+            if (settle(&parent) == GAME_UNDERWAY && parent.numberEdges == numberEdges) {
+                listAdd(found, encode(&parent));
+            }
+        }
+    }
+
+    // The new node is numbered m-1 and the end moves up to m
+    for (int x = 0; x < m; x++) {
+        int ends[2 * TABLEBASE_MAX_EDGES];
+        int degree = 0;
+        for (int e = 0; e < board->numberEdges; e++) {
+            if (board->from[e] == x) {
+                ends[degree++] = 2 * e;
+            }
+            if (board->to[e] == x) {
+                ends[degree++] = 2 * e + 1;
+            }
+        }
+        int split = m - 1;
+        int node = (x == m - 1) ? m : x;
+        for (int subset = 0; subset < (1 << degree); subset++) {
+            parent = *board;
+            parent.numberNodes = m + 1;
+            for (int e = 0; e < parent.numberEdges; e++) {
+                parent.from[e] = (parent.from[e] == m - 1) ? m : parent.from[e];
+                parent.to[e] = (parent.to[e] == m - 1) ? m : parent.to[e];
+            }
+            for (int j = 0; j < degree; j++) {
+                if (subset & (1 << j)) {
+                    int e = ends[j] / 2;
+                    if (ends[j] % 2 == 0) {
+                        parent.from[e] = split;
+                    } else {
+                        parent.to[e] = split;
+                    }
+                }
+            }
+            parent.from[parent.numberEdges] = node;
+            parent.to[parent.numberEdges] = split;
+            parent.numberEdges++;
+            if (settle(&parent) == GAME_UNDERWAY && parent.numberEdges == numberEdges) {
+                listAdd(found, encode(&parent));
+            }
+        }
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Add a code to a list, making it bigger if needed.
+ * @param list the list
+ * @param code the code
+ */
+void listAdd(CodeList *list, unsigned long long code) {
+    if (list->count == list->capacity) {
+        list->capacity = (list->capacity == 0) ? FIRST_SLOTS : 2 * list->capacity;
+        list->codes = realloc(list->codes, list->capacity * sizeof(unsigned long long));
+        if (list->codes == NULL) {
+            printf("ERROR in listAdd. No memory for %d codes.\n", list->capacity);
+            exit(1);
+        }
+    }
+    list->codes[list->count++] = code;
+}
+
+/** -------------------------------------------------------------------
+ * Look up the winner of a position in a hash table of codes.
+ * @param slots the table
+ * @param numberSlots its size, a power of 2
+ * @param code the code of the position
+ * @param playerToMove Either CUT_PLAYER or SHORT_PLAYER
+ * @return SHORT_WINS or CUT_WINS, or GAME_UNDERWAY if it is not there
+ */
+int findWinner(const unsigned long long *slots, int numberSlots, unsigned long long code,
+               int playerToMove) {
+    int bit = (playerToMove == SHORT_PLAYER) ? SHORT_WINS_SHORT_TO_MOVE : SHORT_WINS_CUT_TO_MOVE;
+    for (int s = (int) (mix(code) & (numberSlots - 1)); slots[s] != 0; s = (s + 1) & (numberSlots - 1)) {
+        if (slots[s] >> 2 == code) {
+            return (slots[s] & bit) ? SHORT_WINS : CUT_WINS;
+        }
+    }
+    return GAME_UNDERWAY;
+}
+
+/** -------------------------------------------------------------------
+ * Create an empty set of codes.
+ * @param set the set
+ * @param numberSlots its size, a power of 2
+ */
+void setCreate(CodeSet *set, int numberSlots) {
+    set->numberSlots = numberSlots;
+    set->count = 0;
+    set->slots = calloc((size_t) numberSlots, sizeof(unsigned long long));
+    if (set->slots == NULL) {
+        printf("ERROR in setCreate. No memory for %d slots.\n", numberSlots);
+        exit(1);
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Add a code to a set, unless it is there already. The set is doubled
+ * once it is half full.
+ * @param set the set
+ * @param code the code
+ * @param winners the winners to store with it
+ * @return TRUE if it was added
+ */
+int setAdd(CodeSet *set, unsigned long long code, int winners) {
+    if (2 * (set->count + 1) > set->numberSlots) {
+        CodeSet bigger;
+        setCreate(&bigger, 2 * set->numberSlots);
+        for (int s = 0; s < set->numberSlots; s++) {
+            if (set->slots[s] != 0) {
+                setAdd(&bigger, set->slots[s] >> 2, (int) (set->slots[s] & 3));
+            }
+        }
+        free(set->slots);
+        *set = bigger;
+    }
+    int mask = set->numberSlots - 1;
+    int s = (int) (mix(code) & mask);
+    while (set->slots[s] != 0) {
+        if (set->slots[s] >> 2 == code) {
+            return FALSE;
+        }
+        s = (s + 1) & mask;
+    }
+    set->slots[s] = code << 2 | (unsigned long long) winners;
+    set->count++;
+    return TRUE;
+}
+
+/** -------------------------------------------------------------------
+ * Scramble a code, so codes that differ in a few bits land far apart
+ * in the hash table.
+ * @param code the code
+ * @return the scrambled code
+ */
+unsigned long long mix(unsigned long long code) {
+    code ^= code >> 33;
+    code *= 0xff51afd7ed558ccdULL;
+    code ^= code >> 33;
+    code *= 0xc4ceb9fe1a85ec53ULL;
+    code ^= code >> 33;
+    return code;
+}
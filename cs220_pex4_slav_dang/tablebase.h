@@ -0,0 +1,154 @@
+/** tablebase.h
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The definition of an endgame tablebase: a file of
+ *          every position with a few live edges, solved ahead
+ *          of time and read straight from a memory-mapped view.
+ * ===========================================================
+ */
+
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+#include <windows.h>
+#include "Graph.h"
+#include "gameLogic.h"
+#include "threadPool.h"
+#include "contraction.h"
+
+// The most live edges of a position in the tablebase. A code takes 6
+// bits per edge and must leave 2 bits for the winners, so it can be at
+// most 9.
+#define TABLEBASE_MAX_EDGES  9
+#define TABLEBASE_MAX_NODES  (TABLEBASE_MAX_EDGES + 1)
+
+// The file the game reads the tablebase from, and PEX4_tablebase writes
+#define TABLEBASE_FILE   "tablebase.bin"
+#define TABLEBASE_MAGIC  "PEX4TB2"
+
+// Near the end of a game the contracted board (see contraction.h) has
+// only a handful of live edges left, and the dead edges do not matter,
+// so every game ends in one of a small number of positions. The
+// tablebase holds them all, each with the winner for either player to
+// move.
+//
+// A position is stored by its code: the sorted list of its edges once
+// the nodes are given their canonical numbers (see canonical.h). Two
+// boards that only differ in how their nodes are numbered get the same
+// code, so the tablebase holds every position once.
+//
+// The positions are solved one number of live edges at a time, fewest
+// first. Every move takes away at least one live edge, so each position
+// only needs the positions solved before it. The positions with one
+// more live edge are found by taking back a move (retrograde analysis):
+// putting back an edge Cut removed, or splitting a node in two with an
+// edge Short locked.
+
+// A contracted board: the live edges between the nodes. Node 0 holds
+// the start and node numberNodes-1 the end; there may be more than one
+// edge between two nodes.
+typedef struct tablebaseBoard {
+    int numberNodes;
+    int numberEdges;
+    int from[TABLEBASE_MAX_EDGES];
+    int to[TABLEBASE_MAX_EDGES];
+} TablebaseBoard;
+
+// The start of the file. The slots come right after it.
+typedef struct tablebaseHeader {
+    char magic[8];              // TABLEBASE_MAGIC
+    int maxEdges;               // The most live edges of a position in it
+    int numberPositions;
+    int numberSlots;            // A power of 2
+    int reserved;
+} TablebaseHeader;
+
+// A tablebase open for reading. The slots are an open-addressing hash
+// table of code << 2 | winners, 0 if empty, and point into the view of
+// the file, so nothing is read until it is probed.
+typedef struct tablebase {
+    HANDLE file;
+    HANDLE mapping;
+    const void * view;
+    int maxEdges;
+    int numberPositions;
+    int numberSlots;
+    const unsigned long long * slots;
+} Tablebase;
+
+// What building a tablebase took.
+typedef struct tablebaseStatistics {
+    int positions[TABLEBASE_MAX_EDGES + 1]; // The positions with each number
+                                            //   of live edges
+    long long moves;            // The moves taken back
+    double milliseconds;
+    size_t bytes;               // The size of the file
+} TablebaseStatistics;
+
+/** -------------------------------------------------------------------
+ * Solve every position with up to maxEdges live edges and write them
+ * to a file. The positions with the same number of live edges are
+ * found and solved in parallel.
+ * @param path the file to write
+ * @param maxEdges the most live edges, at most TABLEBASE_MAX_EDGES
+ * @param pool the threads to build it with
+ * @param statistics output, may be NULL
+ * @return TRUE if the file was written
+ */
+int tablebaseBuild(const char *path, int maxEdges, ThreadPool *pool,
+                   TablebaseStatistics *statistics);
+
+/** -------------------------------------------------------------------
+ * Open a tablebase. The file is mapped into memory, not read, so this
+ * takes the same time whatever its size.
+ * @param path the file written by tablebaseBuild()
+ * @return the tablebase, or NULL if there is no such file or it is not
+ *         a tablebase
+ */
+Tablebase * tablebaseOpen(const char *path);
+
+/** -------------------------------------------------------------------
+ * Close a tablebase
+ * @param tablebase the tablebase to close
+ */
+void tablebaseClose(Tablebase *tablebase);
+
+/** -------------------------------------------------------------------
+ * Look up who wins a contracted board.
+ * @param tablebase the tablebase
+ * @param board the board; every edge must be live
+ * @param playerToMove Either CUT_PLAYER or SHORT_PLAYER
+ * @return SHORT_WINS or CUT_WINS, or GAME_UNDERWAY if the board is not
+ *         in the tablebase
+ */
+int tablebaseProbe(Tablebase *tablebase, TablebaseBoard *board, int playerToMove);
+
+/** -------------------------------------------------------------------
+ * Look up who wins a game board.
+ * @param tablebase the tablebase
+ * @param graph the board
+ * @param contraction the contracted board of the graph
+ * @param playerToMove Either CUT_PLAYER or SHORT_PLAYER
+ * @return SHORT_WINS or CUT_WINS, or GAME_UNDERWAY if the game is over
+ *         or has too many live edges left
+ */
+int tablebaseWinner(Tablebase *tablebase, Graph *graph, Contraction *contraction,
+                    int playerToMove);
+
+/** -------------------------------------------------------------------
+ * Find a winning move on a game board.
+ * @param tablebase the tablebase
+ * @param graph the board
+ * @param contraction the contracted board of the graph
+ * @param playerToMove Either CUT_PLAYER or SHORT_PLAYER
+ * @param edge output: the edge to play
+ * @return TRUE if the player to move wins. Return FALSE if they lose,
+ *         or the board has too many live edges left.
+ */
+int tablebaseMove(Tablebase *tablebase, Graph *graph, Contraction *contraction,
+                  int playerToMove, Edge *edge);
+
+#endif // TABLEBASE_H
@@ -0,0 +1,368 @@
+/** threadPool.c
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The implementation of a fixed pool of worker threads
+ *          that share out tasks by work stealing, with fork/join
+ *          and a parallel for loop.
+ * ===========================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "threadPool.h"
+
+// The first number of tasks a deque holds; it doubles when full
+#define DEQUE_CAPACITY  64
+
+// Who a thread of the pool is. The thread local slot of every
+// background thread points at its own.
+typedef struct poolWorker {
+    ThreadPool * pool;
+    int workerIndex;
+} PoolWorker;
+
+// The thread local slot, shared by all pools
+static DWORD workerSlot = TLS_OUT_OF_INDEXES;
+
+// Local functions
+static DWORD WINAPI workerMain(LPVOID parameter);
+static void pushTask(ThreadPool *pool, int workerIndex, PoolTask *task);
+static int takeTask(ThreadPool *pool, int workerIndex, PoolTask *task);
+static void runTask(ThreadPool *pool, int workerIndex, PoolTask *task);
+static void finishTask(ThreadPool *pool, TaskGroup *group);
+static LONG readCount(volatile LONG *count);
+
+/** -------------------------------------------------------------------
+ * Create a pool of worker threads.
+ * @param numberThreads the total number of workers, including the thread
+ *                      that calls threadPoolFor. 1 means run serially.
+ * @return a pointer to a thread pool struct
+ */
+ThreadPool * threadPoolCreate(int numberThreads) {
+    if (numberThreads < 1) {
+        numberThreads = 1;
+    }
+    if (workerSlot == TLS_OUT_OF_INDEXES) {
+        workerSlot = TlsAlloc();
+        if (workerSlot == TLS_OUT_OF_INDEXES) {
+            printf("ERROR in threadPoolCreate. No thread local slot is free.\n");
+            exit(1);
+        }
+    }
+
+    ThreadPool *pool = malloc(sizeof(ThreadPool));
+    pool->numberThreads = numberThreads;
+    pool->queued = 0;
+    pool->sleeping = 0;
+    pool->shutdown = FALSE;
+    InitializeCriticalSection(&pool->lock);
+    InitializeConditionVariable(&pool->workReady);
+
+    pool->deques = malloc(numberThreads * sizeof(WorkerDeque));
+    pool->workers = malloc(numberThreads * sizeof(PoolWorker));
+    for (int j = 0; j < numberThreads; j++) {
+        WorkerDeque *deque = &pool->deques[j];
+        InitializeCriticalSection(&deque->lock);
+        deque->tasks = malloc(DEQUE_CAPACITY * sizeof(PoolTask));
+        deque->capacity = DEQUE_CAPACITY;
+        deque->top = 0;
+        deque->bottom = 0;
+        pool->workers[j].pool = pool;
+        pool->workers[j].workerIndex = j;
+    }
+
+    pool->threads = malloc(numberThreads * sizeof(HANDLE));
+    for (int j = 1; j < numberThreads; j++) {
+        pool->threads[j] = CreateThread(NULL, 0, workerMain, &pool->workers[j], 0, NULL);
+        if (pool->threads[j] == NULL) {
+            printf("ERROR in threadPoolCreate. Could not start worker %d.\n", j);
+            exit(1);
+        }
+    }
+
+    return pool;
+}
+
+/** -------------------------------------------------------------------
+ * Stop the worker threads and delete the pool.
+ * @param pool the pool to delete
+ */
+void threadPoolDelete(ThreadPool *pool) {
+    EnterCriticalSection(&pool->lock);
+    pool->shutdown = TRUE;
+    WakeAllConditionVariable(&pool->workReady);
+    LeaveCriticalSection(&pool->lock);
+
+    for (int j = 1; j < pool->numberThreads; j++) {
+        WaitForSingleObject(pool->threads[j], INFINITE);
+        CloseHandle(pool->threads[j]);
+    }
+
+    for (int j = 0; j < pool->numberThreads; j++) {
+        DeleteCriticalSection(&pool->deques[j].lock);
+        free(pool->deques[j].tasks);
+    }
+    DeleteCriticalSection(&pool->lock);
+    free(pool->deques);
+    free(pool->workers);
+    free(pool->threads);
+    free(pool);
+}
+
+/** -------------------------------------------------------------------
+ * Run tasks 0..numberTasks-1 on the pool and wait until all of them
+ * are finished. The range is split in halves that idle workers
+ * steal, so uneven tasks are balanced across the workers. A task may
+ * itself call threadPoolFor on the same pool.
+ * @param pool the thread pool
+ * @param numberTasks the number of tasks to run
+ * @param function the function that runs a single task
+ * @param context data shared by all the tasks
+ */
+void threadPoolFor(ThreadPool *pool, int numberTasks, TaskFunction function, void *context) {
+    int workerIndex = threadPoolWorker(pool);
+    if (pool->numberThreads == 1 || numberTasks <= 1) {
+        // Not worth waking anybody up.
+        for (int task = 0; task < numberTasks; task++) {
+            function(context, task, workerIndex);
+        }
+        return;
+    }
+
+    TaskGroup group = {0};
+    PoolTask range = {function, context, 0, numberTasks, &group};
+    InterlockedIncrement(&group.pending);
+    runTask(pool, workerIndex, &range);
+    threadPoolJoin(pool, &group);
+}
+
+/** -------------------------------------------------------------------
+ * Push one task onto the deque of the worker calling, for any worker
+ * to run. It belongs to the group until it is finished.
+ * @param pool the thread pool
+ * @param group the group the task belongs to
+ * @param function the function that runs the task
+ * @param context data for the task
+ * @param taskIndex the index passed to the function
+ */
+void threadPoolFork(ThreadPool *pool, TaskGroup *group, TaskFunction function,
+                    void *context, int taskIndex) {
+    PoolTask task = {function, context, taskIndex, taskIndex + 1, group};
+    InterlockedIncrement(&group->pending);
+    pushTask(pool, threadPoolWorker(pool), &task);
+}
+
+/** -------------------------------------------------------------------
+ * Run tasks until every task forked in a group is finished.
+ * @param pool the thread pool
+ * @param group the group to wait for
+ */
+void threadPoolJoin(ThreadPool *pool, TaskGroup *group) {
+    int workerIndex = threadPoolWorker(pool);
+    PoolTask task;
+    while (readCount(&group->pending) > 0) {
+        if (takeTask(pool, workerIndex, &task)) {
+            runTask(pool, workerIndex, &task);
+            continue;
+        }
+
+        // The rest of the group is running on other workers. Sleep until
+        // it is done or there is something to steal.
+        EnterCriticalSection(&pool->lock);
+        InterlockedIncrement(&pool->sleeping);
+        while (readCount(&group->pending) > 0 && readCount(&pool->queued) == 0) {
+            SleepConditionVariableCS(&pool->workReady, &pool->lock, INFINITE);
+        }
+        InterlockedDecrement(&pool->sleeping);
+        LeaveCriticalSection(&pool->lock);
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Get the index of the worker the calling thread is.
+ * @param pool the thread pool
+ * @return the index of the worker, 0 for a thread outside the pool
+ */
+int threadPoolWorker(ThreadPool *pool) {
+    PoolWorker *worker = TlsGetValue(workerSlot);
+    return (worker != NULL && worker->pool == pool) ? worker->workerIndex : 0;
+}
+
+/** -------------------------------------------------------------------
+ * Get the number of logical processors on this machine.
+ * @return the number of processors (at least 1)
+ */
+int numberProcessors() {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int) info.dwNumberOfProcessors : 1;
+}
+
+/** -------------------------------------------------------------------
+ * Read the high resolution clock, which never goes backward.
+ * @return the time in QueryPerformanceCounter() ticks
+ */
+LONGLONG ticks() {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return now.QuadPart;
+}
+
+/** -------------------------------------------------------------------
+ * Push a task onto the bottom of a worker's deque, and wake a sleeping
+ * thread to steal it.
+ * @param pool the thread pool
+ * @param workerIndex the worker that owns the deque
+ * @param task the task to push (copied)
+ */
+void pushTask(ThreadPool *pool, int workerIndex, PoolTask *task) {
+    WorkerDeque *deque = &pool->deques[workerIndex];
+    EnterCriticalSection(&deque->lock);
+    if (deque->bottom == deque->capacity) {
+        if (deque->top > 0) {
+            // Slide the tasks down over the ones that were stolen
+            memmove(deque->tasks, deque->tasks + deque->top,
+                    (deque->bottom - deque->top) * sizeof(PoolTask));
+            deque->bottom -= deque->top;
+            deque->top = 0;
+        } else {
+            deque->capacity *= 2;
+            deque->tasks = realloc(deque->tasks, deque->capacity * sizeof(PoolTask));
+            if (deque->tasks == NULL) {
+                printf("ERROR in pushTask. Not enough memory for %d tasks.\n", deque->capacity);
+                exit(1);
+            }
+        }
+    }
+    deque->tasks[deque->bottom++] = *task;
+    LeaveCriticalSection(&deque->lock);
+
+    // A thread that saw nothing queued before this is either counted as
+    // sleeping by now or will see the task when it looks again.
+    InterlockedIncrement(&pool->queued);
+    if (readCount(&pool->sleeping) > 0) {
+        EnterCriticalSection(&pool->lock);
+        WakeAllConditionVariable(&pool->workReady);
+        LeaveCriticalSection(&pool->lock);
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Take a task for a worker: the newest one on its own deque, or else
+ * the oldest one on another worker's.
+ * @param pool the thread pool
+ * @param workerIndex the worker looking for a task
+ * @param task output: the task
+ * @return TRUE if a task was taken, FALSE if every deque was empty
+ */
+int takeTask(ThreadPool *pool, int workerIndex, PoolTask *task) {
+    if (readCount(&pool->queued) == 0) {
+        return FALSE;
+    }
+    for (int k = 0; k < pool->numberThreads; k++) {
+        WorkerDeque *deque = &pool->deques[(workerIndex + k) % pool->numberThreads];
+        int found = FALSE;
+        EnterCriticalSection(&deque->lock);
+        if (deque->bottom > deque->top) {
+            if (k == 0) {
+                *task = deque->tasks[--deque->bottom];
+            } else {
+                *task = deque->tasks[deque->top++];
+            }
+            if (deque->top == deque->bottom) {
+                deque->top = 0;
+                deque->bottom = 0;
+            }
+            found = TRUE;
+        }
+        LeaveCriticalSection(&deque->lock);
+        if (found) {
+            InterlockedDecrement(&pool->queued);
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/** -------------------------------------------------------------------
+ * Run a task. A range of more than one index is halved, and the upper
+ * half pushed for others to steal, until one index is left.
+ * @param pool the thread pool
+ * @param workerIndex the worker running the task
+ * @param task the task
+ */
+void runTask(ThreadPool *pool, int workerIndex, PoolTask *task) {
+    PoolTask range = *task;
+    while (range.last - range.first > 1) {
+        PoolTask upper = range;
+        upper.first = range.first + (range.last - range.first) / 2;
+        range.last = upper.first;
+        InterlockedIncrement(&range.group->pending);
+        pushTask(pool, workerIndex, &upper);
+    }
+    range.function(range.context, range.first, workerIndex);
+    finishTask(pool, range.group);
+}
+
+/** -------------------------------------------------------------------
+ * Count a task of a group as finished, and wake the threads waiting
+ * for the group when it was the last one.
+ * @param pool the thread pool
+ * @param group the group of the task
+ */
+void finishTask(ThreadPool *pool, TaskGroup *group) {
+    if (InterlockedDecrement(&group->pending) == 0) {
+        EnterCriticalSection(&pool->lock);
+        WakeAllConditionVariable(&pool->workReady);
+        LeaveCriticalSection(&pool->lock);
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Read a count that other threads change, after everything they did
+ * before changing it.
+ * @param count the count
+ * @return its value
+ */
+LONG readCount(volatile LONG *count) {
+    return InterlockedCompareExchange(count, 0, 0);
+}
+
+/** -------------------------------------------------------------------
+ * The body of a background worker thread. It runs and steals tasks
+ * while there are any, and sleeps until more are pushed.
+ * @param parameter the PoolWorker of the thread
+ * @return 0
+ */
+DWORD WINAPI workerMain(LPVOID parameter) {
+    PoolWorker *worker = (PoolWorker *) parameter;
+    ThreadPool *pool = worker->pool;
+    int workerIndex = worker->workerIndex;
+    TlsSetValue(workerSlot, worker);
+
+    PoolTask task;
+    while (TRUE) {
+        if (takeTask(pool, workerIndex, &task)) {
+            runTask(pool, workerIndex, &task);
+            continue;
+        }
+
+        EnterCriticalSection(&pool->lock);
+        InterlockedIncrement(&pool->sleeping);
+        while (readCount(&pool->queued) == 0 && !pool->shutdown) {
+            SleepConditionVariableCS(&pool->workReady, &pool->lock, INFINITE);
+        }
+        InterlockedDecrement(&pool->sleeping);
+        int shutdown = pool->shutdown;
+        LeaveCriticalSection(&pool->lock);
+        if (shutdown) {
+            break;
+        }
+    }
+
+    return 0;
+}
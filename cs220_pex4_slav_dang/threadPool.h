@@ -0,0 +1,139 @@
+/** threadPool.h
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The definition of a fixed pool of worker threads that
+ *          share out tasks by work stealing, with fork/join and
+ *          a parallel for loop.
+ * ===========================================================
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <windows.h>
+
+// A task receives the shared context, the index of the task and the
+// index of the worker running it [0, numberThreads-1]. Worker 0 is
+// always the thread outside the pool that handed out the work.
+typedef void (*TaskFunction)(void *context, int taskIndex, int workerIndex);
+
+// Every worker has a deque of tasks. The worker pushes the tasks it
+// forks onto the bottom of its own deque and takes them back from the
+// bottom, newest first, while they are still warm in its cache. A
+// worker with nothing left steals from the top of another worker's
+// deque, taking the oldest task there, which is usually the biggest.
+//
+// A parallel for loop is one task that holds a range of indexes. The
+// worker running it splits off the upper half onto its deque until
+// one index is left, runs it, and then takes back the halves it has
+// not lost to thieves. An idle worker so steals half of what is left
+// of a busy one's range at a time, and uneven tasks even out.
+//
+// A thread that joins runs tasks from the deques while its group is
+// not done, and only sleeps when there are none. Because of that a
+// task that forks and joins may run other tasks on the same worker
+// before the join returns: memory a task keeps per worker must not be
+// in use across a join. Only one thread outside the pool may hand out
+// work at a time, as it is always worker 0.
+typedef struct poolTask {
+    TaskFunction function;
+    void * context;
+    int first;                    // The task indexes [first, last)
+    int last;
+    struct taskGroup * group;
+} PoolTask;
+
+typedef struct workerDeque {
+    CRITICAL_SECTION lock;
+    PoolTask * tasks;
+    int capacity;
+    int top;                      // Thieves take the task here
+    int bottom;                   // The owner pushes and pops here
+} WorkerDeque;
+
+// The tasks forked together and waited for together. Start it at
+// zero: TaskGroup group = {0};
+typedef struct taskGroup {
+    volatile LONG pending;        // Tasks forked and not yet finished
+} TaskGroup;
+
+typedef struct threadPool {
+    int numberThreads;            // Workers, including the calling thread
+    HANDLE * threads;             // numberThreads-1 background threads
+    struct poolWorker * workers;  // Who each thread is, for nested forks
+    WorkerDeque * deques;         // One for each worker
+    volatile LONG queued;         // Tasks waiting on all the deques
+    volatile LONG sleeping;       // Threads waiting on workReady
+    CRITICAL_SECTION lock;
+    CONDITION_VARIABLE workReady; // A task was pushed or a group was done
+    int shutdown;
+} ThreadPool;
+
+/** -------------------------------------------------------------------
+ * Create a pool of worker threads.
+ * @param numberThreads the total number of workers, including the thread
+ *                      that calls threadPoolFor. 1 means run serially.
+ * @return a pointer to a thread pool struct
+ */
+ThreadPool * threadPoolCreate(int numberThreads);
+
+/** -------------------------------------------------------------------
+ * Stop the worker threads and delete the pool.
+ * @param pool the pool to delete
+ */
+void threadPoolDelete(ThreadPool *pool);
+
+/** -------------------------------------------------------------------
+ * Run tasks 0..numberTasks-1 on the pool and wait until all of them
+ * are finished. The range is split in halves that idle workers
+ * steal, so uneven tasks are balanced across the workers. A task may
+ * itself call threadPoolFor on the same pool.
+ * @param pool the thread pool
+ * @param numberTasks the number of tasks to run
+ * @param function the function that runs a single task
+ * @param context data shared by all the tasks
+ */
+void threadPoolFor(ThreadPool *pool, int numberTasks, TaskFunction function, void *context);
+
+/** -------------------------------------------------------------------
+ * Push one task onto the deque of the worker calling, for any worker
+ * to run. It belongs to the group until it is finished.
+ * @param pool the thread pool
+ * @param group the group the task belongs to
+ * @param function the function that runs the task
+ * @param context data for the task
+ * @param taskIndex the index passed to the function
+ */
+void threadPoolFork(ThreadPool *pool, TaskGroup *group, TaskFunction function,
+                    void *context, int taskIndex);
+
+/** -------------------------------------------------------------------
+ * Run tasks until every task forked in a group is finished.
+ * @param pool the thread pool
+ * @param group the group to wait for
+ */
+void threadPoolJoin(ThreadPool *pool, TaskGroup *group);
+
+/** -------------------------------------------------------------------
+ * Get the index of the worker the calling thread is.
+ * @param pool the thread pool
+ * @return the index of the worker, 0 for a thread outside the pool
+ */
+int threadPoolWorker(ThreadPool *pool);
+
+/** -------------------------------------------------------------------
+ * Get the number of logical processors on this machine.
+ * @return the number of processors (at least 1)
+ */
+int numberProcessors();
+
+/** -------------------------------------------------------------------
+ * Read the high resolution clock, which never goes backward.
+ * @return the time in QueryPerformanceCounter() ticks
+ */
+LONGLONG ticks();
+
+#endif // THREAD_POOL_H
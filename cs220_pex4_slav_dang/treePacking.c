@@ -0,0 +1,461 @@
+/** treePacking.c
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The implementation of an exact solver for the Shannon
+ *          Switching Game based on Lehman's theorem.
+ * ===========================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "treePacking.h"
+
+// Which forest an edge belongs to
+#define NO_FOREST  0
+
+// Labels of the exchange search
+#define UNLABELED  -2
+#define FIRST_EDGE -1
+
+// The edges of the contracted board split into two forests. The
+// forests are rooted (parent, depth, root) before each search so the
+// path between two vertices can be walked quickly.
+//
+// When an edge does not fit, the edges its search labeled hold two
+// spanning trees of their vertices (a "cluster"). A cluster can be
+// contracted without changing the answer for the remaining edges, so
+// later searches treat it as a single vertex and never walk into it
+// again. This keeps the total work close to linear in practice.
+typedef struct partition {
+    int numberVertices;    // Components of the locked edges
+    int numberEdges;       // Normal edges, then the virtual edges
+    int * from;            // Endpoints in the contracted board
+    int * to;
+    Edge * original;       // Endpoints in the board
+    int * owner;           // NO_FOREST, 1 or 2
+    int * cluster;         // Union-find of the clusters found so far
+
+    int * parent[3];       // Rooted forests 1 and 2 ([0] is not used)
+    int * parentEdge[3];
+    int * depth[3];
+    int * root[3];
+
+    int * label;           // The exchange search: the edge that would
+    int * queue;           //   take this edge's place in its forest
+    int * offsets;         // Scratch space to build the forests
+    int * arcs;
+    int * stack;
+} Partition;
+
+// Local functions
+static Partition * partitionCreate(int numberVertices, int capacity);
+static void partitionDelete(Partition *partition);
+static void addEdge(Partition *partition, int from, int to, Edge original);
+static void greedyForests(Partition *partition);
+static void rootForest(Partition *partition, int forest);
+static int augment(Partition *partition, int first, int apply);
+static TreePacking * witness(Partition *partition, int vertex);
+static int inCluster(Partition *partition, int e);
+
+/** -------------------------------------------------------------------
+ * Decide who wins the current position with perfect play. Locked edges
+ * are contracted and cut edges are gone, then the normal edges are
+ * split into two forests that are as large as possible (Edmonds'
+ * matroid partition algorithm) and the terminals are tested against
+ * Lehman's theorem.
+ * @param graph the board
+ * @param playerToMove Either CUT_PLAYER or SHORT_PLAYER
+ * @return the winner and, if Short wins, two witness trees. Delete it
+ *         with treePackingDelete().
+ */
+TreePacking * lehmanSolve(Graph *graph, int playerToMove) {
+    int n = graph->numberVertices;
+
+    // Contract the locked edges with a union-find, then number the
+    // components 0..numberComponents-1.
+    int *component = malloc(n * sizeof(int));
+    int *id = malloc(n * sizeof(int));
+    for (int v = 0; v < n; v++) {
+        component[v] = v;
+    }
+    for (int u = 0; u < n; u++) {
+        for (int k = 0; k < graph->degree[u]; k++) {
+            int v = graph->neighbors[u][k];
+            if (graph->edges[u][v] == LOCKED_EDGE) {
+                component[findGroup(component, u)] = findGroup(component, v);
+            }
+        }
+    }
+    int numberComponents = 0;
+    for (int v = 0; v < n; v++) {
+        if (findGroup(component, v) == v) {
+            id[v] = numberComponents++;
+        }
+    }
+    for (int v = 0; v < n; v++) {
+        id[v] = id[findGroup(component, v)];
+    }
+
+    int start = id[0];
+    int end = id[n-1];
+    if (start == end) {
+        // The locked edges already connect the terminals.
+        TreePacking *packing = calloc(1, sizeof(TreePacking));
+        packing->winner = SHORT_WINS;
+        free(component);
+        free(id);
+        return packing;
+    }
+
+    // The normal edges between different components, plus room for
+    // two virtual edges between the terminals.
+    Partition *partition = partitionCreate(numberComponents, graphNumberEdges(graph) + 2);
+    for (int u = 0; u < n; u++) {
+        for (int k = 0; k < graph->degree[u]; k++) {
+            int v = graph->neighbors[u][k];
+            if (u < v && graph->edges[u][v] == NORMAL_EDGE && id[u] != id[v]) {
+                Edge edge = {u, v};
+                addEdge(partition, id[u], id[v], edge);
+            }
+        }
+    }
+
+    greedyForests(partition);
+    for (int e = 0; e < partition->numberEdges; e++) {
+        if (partition->owner[e] == NO_FOREST) {
+            augment(partition, e, TRUE);
+        }
+    }
+
+    // The test edge fails to fit exactly when the terminals are inside
+    // a subgraph with two edge-disjoint spanning trees.
+    Edge terminals = {0, n-1};
+    int virtualEdge = partition->numberEdges;
+    addEdge(partition, start, end, terminals);
+    TreePacking *packing;
+    if (!augment(partition, virtualEdge, playerToMove == SHORT_PLAYER)) {
+        packing = witness(partition, start);
+    } else if (playerToMove == CUT_PLAYER) {
+        packing = calloc(1, sizeof(TreePacking));
+        packing->winner = CUT_WINS;
+    } else {
+        // Short moves first: the first virtual edge stands for Short's
+        // extra move, the second one is the test edge.
+        int secondVirtual = partition->numberEdges;
+        addEdge(partition, start, end, terminals);
+        if (!augment(partition, secondVirtual, FALSE)) {
+            packing = witness(partition, start);
+            int *cluster = partition->cluster;
+            if (findGroup(cluster, start) == findGroup(cluster, end)) {
+                packing->virtualTree = partition->owner[virtualEdge];
+            }
+        } else {
+            packing = calloc(1, sizeof(TreePacking));
+            packing->winner = CUT_WINS;
+        }
+    }
+
+    partitionDelete(partition);
+    free(component);
+    free(id);
+    return packing;
+}
+
+/** -------------------------------------------------------------------
+ * Delete the result of the solver.
+ * @param packing the result to delete
+ */
+void treePackingDelete(TreePacking *packing) {
+    free(packing->trees[0]);
+    free(packing->trees[1]);
+    free(packing);
+}
+
+/** -------------------------------------------------------------------
+ * Create an empty partition.
+ * @param numberVertices the number of vertices in the contracted board
+ * @param capacity the most edges that will be added
+ * @return a pointer to a partition struct
+ */
+Partition * partitionCreate(int numberVertices, int capacity) {
+    Partition *partition = malloc(sizeof(Partition));
+    partition->numberVertices = numberVertices;
+    partition->numberEdges = 0;
+    partition->from = malloc(capacity * sizeof(int));
+    partition->to = malloc(capacity * sizeof(int));
+    partition->original = malloc(capacity * sizeof(Edge));
+    partition->owner = malloc(capacity * sizeof(int));
+    partition->cluster = malloc(numberVertices * sizeof(int));
+    for (int v = 0; v < numberVertices; v++) {
+        partition->cluster[v] = v;
+    }
+    for (int forest = 1; forest <= 2; forest++) {
+        partition->parent[forest] = malloc(numberVertices * sizeof(int));
+        partition->parentEdge[forest] = malloc(numberVertices * sizeof(int));
+        partition->depth[forest] = malloc(numberVertices * sizeof(int));
+        partition->root[forest] = malloc(numberVertices * sizeof(int));
+    }
+    partition->label = malloc(capacity * sizeof(int));
+    partition->queue = malloc(capacity * sizeof(int));
+    partition->offsets = malloc((numberVertices + 1) * sizeof(int));
+    partition->arcs = malloc(2 * capacity * sizeof(int));
+    partition->stack = malloc(numberVertices * sizeof(int));
+    return partition;
+}
+
+/** -------------------------------------------------------------------
+ * Delete a partition.
+ * @param partition the partition to delete
+ */
+void partitionDelete(Partition *partition) {
+    free(partition->from);
+    free(partition->to);
+    free(partition->original);
+    free(partition->owner);
+    free(partition->cluster);
+    for (int forest = 1; forest <= 2; forest++) {
+        free(partition->parent[forest]);
+        free(partition->parentEdge[forest]);
+        free(partition->depth[forest]);
+        free(partition->root[forest]);
+    }
+    free(partition->label);
+    free(partition->queue);
+    free(partition->offsets);
+    free(partition->arcs);
+    free(partition->stack);
+    free(partition);
+}
+
+/** -------------------------------------------------------------------
+ * Add an edge that is not in either forest yet.
+ * @param partition the partition
+ * @param from one end in the contracted board
+ * @param to the other end in the contracted board
+ * @param original the edge in the board
+ */
+void addEdge(Partition *partition, int from, int to, Edge original) {
+    int e = partition->numberEdges++;
+    partition->from[e] = from;
+    partition->to[e] = to;
+    partition->original[e] = original;
+    partition->owner[e] = NO_FOREST;
+}
+
+/** -------------------------------------------------------------------
+ * Fill forest 1 and then forest 2 greedily with a union-find. Most of
+ * the edges land here; only the rest need the exchange search.
+ * @param partition the partition
+ */
+void greedyForests(Partition *partition) {
+    int *component = malloc(partition->numberVertices * sizeof(int));
+    for (int forest = 1; forest <= 2; forest++) {
+        for (int v = 0; v < partition->numberVertices; v++) {
+            component[v] = v;
+        }
+        for (int e = 0; e < partition->numberEdges; e++) {
+            if (partition->owner[e] == NO_FOREST) {
+                int a = findGroup(component, partition->from[e]);
+                int b = findGroup(component, partition->to[e]);
+                if (a != b) {
+                    component[a] = b;
+                    partition->owner[e] = forest;
+                }
+            }
+        }
+    }
+    free(component);
+}
+
+/** -------------------------------------------------------------------
+ * Root every tree of a forest: find each vertex's parent, the edge to
+ * its parent, its depth and the root of its tree.
+ * @param partition the partition
+ * @param forest 1 or 2
+ */
+void rootForest(Partition *partition, int forest) {
+    int n = partition->numberVertices;
+    int *offsets = partition->offsets;
+    int *arcs = partition->arcs;
+    int *parent = partition->parent[forest];
+    int *parentEdge = partition->parentEdge[forest];
+    int *depth = partition->depth[forest];
+    int *root = partition->root[forest];
+
+    // Adjacency lists of the forest between clusters (the arcs hold
+    // edge indexes). Edges inside a cluster are left out.
+    for (int v = 0; v <= n; v++) {
+        offsets[v] = 0;
+    }
+    for (int e = 0; e < partition->numberEdges; e++) {
+        if (partition->owner[e] == forest && !inCluster(partition, e)) {
+            offsets[findGroup(partition->cluster, partition->from[e]) + 1]++;
+            offsets[findGroup(partition->cluster, partition->to[e]) + 1]++;
+        }
+    }
+    for (int v = 0; v < n; v++) {
+        offsets[v+1] += offsets[v];
+        root[v] = -1;
+    }
+    int *next = partition->stack; // The next free slot of each vertex
+    for (int v = 0; v < n; v++) {
+        next[v] = offsets[v];
+    }
+    for (int e = 0; e < partition->numberEdges; e++) {
+        if (partition->owner[e] == forest && !inCluster(partition, e)) {
+            arcs[next[findGroup(partition->cluster, partition->from[e])]++] = e;
+            arcs[next[findGroup(partition->cluster, partition->to[e])]++] = e;
+        }
+    }
+
+    // Walk each tree from its root, with the scratch array as a stack
+    for (int r = 0; r < n; r++) {
+        if (root[r] == -1 && partition->cluster[r] == r) {
+            root[r] = r;
+            parent[r] = -1;
+            parentEdge[r] = -1;
+            depth[r] = 0;
+            int top = 0;
+            next[top++] = r;
+            while (top > 0) {
+                int u = next[--top];
+                for (int a = offsets[u]; a < offsets[u+1]; a++) {
+                    int e = arcs[a];
+                    int v = findGroup(partition->cluster, partition->from[e]);
+                    if (v == u) {
+                        v = findGroup(partition->cluster, partition->to[e]);
+                    }
+                    if (root[v] == -1) {
+                        root[v] = r;
+                        parent[v] = u;
+                        parentEdge[v] = e;
+                        depth[v] = depth[u] + 1;
+                        next[top++] = v;
+                    }
+                }
+            }
+        }
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Try to make room for an edge in one of the forests. A breadth-first
+ * search over exchanges labels each forest edge g with the edge f that
+ * would replace it (g is on the cycle f closes in g's forest). The
+ * search ends when some labeled edge joins two trees of the other
+ * forest; shifting every edge one step along the chain of labels then
+ * adds the first edge without breaking either forest.
+ * @param partition the partition
+ * @param first the edge to add; it must not be in a forest
+ * @param apply if FALSE, the forests are left unchanged
+ * @return TRUE if the edge fits. If it does not, the labeled edges
+ *         are merged into one cluster with the ends of the edge.
+ */
+int augment(Partition *partition, int first, int apply) {
+    if (inCluster(partition, first)) {
+        return FALSE; // Spanned by the cluster it is in
+    }
+
+    rootForest(partition, 1);
+    rootForest(partition, 2);
+    for (int e = 0; e < partition->numberEdges; e++) {
+        partition->label[e] = UNLABELED;
+    }
+
+    int head = 0;
+    int tail = 0;
+    partition->label[first] = FIRST_EDGE;
+    partition->queue[tail++] = first;
+    while (head < tail) {
+        int f = partition->queue[head++];
+        for (int forest = 1; forest <= 2; forest++) {
+            if (forest == partition->owner[f]) {
+                continue;
+            }
+            int u = findGroup(partition->cluster, partition->from[f]);
+            int v = findGroup(partition->cluster, partition->to[f]);
+            if (partition->root[forest][u] != partition->root[forest][v]) {
+                // f joins two trees of this forest: shift the chain.
+                if (apply) {
+                    int target = forest;
+                    for (int g = f; g != FIRST_EDGE; g = partition->label[g]) {
+                        int previous = partition->owner[g];
+                        partition->owner[g] = target;
+                        target = previous;
+                    }
+                }
+                return TRUE;
+            }
+
+            // Label the edges on the path from u to v in this forest
+            int *depth = partition->depth[forest];
+            while (u != v) {
+                int g;
+                if (depth[u] >= depth[v]) {
+                    g = partition->parentEdge[forest][u];
+                    u = partition->parent[forest][u];
+                } else {
+                    g = partition->parentEdge[forest][v];
+                    v = partition->parent[forest][v];
+                }
+                if (partition->label[g] == UNLABELED) {
+                    partition->label[g] = f;
+                    partition->queue[tail++] = g;
+                }
+            }
+        }
+    }
+
+    // Every labeled edge, and the first one, is now inside one cluster
+    int *cluster = partition->cluster;
+    for (int j = 0; j < tail; j++) {
+        int e = partition->queue[j];
+        int a = findGroup(cluster, partition->from[e]);
+        int b = findGroup(cluster, partition->to[e]);
+        if (a != b) {
+            cluster[a] = b;
+        }
+    }
+    return FALSE;
+}
+
+/** -------------------------------------------------------------------
+ * Check if both ends of an edge are in the same cluster.
+ * @param partition the partition
+ * @param e the edge
+ * @return TRUE if the edge is inside a cluster
+ */
+int inCluster(Partition *partition, int e) {
+    return findGroup(partition->cluster, partition->from[e]) ==
+           findGroup(partition->cluster, partition->to[e]);
+}
+
+/** -------------------------------------------------------------------
+ * Build Short's witness after the test edge failed to fit. The forest 1
+ * edges and the forest 2 edges inside the cluster of the terminals are
+ * two edge-disjoint spanning trees of that cluster.
+ * @param partition the partition, right after augment() failed
+ * @param vertex a vertex of the cluster (a terminal)
+ * @return a result that says Short wins
+ */
+TreePacking * witness(Partition *partition, int vertex) {
+    TreePacking *packing = calloc(1, sizeof(TreePacking));
+    packing->winner = SHORT_WINS;
+    packing->trees[0] = malloc(partition->numberEdges * sizeof(Edge));
+    packing->trees[1] = malloc(partition->numberEdges * sizeof(Edge));
+
+    int target = findGroup(partition->cluster, vertex);
+    int size[2] = {0, 0};
+    for (int e = 0; e < partition->numberEdges; e++) {
+        if (partition->owner[e] != NO_FOREST && inCluster(partition, e) &&
+            findGroup(partition->cluster, partition->from[e]) == target) {
+            int tree = partition->owner[e] - 1;
+            packing->trees[tree][size[tree]++] = partition->original[e];
+        }
+    }
+    packing->numberTreeEdges = size[0];
+    return packing;
+}
@@ -0,0 +1,52 @@
+/** treePacking.h
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The definition of an exact solver for the Shannon
+ *          Switching Game based on Lehman's theorem.
+ * ===========================================================
+ */
+
+#ifndef TREE_PACKING_H
+#define TREE_PACKING_H
+
+#include "Graph.h"
+#include "gameLogic.h"
+
+// Lehman's theorem: with Cut to move, Short wins if and only if some
+// subgraph that contains both terminals has two edge-disjoint spanning
+// trees. With Short to move, the same test is made after adding one
+// extra "virtual" edge between the terminals.
+//
+// The result of the solver. The witness trees are given with the locked
+// edges contracted, so each tree edge is a normal edge of the board.
+typedef struct treePacking {
+    int winner;            // SHORT_WINS or CUT_WINS with perfect play
+    int numberTreeEdges;   // The number of edges in each witness tree
+    Edge * trees[2];       // The two witness trees (only if Short wins)
+    int virtualTree;       // 0, or 1/2 if that tree holds the virtual
+                           // edge, stored as (0, numberVertices-1)
+} TreePacking;
+
+/** -------------------------------------------------------------------
+ * Decide who wins the current position with perfect play. Locked edges
+ * are contracted and cut edges are gone, then the normal edges are
+ * split into two forests that are as large as possible (Edmonds'
+ * matroid partition algorithm) and the terminals are tested against
+ * Lehman's theorem.
+ * @param graph the board
+ * @param playerToMove Either CUT_PLAYER or SHORT_PLAYER
+ * @return the winner and, if Short wins, two witness trees. Delete it
+ *         with treePackingDelete().
+ */
+TreePacking * lehmanSolve(Graph *graph, int playerToMove);
+
+/** -------------------------------------------------------------------
+ * Delete the result of the solver.
+ * @param packing the result to delete
+ */
+void treePackingDelete(TreePacking *packing);
+
+#endif // TREE_PACKING_H
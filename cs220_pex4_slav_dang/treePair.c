@@ -0,0 +1,348 @@
+/** treePair.c
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The implementation of Short's winning strategy: a
+ *          pair of edge-disjoint spanning trees that is repaired
+ *          after every move of Cut.
+ * ===========================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "treePair.h"
+#include "treePacking.h"
+
+// Local functions
+static int rebuild(TreePair *pair, Graph *graph);
+static int startingMove(TreePair *pair, Graph *graph, Edge *edge);
+static int repair(TreePair *pair, Graph *graph, int tree, int u, int v, Edge *edge);
+static int spareMove(TreePair *pair, Graph *graph, Edge *edge);
+static int inTree(TreePair *pair, Graph *graph, int tree, int x, int y);
+static void setMember(TreePair *pair, int x, int y, int bits);
+
+/** -------------------------------------------------------------------
+ * Create an empty tree pair. It is built on the first call to
+ * treePairReply().
+ * @param numberVertices the number of vertices of the board
+ * @return a pointer to a tree pair struct
+ */
+TreePair * treePairCreate(int numberVertices) {
+    TreePair *pair = calloc(1, sizeof(TreePair));
+    pair->numberVertices = numberVertices;
+    pair->member = malloc(numberVertices * sizeof(unsigned char *));
+    for (int v = 0; v < numberVertices; v++) {
+        pair->member[v] = calloc((size_t) numberVertices, sizeof(unsigned char));
+    }
+    pair->seen = calloc((size_t) numberVertices, sizeof(int));
+    pair->side = malloc((size_t) numberVertices);
+    pair->queue[0] = malloc(numberVertices * sizeof(int));
+    pair->queue[1] = malloc(numberVertices * sizeof(int));
+    pair->expected.fromVertex = -1;
+    return pair;
+}
+
+/** -------------------------------------------------------------------
+ * Delete a tree pair
+ * @param pair the tree pair to delete
+ */
+void treePairDelete(TreePair *pair) {
+    for (int v = 0; v < pair->numberVertices; v++) {
+        free(pair->member[v]);
+    }
+    free(pair->member);
+    free(pair->seen);
+    free(pair->side);
+    free(pair->queue[0]);
+    free(pair->queue[1]);
+    free(pair);
+}
+
+/** -------------------------------------------------------------------
+ * Tell the pair about a move. Every change of an edge state must be
+ * passed here, or the pair is rebuilt on the next reply.
+ * @param pair the tree pair
+ * @param graph the board
+ * @param fromVertex one end of the edge
+ * @param toVertex the other end of the edge
+ * @param state the new state of the edge
+ */
+void treePairObserve(TreePair *pair, Graph *graph, int fromVertex, int toVertex, int state) {
+    if (!pair->valid || pair->graph != graph) {
+        return;
+    }
+
+    if (state == NO_EDGE) {
+        // Short answers one cut at a time
+        pair->cuts++;
+        pair->cut.fromVertex = fromVertex;
+        pair->cut.toVertex = toVertex;
+        pair->cutTree = pair->member[fromVertex][toVertex];
+        setMember(pair, fromVertex, toVertex, 0);
+        if (pair->cuts > 1) {
+            pair->valid = FALSE;
+        }
+    } else if (state == LOCKED_EDGE) {
+        // Only the edge the pair asked for can be locked
+        Edge expected = pair->expected;
+        if (!((expected.fromVertex == fromVertex && expected.toVertex == toVertex) ||
+              (expected.fromVertex == toVertex && expected.toVertex == fromVertex))) {
+            pair->valid = FALSE;
+        }
+        pair->expected.fromVertex = -1;
+    } else {
+        pair->valid = FALSE;
+    }
+}
+
+/** -------------------------------------------------------------------
+ * Find Short's move. The trees are updated as if the edge was locked,
+ * so the caller must lock it (and pass that to treePairObserve()).
+ * @param pair the tree pair
+ * @param graph the board
+ * @param edge output: the edge to lock
+ * @return TRUE if Short has a winning move. Return FALSE if Cut wins
+ *         with perfect play, or the game is over.
+ */
+int treePairReply(TreePair *pair, Graph *graph, Edge *edge) {
+    int end = graph->numberVertices - 1;
+
+    // A normal edge between the terminals wins at once
+    if (graphGetEdge(graph, 0, end) == NORMAL_EDGE) {
+        edge->fromVertex = 0;
+        edge->toVertex = end;
+        pair->valid = FALSE;
+        return TRUE;
+    }
+
+    if (pair->valid && pair->graph == graph) {
+        int tree = pair->cutTree;
+        int found = (tree == 0) ? spareMove(pair, graph, edge)
+                                : repair(pair, graph, tree, pair->cut.fromVertex,
+                                         pair->cut.toVertex, edge);
+        pair->cuts = 0;
+        pair->cutTree = 0;
+        if (found) {
+            return TRUE;
+        }
+    }
+
+    // The first move, or the trees could not follow the game
+    if (!rebuild(pair, graph)) {
+        return FALSE;
+    }
+    return startingMove(pair, graph, edge);
+}
+
+/** -------------------------------------------------------------------
+ * Build the trees from scratch with the Lehman solver, with Short to
+ * move.
+ * @param pair the tree pair
+ * @param graph the board
+ * @return TRUE if Short wins and the trees were built
+ */
+int rebuild(TreePair *pair, Graph *graph) {
+    pair->valid = FALSE;
+    pair->rebuilds++;
+    if (graph->numberVertices > pair->numberVertices) {
+        return FALSE; // The pair was created for a smaller board
+    }
+
+    TreePacking *packing = lehmanSolve(graph, SHORT_PLAYER);
+    if (packing->winner != SHORT_WINS || packing->numberTreeEdges == 0) {
+        treePackingDelete(packing);
+        return FALSE;
+    }
+
+    for (int v = 0; v < graph->numberVertices; v++) {
+        memset(pair->member[v], 0, (size_t) graph->numberVertices);
+    }
+    for (int tree = 0; tree < 2; tree++) {
+        for (int k = 0; k < packing->numberTreeEdges; k++) {
+            Edge e = packing->trees[tree][k];
+            // The virtual edge is not on the board
+            if (graphGetEdge(graph, e.fromVertex, e.toVertex) == NORMAL_EDGE) {
+                setMember(pair, e.fromVertex, e.toVertex, tree + 1);
+            }
+        }
+    }
+
+    pair->graph = graph;
+    pair->virtualTree = packing->virtualTree;
+    pair->cuts = 0;
+    pair->cutTree = 0;
+    pair->expected.fromVertex = -1;
+    pair->valid = TRUE;
+    treePackingDelete(packing);
+    return TRUE;
+}
+
+/** -------------------------------------------------------------------
+ * Find Short's move right after a rebuild. If one tree uses the
+ * virtual edge between the terminals, Short plays as if Cut had just
+ * cut it.
+ * @param pair the tree pair
+ * @param graph the board
+ * @param edge output: the edge to lock
+ * @return TRUE if a move was found
+ */
+int startingMove(TreePair *pair, Graph *graph, Edge *edge) {
+    int found;
+    if (pair->virtualTree != 0) {
+        found = repair(pair, graph, pair->virtualTree, 0, graph->numberVertices - 1, edge);
+    } else {
+        found = spareMove(pair, graph, edge);
+    }
+    if (!found) {
+        pair->valid = FALSE;
+    }
+    return found;
+}
+
+/** -------------------------------------------------------------------
+ * Repair a tree that lost the edge (u,v). Both parts of the tree are
+ * searched one vertex at a time, so the search stops as soon as the
+ * smaller part is finished. Then a normal edge of the other tree that
+ * leaves the smaller part is added to the broken tree.
+ * @param pair the tree pair
+ * @param graph the board
+ * @param tree TREE_1 or TREE_2, the broken tree
+ * @param u one end of the lost edge
+ * @param v the other end of the lost edge
+ * @param edge output: the edge to lock
+ * @return TRUE if the tree was repaired. Return FALSE if the trees
+ *         do not match the board.
+ */
+int repair(TreePair *pair, Graph *graph, int tree, int u, int v, Edge *edge) {
+    int generation = ++pair->generation;
+    int *seen = pair->seen;
+    char *side = pair->side;
+    int head[2] = {0, 0};
+    int tail[2] = {1, 1};
+    pair->queue[0][0] = u;
+    pair->queue[1][0] = v;
+    seen[u] = seen[v] = generation;
+    side[u] = 0;
+    side[v] = 1;
+
+    // Grow both parts in turn until one of them cannot grow
+    int small = -1;
+    while (small == -1) {
+        for (int s = 0; s < 2 && small == -1; s++) {
+            if (head[s] == tail[s]) {
+                small = s;
+                break;
+            }
+            int x = pair->queue[s][head[s]++];
+            for (int j = 0; j < graph->degree[x]; j++) {
+                int y = graph->neighbors[x][j];
+                if ((x == u && y == v) || (x == v && y == u) || !inTree(pair, graph, tree, x, y)) {
+                    continue;
+                }
+                if (seen[y] != generation) {
+                    seen[y] = generation;
+                    side[y] = (char) s;
+                    pair->queue[s][tail[s]++] = y;
+                } else if (side[y] != s) {
+                    return FALSE; // The edge did not split the tree
+                }
+            }
+        }
+    }
+
+    // The other tree has an edge that leaves the smaller part
+    int other = TREE_1 + TREE_2 - tree;
+    for (int i = 0; i < tail[small]; i++) {
+        int x = pair->queue[small][i];
+        for (int j = 0; j < graph->degree[x]; j++) {
+            int y = graph->neighbors[x][j];
+            if (graph->edges[x][y] == NORMAL_EDGE && (pair->member[x][y] & other) &&
+                !(seen[y] == generation && side[y] == small)) {
+                setMember(pair, x, y, TREE_1 | TREE_2);
+                edge->fromVertex = x;
+                edge->toVertex = y;
+                pair->expected = *edge;
+                return TRUE;
+            }
+        }
+    }
+    return FALSE;
+}
+
+/** -------------------------------------------------------------------
+ * Find a move when Cut did not break a tree. Short gives up an edge of
+ * tree 1 that leads to a leaf and locks the edge of tree 2 that takes
+ * its place, so the only part to search is the leaf.
+ * @param pair the tree pair
+ * @param graph the board
+ * @param edge output: the edge to lock
+ * @return TRUE if a move was found
+ */
+int spareMove(TreePair *pair, Graph *graph, Edge *edge) {
+    int n = graph->numberVertices;
+    int from = -1;
+    int to = -1;
+
+    for (int i = 0; i < n && from == -1; i++) {
+        int x = (pair->cursor + i) % n;
+        int count = 0;
+        int y = -1;
+        for (int j = 0; j < graph->degree[x] && count < 2; j++) {
+            int z = graph->neighbors[x][j];
+            if (inTree(pair, graph, TREE_1, x, z)) {
+                count++;
+                y = z;
+            }
+        }
+        if (count == 1 && pair->member[x][y] == TREE_1) {
+            from = x;
+            to = y;
+            pair->cursor = x;
+        }
+    }
+
+    // Any edge that is only in tree 1 will do, but it is slower
+    for (int x = 0; x < n && from == -1; x++) {
+        for (int j = 0; j < graph->degree[x] && from == -1; j++) {
+            int y = graph->neighbors[x][j];
+            if (graph->edges[x][y] == NORMAL_EDGE && pair->member[x][y] == TREE_1) {
+                from = x;
+                to = y;
+            }
+        }
+    }
+
+    if (from == -1) {
+        return FALSE;
+    }
+    setMember(pair, from, to, 0);
+    return repair(pair, graph, TREE_1, from, to, edge);
+}
+
+/** -------------------------------------------------------------------
+ * Check if an edge belongs to a tree. Locked edges belong to both.
+ * @param pair the tree pair
+ * @param graph the board
+ * @param tree TREE_1 or TREE_2
+ * @param x one end of the edge
+ * @param y the other end of the edge
+ * @return TRUE if the edge is in the tree
+ */
+int inTree(TreePair *pair, Graph *graph, int tree, int x, int y) {
+    return graph->edges[x][y] == LOCKED_EDGE || (pair->member[x][y] & tree);
+}
+
+/** -------------------------------------------------------------------
+ * Set the tree bits of an edge in both directions.
+ * @param pair the tree pair
+ * @param x one end of the edge
+ * @param y the other end of the edge
+ * @param bits TREE_1 and/or TREE_2, or 0
+ */
+void setMember(TreePair *pair, int x, int y, int bits) {
+    pair->member[x][y] = (unsigned char) bits;
+    pair->member[y][x] = (unsigned char) bits;
+}
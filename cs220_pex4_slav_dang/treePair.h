@@ -0,0 +1,87 @@
+/** treePair.h
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The definition of Short's winning strategy: a pair of
+ *          edge-disjoint spanning trees that is repaired after
+ *          every move of Cut.
+ * ===========================================================
+ */
+
+#ifndef TREE_PAIR_H
+#define TREE_PAIR_H
+
+#include "Graph.h"
+#include "gameLogic.h"
+
+// The bits of TreePair.member
+#define TREE_1  1
+#define TREE_2  2
+
+// Two trees that span the same vertices (with the locked edges
+// contracted) and share only locked edges. When Cut removes an edge of
+// one tree, the tree falls into two parts and some normal edge of the
+// other tree joins them: Short locks it, and it is added to the broken
+// tree, so both trees are whole again. The pair is built once with
+// lehmanSolve() and then only repaired, by searching the smaller of
+// the two parts.
+typedef struct treePair {
+    Graph * graph;              // The board the trees belong to
+    int numberVertices;
+    int valid;                  // FALSE until built, or if a move was
+                                //   made that the pair cannot follow
+    unsigned char ** member;    // TREE_1/TREE_2 bits of each normal edge
+    int virtualTree;            // Right after a rebuild: the tree that
+                                //   holds the virtual edge, or 0
+    int cuts;                   // Cut's moves since Short's last reply
+    Edge cut;                   // The last edge cut, and the tree it
+    int cutTree;                //   was in (0 if it was in neither)
+    Edge expected;              // The edge Short said it would lock
+    int rebuilds;               // The number of calls to lehmanSolve()
+
+    int generation;             // Scratch space of the repair search
+    int * seen;
+    char * side;
+    int * queue[2];
+    int cursor;                 // Where the search for a leaf resumes
+} TreePair;
+
+/** -------------------------------------------------------------------
+ * Create an empty tree pair. It is built on the first call to
+ * treePairReply().
+ * @param numberVertices the number of vertices of the board
+ * @return a pointer to a tree pair struct
+ */
+TreePair * treePairCreate(int numberVertices);
+
+/** -------------------------------------------------------------------
+ * Delete a tree pair
+ * @param pair the tree pair to delete
+ */
+void treePairDelete(TreePair *pair);
+
+/** -------------------------------------------------------------------
+ * Tell the pair about a move. Every change of an edge state must be
+ * passed here, or the pair is rebuilt on the next reply.
+ * @param pair the tree pair
+ * @param graph the board
+ * @param fromVertex one end of the edge
+ * @param toVertex the other end of the edge
+ * @param state the new state of the edge
+ */
+void treePairObserve(TreePair *pair, Graph *graph, int fromVertex, int toVertex, int state);
+
+/** -------------------------------------------------------------------
+ * Find Short's move. The trees are updated as if the edge was locked,
+ * so the caller must lock it (and pass that to treePairObserve()).
+ * @param pair the tree pair
+ * @param graph the board
+ * @param edge output: the edge to lock
+ * @return TRUE if Short has a winning move. Return FALSE if Cut wins
+ *         with perfect play, or the game is over.
+ */
+int treePairReply(TreePair *pair, Graph *graph, Edge *edge);
+
+#endif // TREE_PAIR_H
@@ -0,0 +1,326 @@
+/** treeSampler.c
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The implementation of a parallel sampler of random
+ *          spanning trees that estimates the current through
+ *          each edge on boards too large to solve exactly.
+ * ===========================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "treeSampler.h"
+
+// The scratch memory of one worker.
+typedef struct samplerWorker {
+    int * nextArc;              // The last arc the walk took out of each node
+    int * crossings;            // The worker's own counts of the arcs
+    int trees;
+    long long steps;
+} SamplerWorker;
+
+// What the tasks of one run share.
+typedef struct samplerRunContext {
+    TreeSampler * sampler;
+    SamplerWorker * workers;
+    LONGLONG deadline;          // In QueryPerformanceCounter() ticks
+} SamplerRunContext;
+
+// Local functions
+static int mergeBoard(TreeSampler *sampler, Adjacency *board, Adjacency *locked);
+static void sampleTask(void *context, int taskIndex, int workerIndex);
+static unsigned long long mixSeed(unsigned long long x);
+
+/** -------------------------------------------------------------------
+ * Create a tree sampler.
+ * @param numberVertices the most vertices a board can have
+ * @param numberArcs the most arcs (twice the edges) a board can have
+ * @return a pointer to a tree sampler struct
+ */
+TreeSampler * samplerCreate(int numberVertices, int numberArcs) {
+    TreeSampler *sampler = calloc(1, sizeof(TreeSampler));
+    sampler->capacity = numberVertices;
+    sampler->arcCapacity = numberArcs;
+    sampler->group = malloc(numberVertices * sizeof(int));
+    sampler->node = malloc(numberVertices * sizeof(int));
+    sampler->queue = malloc(numberVertices * sizeof(int));
+    sampler->offsets = malloc((numberVertices + 1) * sizeof(int));
+    sampler->targets = malloc((numberArcs + 1) * sizeof(int));
+    sampler->arcs = malloc((numberArcs + 1) * sizeof(int));
+    sampler->boardOffsets = malloc((numberVertices + 1) * sizeof(int));
+    sampler->boardNeighbors = malloc((numberArcs + 1) * sizeof(int));
+    sampler->crossings = malloc((numberArcs + 1) * sizeof(int));
+    sampler->seed = 0x9E3779B97F4A7C15ULL ^ (unsigned long long) rand();
+
+    if (sampler->arcs == NULL || sampler->crossings == NULL) {
+        printf("ERROR in samplerCreate. Not enough memory for %d vertices.\n", numberVertices);
+        exit(1);
+    }
+    return sampler;
+}
+
+/** -------------------------------------------------------------------
+ * Delete a tree sampler
+ * @param sampler the sampler to delete
+ */
+void samplerDelete(TreeSampler *sampler) {
+    free(sampler->group);
+    free(sampler->node);
+    free(sampler->queue);
+    free(sampler->offsets);
+    free(sampler->targets);
+    free(sampler->arcs);
+    free(sampler->boardOffsets);
+    free(sampler->boardNeighbors);
+    free(sampler->crossings);
+    free(sampler);
+}
+
+/** -------------------------------------------------------------------
+ * Sample the paths between the terminals (vertex 0 and vertex
+ * numberVertices-1) of random spanning trees. The trees are shared out
+ * among the workers of the pool. Each tree has its own random numbers
+ * and the counts are added up at the end, so the result does not depend
+ * on the number of threads unless the time runs out.
+ * @param sampler the sampler; it must be big enough for the board
+ * @param board the normal and locked edges
+ * @param locked the locked edges
+ * @param pool the threads that take the samples
+ * @param numberTrees the number of trees; more is slower but more exact
+ * @param milliseconds the most time to spend; the trees that are not
+ *                     finished in time are left out
+ * @return TRUE if the game is underway. Return FALSE if the terminals
+ *         are not connected, or are already joined by locked edges.
+ */
+int samplerRun(TreeSampler *sampler, Adjacency *board, Adjacency *locked, ThreadPool *pool,
+               int numberTrees, int milliseconds) {
+    int n = board->numberVertices;
+    if (n > sampler->capacity || board->numberArcs > sampler->arcCapacity) {
+        printf("ERROR in samplerRun. The board has too many vertices or edges.\n");
+        exit(1);
+    }
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    LONGLONG start = ticks();
+
+    sampler->numberVertices = n;
+    memcpy(sampler->boardOffsets, board->offsets, (n + 1) * sizeof(int));
+    memcpy(sampler->boardNeighbors, board->neighbors, board->numberArcs * sizeof(int));
+    memset(sampler->crossings, 0, board->numberArcs * sizeof(int));
+    sampler->trees = 0;
+    sampler->steps = 0;
+    if (!mergeBoard(sampler, board, locked)) {
+        return FALSE;
+    }
+
+    SamplerRunContext run;
+    run.sampler = sampler;
+    run.deadline = start + (LONGLONG) milliseconds * frequency.QuadPart / 1000;
+    run.workers = malloc(pool->numberThreads * sizeof(SamplerWorker));
+    for (int i = 0; i < pool->numberThreads; i++) {
+        run.workers[i].nextArc = malloc(sampler->numberNodes * sizeof(int));
+        run.workers[i].crossings = calloc((size_t) board->numberArcs + 1, sizeof(int));
+        run.workers[i].trees = 0;
+        run.workers[i].steps = 0;
+    }
+    threadPoolFor(pool, numberTrees, sampleTask, &run);
+
+    // Add up the counts of the workers
+    for (int i = 0; i < pool->numberThreads; i++) {
+        SamplerWorker *worker = &run.workers[i];
+        for (int k = 0; k < board->numberArcs; k++) {
+            sampler->crossings[k] += worker->crossings[k];
+        }
+        sampler->trees += worker->trees;
+        sampler->steps += worker->steps;
+        free(worker->nextArc);
+        free(worker->crossings);
+    }
+    free(run.workers);
+    sampler->seed = mixSeed(sampler->seed);
+    return TRUE;
+}
+
+/** -------------------------------------------------------------------
+ * Estimate the current through an edge when 1 amp flows from the start
+ * to the end. samplerRun() must be called first.
+ * @param sampler the sampler
+ * @param fromVertex one end of the edge
+ * @param toVertex the other end of the edge
+ * @return the current, in amps; 0 if no tree was sampled
+ */
+double samplerCurrent(TreeSampler *sampler, int fromVertex, int toVertex) {
+    if (sampler->trees == 0) {
+        return 0.0;
+    }
+    int net = 0;
+    for (int k = sampler->boardOffsets[fromVertex]; k < sampler->boardOffsets[fromVertex+1]; k++) {
+        if (sampler->boardNeighbors[k] == toVertex) {
+            net += sampler->crossings[k];
+        }
+    }
+    for (int k = sampler->boardOffsets[toVertex]; k < sampler->boardOffsets[toVertex+1]; k++) {
+        if (sampler->boardNeighbors[k] == fromVertex) {
+            net -= sampler->crossings[k];
+        }
+    }
+    return fabs((double) net) / sampler->trees;
+}
+
+/** -------------------------------------------------------------------
+ * Merge the vertices joined by locked edges into nodes, and build the
+ * arcs between the nodes that are connected to the terminals.
+ * @param sampler the sampler
+ * @param board the normal and locked edges
+ * @param locked the locked edges
+ * @return TRUE if the game is underway, FALSE if it is over
+ */
+int mergeBoard(TreeSampler *sampler, Adjacency *board, Adjacency *locked) {
+    int n = board->numberVertices;
+    int *group = sampler->group;
+    int *node = sampler->node;
+    int *queue = sampler->queue;
+    for (int v = 0; v < n; v++) {
+        group[v] = v;
+        node[v] = -1;
+    }
+    for (int v = 0; v < n; v++) {
+        for (int k = locked->offsets[v]; k < locked->offsets[v+1]; k++) {
+            group[findGroup(group, v)] = findGroup(group, locked->neighbors[k]);
+        }
+    }
+    if (findGroup(group, 0) == findGroup(group, n - 1)) {
+        return FALSE; // Short has won
+    }
+
+    // The vertices connected to the start, in the order they are reached
+    int tail = 0;
+    node[0] = 0;
+    queue[tail++] = 0;
+    for (int head = 0; head < tail; head++) {
+        int v = queue[head];
+        for (int k = board->offsets[v]; k < board->offsets[v+1]; k++) {
+            int w = board->neighbors[k];
+            if (node[w] == -1) {
+                node[w] = 0;
+                queue[tail++] = w;
+            }
+        }
+    }
+    if (node[n-1] == -1) {
+        return FALSE; // Cut has won
+    }
+
+    // Number the groups, then give every vertex its group's node
+    sampler->numberNodes = 0;
+    for (int i = 0; i < tail; i++) {
+        int v = queue[i];
+        if (group[v] == v) {
+            node[v] = sampler->numberNodes++;
+        }
+    }
+    for (int i = 0; i < tail; i++) {
+        int v = queue[i];
+        node[v] = node[findGroup(group, v)];
+    }
+    sampler->source = node[0];
+    sampler->sink = node[n-1];
+
+    // Count the arcs out of each node, then fill them in
+    int *offsets = sampler->offsets;
+    for (int a = 0; a <= sampler->numberNodes; a++) {
+        offsets[a] = 0;
+    }
+    for (int i = 0; i < tail; i++) {
+        int v = queue[i];
+        for (int k = board->offsets[v]; k < board->offsets[v+1]; k++) {
+            offsets[node[v] + 1] += (node[board->neighbors[k]] != node[v]);
+        }
+    }
+    for (int a = 0; a < sampler->numberNodes; a++) {
+        offsets[a+1] += offsets[a];
+    }
+    for (int i = 0; i < tail; i++) {
+        int v = queue[i];
+        int a = node[v];
+        for (int k = board->offsets[v]; k < board->offsets[v+1]; k++) {
+            int b = node[board->neighbors[k]];
+            if (b != a) {
+                sampler->targets[offsets[a]] = b;
+                sampler->arcs[offsets[a]++] = k;
+            }
+        }
+    }
+    for (int a = sampler->numberNodes; a > 0; a--) {
+        offsets[a] = offsets[a-1];
+    }
+    offsets[0] = 0;
+    return TRUE;
+}
+
+/** -------------------------------------------------------------------
+ * Sample the path from the start to the end of one random spanning
+ * tree. The walk moves to a random neighbor until it reaches the end,
+ * and remembers only the last arc it took out of each node. Following
+ * those arcs from the start erases the loops of the walk, which is the
+ * first step of Wilson's algorithm.
+ * @param context the SamplerRunContext
+ * @param taskIndex the tree, which picks its random numbers
+ * @param workerIndex which worker's scratch memory to use
+ */
+void sampleTask(void *context, int taskIndex, int workerIndex) {
+    SamplerRunContext *run = context;
+    TreeSampler *sampler = run->sampler;
+    SamplerWorker *worker = &run->workers[workerIndex];
+    if (ticks() >= run->deadline) {
+        return;
+    }
+
+    unsigned long long random = mixSeed(sampler->seed + (unsigned long long) taskIndex);
+    int *offsets = sampler->offsets;
+    int *targets = sampler->targets;
+    int *nextArc = worker->nextArc;
+    long long steps = 0;
+    int a = sampler->source;
+    while (a != sampler->sink) {
+        if ((++steps & (SAMPLER_CLOCK_STEPS - 1)) == 0 && ticks() >= run->deadline) {
+            worker->steps += steps;
+            return;
+        }
+
+        // xorshift64*, scaled to the degree without a division
+        random ^= random >> 12;
+        random ^= random << 25;
+        random ^= random >> 27;
+        unsigned long long r = (random * 0x2545F4914F6CDD1DULL) >> 32;
+        int degree = offsets[a+1] - offsets[a];
+        int i = offsets[a] + (int) ((r * (unsigned long long) degree) >> 32);
+        nextArc[a] = i;
+        a = targets[i];
+    }
+
+    for (a = sampler->source; a != sampler->sink; a = targets[nextArc[a]]) {
+        worker->crossings[sampler->arcs[nextArc[a]]]++;
+    }
+    worker->trees++;
+    worker->steps += steps;
+}
+
+/** -------------------------------------------------------------------
+ * Scramble a number (splitmix64), so nearby seeds give unrelated
+ * random numbers.
+ * @param x the number
+ * @return a random-looking number; never 0
+ */
+unsigned long long mixSeed(unsigned long long x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return (x == 0) ? 1 : x;
+}
@@ -0,0 +1,110 @@
+/** treeSampler.h
+ * ===========================================================
+ * Name: CS220, Spring 2018
+ * Modified by: Tricia Dang and Maya Slavin
+ * Section: M3/M4
+ * Project: PEX4
+ * Purpose: The definition of a parallel sampler of random
+ *          spanning trees that estimates the current through
+ *          each edge on boards too large to solve exactly.
+ * ===========================================================
+ */
+
+#ifndef TREE_SAMPLER_H
+#define TREE_SAMPLER_H
+
+#include <windows.h>
+#include "Graph.h"
+#include "gameLogic.h"
+#include "threadPool.h"
+
+// The number of trees the AI samples for each move, and the most time
+// it spends on them, in milliseconds
+#define SAMPLER_TREES        128
+#define SAMPLER_TIME_LIMIT   1000
+
+// A random walk checks the clock after this many steps
+#define SAMPLER_CLOCK_STEPS  4096
+
+// The board as a resistor network, as in resistance.h: the vertices
+// joined by locked edges are merged into one node, and every normal
+// edge between two nodes is a 1 ohm resistor. By Kirchhoff's theorem,
+// when 1 amp flows from the start to the end, the current through an
+// edge is how much more often the path from the start to the end in a
+// uniformly random spanning tree crosses the edge one way than the
+// other. Wilson's algorithm rooted at the end draws that path as a
+// loop-erased random walk from the start, so only the walk is needed.
+typedef struct treeSampler {
+    int capacity;              // The number of vertices the buffers hold
+    int arcCapacity;           // The number of arcs the buffers hold
+    int * group;               // Union-find of the vertices joined by
+                               //   locked edges
+    int * node;                // The node of each vertex, or -1 if it is
+                               //   not connected to the terminals
+    int * queue;
+
+    // The merged board; the arcs inside a node are left out
+    int numberNodes;
+    int source;                // The nodes of the terminals
+    int sink;
+    int * offsets;             // The arcs of node a are
+    int * targets;             //   targets[offsets[a]..offsets[a+1]-1],
+    int * arcs;                //   and arcs[] is their index in the board
+
+    // The board of the last run, to look up the edges
+    int numberVertices;
+    int * boardOffsets;
+    int * boardNeighbors;
+
+    // The results of the last run
+    int * crossings;           // The times each arc of the board was
+                               //   crossed by the sampled paths
+    int trees;                 // The number of paths sampled
+    long long steps;           // The random walk steps they took
+    unsigned long long seed;   // Makes each run different
+} TreeSampler;
+
+/** -------------------------------------------------------------------
+ * Create a tree sampler.
+ * @param numberVertices the most vertices a board can have
+ * @param numberArcs the most arcs (twice the edges) a board can have
+ * @return a pointer to a tree sampler struct
+ */
+TreeSampler * samplerCreate(int numberVertices, int numberArcs);
+
+/** -------------------------------------------------------------------
+ * Delete a tree sampler
+ * @param sampler the sampler to delete
+ */
+void samplerDelete(TreeSampler *sampler);
+
+/** -------------------------------------------------------------------
+ * Sample the paths between the terminals (vertex 0 and vertex
+ * numberVertices-1) of random spanning trees. The trees are shared out
+ * among the workers of the pool. Each tree has its own random numbers
+ * and the counts are added up at the end, so the result does not depend
+ * on the number of threads unless the time runs out.
+ * @param sampler the sampler; it must be big enough for the board
+ * @param board the normal and locked edges
+ * @param locked the locked edges
+ * @param pool the threads that take the samples
+ * @param numberTrees the number of trees; more is slower but more exact
+ * @param milliseconds the most time to spend; the trees that are not
+ *                     finished in time are left out
+ * @return TRUE if the game is underway. Return FALSE if the terminals
+ *         are not connected, or are already joined by locked edges.
+ */
+int samplerRun(TreeSampler *sampler, Adjacency *board, Adjacency *locked, ThreadPool *pool,
+               int numberTrees, int milliseconds);
+
+/** -------------------------------------------------------------------
+ * Estimate the current through an edge when 1 amp flows from the start
+ * to the end. samplerRun() must be called first.
+ * @param sampler the sampler
+ * @param fromVertex one end of the edge
+ * @param toVertex the other end of the edge
+ * @return the current, in amps; 0 if no tree was sampled
+ */
+double samplerCurrent(TreeSampler *sampler, int fromVertex, int toVertex);
+
+#endif // TREE_SAMPLER_H